@@ -0,0 +1,272 @@
+#ifndef rb_testing_h
+#define rb_testing_h
+
+/* Run the set operations in threads, even for small trees. */
+#define RB_PTHREAD
+#define RB_PAR_BH 2
+/* Test the integer search of frozen snapshots. */
+#define RB_FROZEN_SIMD
+#include "rbtree.h"
+#include "qs.h"
+#include "slab.h"
+#include "btree.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define TA(condition, ...) \
+{ \
+    if(!(condition)) { \
+        fprintf( \
+            stderr, \
+            "%s:%d ", \
+            __FILE__, \
+            __LINE__ \
+        ); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+        return 1; \
+    } \
+} \
+
+
+#define BA(condition, ...) \
+{ \
+    if(!(condition)) { \
+        fprintf( \
+            stderr, \
+            "%s:%d ", \
+            __FILE__, \
+            __LINE__ \
+        ); \
+        fprintf(stderr, __VA_ARGS__); \
+        fprintf(stderr, "\n"); \
+        ret = 1; \
+        break; \
+    } \
+} \
+
+
+#define T(test) \
+{ \
+    int __testing_tmp_ret_ = test; \
+    if(__testing_tmp_ret_ != 0) { \
+        return __testing_tmp_ret_; \
+    } \
+} \
+
+
+struct node_s;
+typedef struct node_s node_t;
+struct node_s {
+    int     value;
+    char    color;
+    node_t* parent;
+    node_t* left;
+    node_t* right;
+};
+
+
+#define my_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
+rb_bind_decl_m(my, node_t)
+rb_head_bind_decl_m(mh, my, node_t)
+rb_slab_bind_decl_m(my, node_t)
+#define my_key_m(x) rb_value_m(x)
+#define my_key_cmp_m(x, y) rb_safe_cmp_m(x, y)
+rb_key_bind_decl_m(my, node_t, int)
+rb_frozen_bind_decl_m(my, node_t, int)
+rb_ts_bind_decl_m(my, node_t)
+rb_seq_bind_decl_m(my, node_t)
+
+#define mm_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
+rb_multi_bind_decl_m(mm, node_t)
+
+#define mt_key_m(x) rb_value_m(x)
+#define mt_key_cmp_m(x, y) rb_safe_cmp_m(x, y)
+bt_bind_decl_m(mt, node_t, int)
+
+struct cpnode_s;
+typedef struct cpnode_s cpnode_t;
+struct cpnode_s {
+    int       value;
+    char      color;
+    cpnode_t* left;
+    cpnode_t* right;
+};
+
+#define mc_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
+rb_compact_bind_decl_m(mc, cpnode_t)
+
+struct chnode_s;
+typedef struct chnode_s chnode_t;
+struct chnode_s {
+    int       value;
+    char      color;
+    chnode_t* parent;
+    chnode_t* child[2];
+};
+
+#define mb_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
+rb_child_bind_decl_m(mb, chnode_t)
+
+struct osnode_s;
+typedef struct osnode_s osnode_t;
+struct osnode_s {
+    int       value;
+    char      color;
+    osnode_t* parent;
+    osnode_t* left;
+    osnode_t* right;
+    RB_SIZE_T size;
+};
+
+#define mo_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
+rb_os_bind_decl_m(mo, osnode_t)
+
+struct augnode_s;
+typedef struct augnode_s augnode_t;
+struct augnode_s {
+    int        value;
+    char       color;
+    augnode_t* parent;
+    augnode_t* left;
+    augnode_t* right;
+    int        weight;
+    int        max;
+};
+
+#define ma_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
+#define ma_augment_m(x) \
+{ \
+    (x)->max = (x)->weight; \
+    if(rb_left_m(x) != ma_nil_ptr && rb_left_m(x)->max > (x)->max) \
+        (x)->max = rb_left_m(x)->max; \
+    if(rb_right_m(x) != ma_nil_ptr && rb_right_m(x)->max > (x)->max) \
+        (x)->max = rb_right_m(x)->max; \
+} \
+
+rb_aug_bind_decl_m(ma, augnode_t)
+
+struct ivnode_s;
+typedef struct ivnode_s ivnode_t;
+struct ivnode_s {
+    int       start;
+    int       end;
+    char      color;
+    ivnode_t* parent;
+    ivnode_t* left;
+    ivnode_t* right;
+    int       max;
+};
+
+#define mi_cmp_m(x, y) \
+    ( \
+        rb_start_m(x) != rb_start_m(y) ? \
+        rb_safe_cmp_m(rb_start_m(x), rb_start_m(y)) : \
+        rb_safe_cmp_m(rb_end_m(x), rb_end_m(y)) \
+    ) \
+
+rb_interval_bind_decl_m(mi, ivnode_t)
+
+struct pknode_s;
+typedef struct pknode_s pknode_t;
+struct pknode_s {
+    int       value;
+    uintptr_t parent;
+    pknode_t* left;
+    pknode_t* right;
+};
+
+#define mp_color_m(x) rb_tag_color_m((x)->parent)
+#define mp_color_m_set(x, c) rb_tag_set_color_m((x)->parent, c)
+#define mp_parent_m(x) rb_tag_ptr_m(pknode_t, (x)->parent)
+#define mp_parent_m_set(x, p) rb_tag_set_ptr_m((x)->parent, p)
+#define mp_left_m(x) (x)->left
+#define mp_left_m_set(x, l) rb_lvalue_set_m(mp_left_m, x, l)
+#define mp_right_m(x) (x)->right
+#define mp_right_m_set(x, r) rb_lvalue_set_m(mp_right_m, x, r)
+#define mp_cmp_m(x, y) rb_safe_cmp_m((x)->value, (y)->value)
+rb_tagged_bind_decl_cx_m(mp, pknode_t)
+
+struct ixnode_s;
+typedef struct ixnode_s ixnode_t;
+struct ixnode_s {
+    int      value;
+    uint32_t parent;
+    uint32_t left;
+    uint32_t right;
+};
+
+#define mq_color_m(x) rb_pool_tag_color_m((x)->parent)
+#define mq_color_m_set(x, c) rb_pool_tag_set_color_m((x)->parent, c)
+#define mq_parent_m(x) rb_pool_tag_ptr_m(mq, (x)->parent)
+#define mq_parent_m_set(x, p) rb_pool_tag_set_ptr_m(mq, (x)->parent, p)
+#define mq_left_m(x) rb_pool_ptr_m(mq, (x)->left)
+#define mq_left_m_set(x, l) (x)->left = rb_pool_idx_m(mq, l)
+#define mq_right_m(x) rb_pool_ptr_m(mq, (x)->right)
+#define mq_right_m_set(x, r) (x)->right = rb_pool_idx_m(mq, r)
+#define mq_cmp_m(x, y) rb_safe_cmp_m((x)->value, (y)->value)
+rb_pool_bind_decl_cx_m(mq, ixnode_t)
+
+struct item_s;
+typedef struct item_s item_t;
+struct item_s {
+    int     value;
+    item_t* next;
+};
+
+qs_queue_bind_decl_m(qq, item_t)
+
+static
+void
+print_tree(int n, node_t* l, node_t* r) {
+    int pv = -91;
+    int lv = -91;
+    int rv = -91;
+    char* pc = "";
+    char* lc = "";
+    char* rc = "";
+    n += 1;
+    node_t* p = my_nil_ptr;
+    if(l != my_nil_ptr) {
+        lc = rb_is_black_m(rb_color_m(l)) ? "black" : "red";
+        lv = rb_value_m(l);
+        p = rb_parent_m(l);
+    }
+    if(r != my_nil_ptr) {
+        rc = rb_is_black_m(rb_color_m(r)) ? "black" : "red";
+        rv = rb_value_m(r);
+        p = rb_parent_m(r);
+    }
+    if(p != my_nil_ptr) {
+        pc = rb_is_black_m(rb_color_m(p)) ? "black" : "red";
+        pv = rb_value_m(p);
+    }
+    printf(
+        "level: %3d parent: %d (%s) left: %d (%s) right: %d (%s)\n",
+        n,
+        pv,
+        pc,
+        lv,
+        lc,
+        rv,
+        rc
+    );
+    if(l != my_nil_ptr)
+        print_tree(n, rb_left_m(l), rb_right_m(l));
+    if(r != my_nil_ptr)
+        print_tree(n, rb_left_m(r), rb_right_m(r));
+}
+
+static
+void
+recursive_sum(int* sum, int* elems, node_t* node)
+{
+    if(node == my_nil_ptr)
+        return;
+    *sum += rb_value_m(node);
+    *elems += 1;
+    recursive_sum(sum, elems, rb_left_m(node));
+    recursive_sum(sum, elems, rb_right_m(node));
+}
+#endif // rb_testing_h
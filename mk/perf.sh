@@ -1,12 +1,13 @@
 #!/bin/sh
 
 TYPE="$1"
+CPUS="${2:-0}"
 
 cd "$BUILD"
-taskset -c 0 "./$TYPE" > log1
-taskset -c 0 "./$TYPE" > log2
-taskset -c 0 "./$TYPE" > log3
-taskset -c 0 "./$TYPE" > log4
-taskset -c 0 "./$TYPE" > log5
+taskset -c "$CPUS" "./$TYPE" > log1
+taskset -c "$CPUS" "./$TYPE" > log2
+taskset -c "$CPUS" "./$TYPE" > log3
+taskset -c "$CPUS" "./$TYPE" > log4
+taskset -c "$CPUS" "./$TYPE" > log5
 "$BASE/mk/avg" log1 log2 log3 log4 log5 > log
 gnuplot -c "$BASE/mk/$TYPE" > "$BASE/$TYPE".png
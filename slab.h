@@ -0,0 +1,335 @@
+// ====
+// Slab
+// ====
+//
+// Node allocator companion for rbtree.h. Nodes are carved out of large,
+// cache-line aligned slabs, so the nodes of a tree are close to each other.
+// Freed nodes go to a free list and are reused first. Since the nodes of a
+// tree usually come from one slab allocator, the whole tree can be dropped in
+// O(1) with cx##_reset, without walking it.
+//
+// Installation
+// ============
+//
+// Copy slab.h into your source.
+//
+// Development
+// ===========
+//
+// See `README.rst`_
+//
+// .. _`README.rst`: https://github.com/ganwell/rbtree
+//
+// Usage
+// =====
+//
+// .. code-block:: cpp
+//
+//    rb_bind_m(my, node_t)
+//    rb_slab_bind_m(my, node_t)
+//
+//    my_slab_t slab;
+//    node_t* tree;
+//    node_t* node;
+//    my_slab_init(&slab, 0);
+//    my_tree_init(&tree);
+//    node = my_alloc(&slab);
+//    my_node_init(node);
+//    my_insert(&tree, node);
+//    ...
+//    my_delete_node(&tree, node);
+//    my_free(&slab, node);
+//    ...
+//    /* Drop all nodes at once */
+//    my_tree_init(&tree);
+//    my_reset(&slab);
+//    ...
+//    my_slab_destroy(&slab);
+//
+// API
+// ===
+//
+// rb_slab_bind_decl_m(context, type) alias rb_slab_bind_decl_cx_m
+//    Bind the slab function declarations for *type* to *context*. Usually
+//    used in a header. The context can be the same as the one of the tree.
+//
+// rb_slab_bind_impl_m(context, type) alias rb_slab_bind_impl_cx_m
+//    Bind the slab function implementations for *type* to *context*. Usually
+//    used in a c-file.
+//
+// Then the following functions will be available.
+//
+// cx##_slab_init(cx##_slab_t* slab, int flags)
+//    Initialize an empty slab allocator, no memory is allocated yet. Flags can
+//    be RB_SLAB_HUGEPAGE.
+//
+// cx##_alloc(cx##_slab_t* slab)
+//    Allocate a node. The node is not initialized. Returns NULL if the system
+//    is out of memory. O(1).
+//
+// cx##_free(cx##_slab_t* slab, type* node)
+//    Return the node to the free list of *slab*. O(1).
+//
+// cx##_reset(cx##_slab_t* slab)
+//    Free all nodes of *slab*. The slabs are kept and reused. O(1).
+//
+// cx##_slab_destroy(cx##_slab_t* slab)
+//    Return all slabs to the system.
+//
+// Definitions
+// ===========
+//
+// RB_SLAB_ALIGN is the alignment of the slabs and of the first node in a
+// slab, usually the size of a cache line.
+//
+// RB_SLAB_SIZE is the size of a slab in bytes. It is the size of a huge page
+// on x86_64, so a slab can be backed by one huge page.
+//
+// If RB_SLAB_HUGEPAGE is passed to cx##_slab_init, the slabs are aligned to
+// RB_SLAB_SIZE and we ask the kernel to back them by huge pages using
+// madvise. On systems without MADV_HUGEPAGE the flag only aligns the slabs.
+//
+// .. code-block:: cpp
+//
+#ifndef rb_slab_h
+#define rb_slab_h
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#ifdef __linux__
+#   include <sys/mman.h>
+#endif
+#ifndef RB_SLAB_ALIGN
+#   define RB_SLAB_ALIGN 64
+#endif
+#ifndef RB_SLAB_SIZE
+#   define RB_SLAB_SIZE (2 * 1024 * 1024)
+#endif
+#define RB_SLAB_HUGEPAGE 1
+
+// Implementation
+// ==============
+//
+// Every slab starts with a header, that links it to the next slab. The nodes
+// follow at the next multiple of RB_SLAB_ALIGN. New nodes are bumped from
+// *cur* to *end*, freed nodes are linked through their first bytes. A reset
+// only rewinds the bump pointer to the first slab and clears the free list.
+//
+// .. code-block:: text
+//
+//    slabs --> .------.------.------.------.     .------.------.
+//              | next | node | node | node | --> | next | node | ...
+//              '------'------'------'------'     '------'------'
+//                                   ^cur  ^end
+//
+// .. code-block:: cpp
+//
+typedef struct rb_slab_s rb_slab_t;
+struct rb_slab_s {
+    rb_slab_t* next;
+};
+
+/* The header is smaller than RB_SLAB_ALIGN. */
+#define RB_SLAB_HEAD RB_SLAB_ALIGN
+
+// rb_slab_new
+// -----------
+//
+// Allocate a slab and advise huge pages if requested. Returns NULL if the
+// system is out of memory.
+//
+// .. code-block:: cpp
+//
+static inline
+rb_slab_t*
+rb_slab_new(int flags)
+{
+    void* mem;
+    size_t align = RB_SLAB_ALIGN;
+    if(flags & RB_SLAB_HUGEPAGE)
+        align = RB_SLAB_SIZE;
+    if(posix_memalign(&mem, align, RB_SLAB_SIZE) != 0)
+        return NULL;
+#ifdef MADV_HUGEPAGE
+    if(flags & RB_SLAB_HUGEPAGE)
+        madvise(mem, RB_SLAB_SIZE, MADV_HUGEPAGE);
+#endif
+    ((rb_slab_t*) mem)->next = NULL;
+    return mem;
+}
+
+// rb_slab_bind_decl_m
+// -------------------
+//
+// Alias: rb_slab_bind_decl_cx_m
+//
+// Bind slab functions to a context. This only generates declarations.
+//
+// cx
+//    Name of the context.
+//
+// type
+//    The type of the nodes, it has to be at least as big as a pointer.
+//
+// .. code-block:: cpp
+//
+#define rb_slab_bind_decl_m(cx, type) \
+    typedef struct { \
+        rb_slab_t* slabs; \
+        rb_slab_t* slab; \
+        char*      cur; \
+        char*      end; \
+        type*      free; \
+        int        flags; \
+    } cx##_slab_t; \
+    void \
+    cx##_slab_init( \
+            cx##_slab_t* slab, \
+            int flags \
+    ); \
+    type* \
+    cx##_alloc( \
+            cx##_slab_t* slab \
+    ); \
+    void \
+    cx##_free( \
+            cx##_slab_t* slab, \
+            type* node \
+    ); \
+    void \
+    cx##_reset( \
+            cx##_slab_t* slab \
+    ); \
+    void \
+    cx##_slab_destroy( \
+            cx##_slab_t* slab \
+    ); \
+
+
+#define rb_slab_bind_decl_cx_m(cx, type) rb_slab_bind_decl_m(cx, type)
+
+// rb_slab_bind_impl_m
+// -------------------
+//
+// Alias: rb_slab_bind_impl_cx_m
+//
+// Bind slab functions to a context. This only generates implementations.
+//
+// cx
+//    Name of the context.
+//
+// type
+//    The type of the nodes, it has to be at least as big as a pointer.
+//
+// .. code-block:: cpp
+//
+#define rb_slab_bind_impl_m(cx, type) \
+    void \
+    cx##_slab_init( \
+            cx##_slab_t* slab, \
+            int flags \
+    ) \
+    { \
+        slab->slabs = NULL; \
+        slab->slab = NULL; \
+        slab->cur = NULL; \
+        slab->end = NULL; \
+        slab->free = NULL; \
+        slab->flags = flags; \
+    } \
+    static \
+    int \
+    cx##_slab_next( \
+            cx##_slab_t* slab \
+    ) \
+    { \
+        rb_slab_t* next; \
+        if(slab->slab != NULL && slab->slab->next != NULL) \
+            next = slab->slab->next; \
+        else { \
+            next = rb_slab_new(slab->flags); \
+            if(next == NULL) \
+                return 1; \
+            if(slab->slab == NULL) \
+                slab->slabs = next; \
+            else \
+                slab->slab->next = next; \
+        } \
+        slab->slab = next; \
+        slab->cur = ((char*) next) + RB_SLAB_HEAD; \
+        slab->end = ((char*) next) + RB_SLAB_SIZE; \
+        return 0; \
+    } \
+    type* \
+    cx##_alloc( \
+            cx##_slab_t* slab \
+    ) \
+    { \
+        type* node = slab->free; \
+        if(node != NULL) { \
+            memcpy(&slab->free, node, sizeof(type*)); \
+            return node; \
+        } \
+        assert(sizeof(type) <= RB_SLAB_SIZE - RB_SLAB_HEAD && "Node too big"); \
+        if( \
+                slab->cur == NULL || \
+                (size_t) (slab->end - slab->cur) < sizeof(type) \
+        ) { \
+            if(cx##_slab_next(slab) != 0) \
+                return NULL; \
+        } \
+        node = (type*) slab->cur; \
+        slab->cur += sizeof(type); \
+        return node; \
+    } \
+    void \
+    cx##_free( \
+            cx##_slab_t* slab, \
+            type* node \
+    ) \
+    { \
+        assert(sizeof(type) >= sizeof(type*) && "Node is too small"); \
+        memcpy(node, &slab->free, sizeof(type*)); \
+        slab->free = node; \
+    } \
+    void \
+    cx##_reset( \
+            cx##_slab_t* slab \
+    ) \
+    { \
+        /* cx##_alloc starts again with the first slab. */ \
+        slab->slab = NULL; \
+        slab->cur = NULL; \
+        slab->end = NULL; \
+        slab->free = NULL; \
+        if(slab->slabs != NULL) { \
+            slab->slab = slab->slabs; \
+            slab->cur = ((char*) slab->slabs) + RB_SLAB_HEAD; \
+            slab->end = ((char*) slab->slabs) + RB_SLAB_SIZE; \
+        } \
+    } \
+    void \
+    cx##_slab_destroy( \
+            cx##_slab_t* slab \
+    ) \
+    { \
+        rb_slab_t* next; \
+        while(slab->slabs != NULL) { \
+            next = slab->slabs->next; \
+            free(slab->slabs); \
+            slab->slabs = next; \
+        } \
+        cx##_slab_init(slab, slab->flags); \
+    } \
+
+
+#define rb_slab_bind_impl_cx_m(cx, type) rb_slab_bind_impl_m(cx, type)
+
+#define rb_slab_bind_m(cx, type) \
+    rb_slab_bind_decl_m(cx, type) \
+    rb_slab_bind_impl_m(cx, type) \
+
+
+#define rb_slab_bind_cx_m(cx, type) rb_slab_bind_m(cx, type)
+
+#endif
@@ -0,0 +1,892 @@
+// ======
+// B-Tree
+// ======
+//
+// Cache-conscious B+ tree companion for rbtree.h. A red-black tree has one
+// key per node, so a lookup misses the cache on almost every level. The
+// B-tree keeps many keys in one node of BT_NODE_SIZE bytes and a lookup only
+// touches O(log_B(N)) nodes. The elements are not changed, the tree stores
+// pointers to them and copies their keys.
+//
+// The functions have the same names and semantics as the ones of rbtree.h,
+// so an engine can be picked per workload. The tree is a pointer to the root
+// node instead of a pointer to an element, empty trees are NULL.
+//
+// Installation
+// ============
+//
+// Copy btree.h into your source. Include rbtree.h as well, if you want to use
+// rb_for_m.
+//
+// Development
+// ===========
+//
+// See `README.rst`_
+//
+// .. _`README.rst`: https://github.com/ganwell/rbtree
+//
+// Usage
+// =====
+//
+// .. code-block:: cpp
+//
+//    #define my_key_m(x) (x)->value
+//    #define my_key_cmp_m(x, y) rb_safe_cmp_m(x, y)
+//    bt_bind_m(my, node_t, int)
+//
+//    my_btree_t* tree;
+//    node_t* node;
+//    my_tree_init(&tree);
+//    my_insert(&tree, &mynode);
+//    my_find(tree, &mykey, &node);
+//    bt_iter_decl_m(my, iter, elem);
+//    rb_for_m(my, tree, iter, elem) {
+//        printf("%d\n", elem->value);
+//    }
+//    my_delete(&tree, &mykey);
+//    my_clear(&tree, NULL, NULL);
+//
+// API
+// ===
+//
+// bt_bind_decl_m(context, type, ktype) alias bt_bind_decl_cx_m
+//    Bind the B-tree function declarations for *type* to *context*. Usually
+//    used in a header.
+//
+// bt_bind_impl_m(context, type, ktype) alias bt_bind_impl_cx_m
+//    Bind the B-tree function implementations for *type* to *context*.
+//    Usually used in a c-file. Expects you to create cx##_key_m, which
+//    returns the key of type *ktype* of an element, and cx##_key_cmp_m, which
+//    compares two keys. The same traits are used by rb_key_bind_m.
+//
+// bt_iter_decl_m(context, iter, elem)
+//    Declares the variables *iter* and *elem* for the context *cx*. Use it
+//    instead of rb_iter_decl_m, the iterator is a struct.
+//
+// Then the following functions will be available.
+//
+// cx##_tree_init(cx##_btree_t** tree)
+//    Initialize *tree* by assigning NULL to it.
+//
+// cx##_insert(cx##_btree_t** tree, type* node)
+//    Insert *node* into *tree*. If a node with the same key exists the
+//    function returns 1 and *node* is not inserted. If the system is out of
+//    memory it returns 2 and *node* is not inserted, 0 on success.
+//
+// cx##_delete(cx##_btree_t** tree, type* key)
+//    Delete the node matching *key* from *tree*. If *key* is not in the tree
+//    the function returns 1, 0 on success.
+//
+// cx##_delete_node(cx##_btree_t** tree, type* node)
+//    Delete the known *node* from *tree*.
+//
+// cx##_find(cx##_btree_t* tree, type* key, type** node)
+//    Find the node matching *key* and assign it to *node*. If *key* is not in
+//    the tree *node* will not be assigned and the function returns 1, 0 on
+//    success.
+//
+// cx##_find_key(cx##_btree_t* tree, ktype key, type** node)
+//    Same as cx##_find, but with a bare key.
+//
+// cx##_lower_bound(cx##_btree_t* tree, type* key, type** node)
+//    Find the least node that is not less than *key* and assign it to *node*.
+//    If there is no such node *node* will be set to NULL and the function
+//    returns 1, 0 on success.
+//
+// cx##_iter_init(cx##_btree_t* tree, cx##_iter_t** iter, type** elem)
+//    Initializes *elem* to point to the first element in tree. If the tree is
+//    empty *elem* will be NULL.
+//
+// cx##_iter_next(cx##_iter_t* iter, type** elem)
+//    Move *elem* to the next element in the tree. *elem* will point to NULL
+//    at the end. The tree must not be modified during the iteration.
+//
+// cx##_clear(cx##_btree_t** tree, void (*callback)(type*, void*), void* ctx)
+//    Free all B-tree nodes and pass every element to *callback* with *ctx*.
+//    *callback* may be NULL. O(N).
+//
+// cx##_size(cx##_btree_t* tree)
+//    Returns the size of tree. O(N/B).
+//
+// cx##_check_tree(cx##_btree_t* tree)
+//    Check the invariants of the tree using assert.
+//
+// You can use rb_for_m from rbtree.h with btree.
+//
+// Definitions
+// ===========
+//
+// BT_NODE_SIZE is the size of a B-tree node in bytes. The default of four
+// cache lines holds 20 int keys. For trees that live on pages, you can set it
+// to the page size before including btree.h. It has to hold at least four
+// keys.
+//
+// BT_NODE_ALIGN is the alignment of the nodes, usually the size of a cache
+// line.
+//
+// .. code-block:: cpp
+//
+#ifndef bt_btree_h
+#define bt_btree_h
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#ifndef BT_NODE_SIZE
+#   define BT_NODE_SIZE 256
+#endif
+#ifndef BT_NODE_ALIGN
+#   define BT_NODE_ALIGN 64
+#endif
+
+// Implementation
+// ==============
+//
+// All elements are in the leaves, the leaves are linked for the iterator.
+// Inner nodes only contain separators: all keys in child i are less than key
+// i and all keys in child i + 1 are not less than key i. A separator may
+// stay behind after its element was deleted.
+//
+// Nodes are split on the way down when inserting and filled up on the way
+// down when deleting, so no node is visited twice. A node, except the root,
+// has between BT_MIN and BT_CAP keys.
+//
+// .. code-block:: text
+//
+//                   .-----.-----.
+//                   | 10  | 30  |
+//                   '-----'-----'
+//             .-------'   |   '-------.
+//    .---.---.    .----.----.    .----.----.
+//    | 1 | 5 | -> | 10 | 20 | -> | 30 | 40 | -> NULL
+//    '---'---'    '----'----'    '----'----'
+//
+// The layout of a node is the same for leaves and inner nodes. A leaf stores
+// the elements in ptrs[0, n) and the next leaf in ptrs[BT_CAP]. An inner node
+// stores the children in ptrs[0, n].
+//
+// .. code-block:: cpp
+//
+#begindef BT_CAP(ktype)
+(
+    (BT_NODE_SIZE - 2 * sizeof(int) - sizeof(void*)) /
+    (sizeof(ktype) + sizeof(void*))
+)
+#enddef
+
+#define BT_MIN(ktype) ((BT_CAP(ktype) - 1) / 2)
+
+// bt_bind_decl_m
+// --------------
+//
+// Alias: bt_bind_decl_cx_m
+//
+// Bind B-tree functions to a context. This only generates declarations.
+//
+// cx
+//    Name of the context.
+//
+// type
+//    The type of the elements.
+//
+// ktype
+//    The type of the keys, they are copied into the nodes.
+//
+// .. code-block:: cpp
+//
+#begindef bt_bind_decl_m(cx, type, ktype)
+    typedef type cx##_type_t;
+    typedef struct cx##_btree_s cx##_btree_t;
+    struct cx##_btree_s {
+        int     n;
+        int     leaf;
+        ktype   keys[BT_CAP(ktype)];
+        void*   ptrs[BT_CAP(ktype) + 1];
+    };
+    typedef struct {
+        cx##_btree_t* leaf;
+        int           i;
+    } cx##_iter_t;
+    void
+    cx##_tree_init(
+            cx##_btree_t** tree
+    );
+    int
+    cx##_insert(
+            cx##_btree_t** tree,
+            type* node
+    );
+    int
+    cx##_delete(
+            cx##_btree_t** tree,
+            type* key
+    );
+    void
+    cx##_delete_node(
+            cx##_btree_t** tree,
+            type* node
+    );
+    int
+    cx##_find(
+            cx##_btree_t* tree,
+            type* key,
+            type** node
+    );
+    int
+    cx##_find_key(
+            cx##_btree_t* tree,
+            ktype key,
+            type** node
+    );
+    int
+    cx##_lower_bound(
+            cx##_btree_t* tree,
+            type* key,
+            type** node
+    );
+    void
+    cx##_iter_init(
+            cx##_btree_t* tree,
+            cx##_iter_t** iter,
+            type** elem
+    );
+    void
+    cx##_iter_next(
+            cx##_iter_t* iter,
+            type** elem
+    );
+    void
+    cx##_clear(
+            cx##_btree_t** tree,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    );
+    size_t
+    cx##_size(
+            cx##_btree_t* tree
+    );
+    void
+    cx##_check_tree(
+            cx##_btree_t* tree
+    );
+#enddef
+
+#define bt_bind_decl_cx_m(cx, type, ktype) bt_bind_decl_m(cx, type, ktype)
+
+// bt_iter_decl_m
+// --------------
+//
+// Declare iterator variables. *iter* points to a cursor on the stack, so
+// rb_for_m can pass it to cx##_iter_init and cx##_iter_next.
+//
+// .. code-block:: cpp
+//
+#begindef bt_iter_decl_m(cx, iter, elem)
+    cx##_iter_t __bt_##iter##_mem_;
+    cx##_iter_t* iter = &__bt_##iter##_mem_;
+    cx##_type_t* elem = NULL;
+#enddef
+
+// bt_bind_impl_m
+// --------------
+//
+// Alias: bt_bind_impl_cx_m
+//
+// Bind B-tree functions to a context. This only generates implementations.
+//
+// cx
+//    Name of the context.
+//
+// type
+//    The type of the elements.
+//
+// ktype
+//    The type of the keys, they are copied into the nodes.
+//
+// .. code-block:: cpp
+//
+#begindef bt_bind_impl_m(cx, type, ktype)
+    void
+    cx##_tree_init(
+            cx##_btree_t** tree
+    )
+    {
+        *tree = NULL;
+    }
+    static
+    cx##_btree_t*
+    cx##_bt_new(
+            int leaf
+    )
+    {
+        void* mem;
+        cx##_btree_t* node;
+        assert(BT_MIN(ktype) > 0 && "BT_NODE_SIZE too small");
+        if(posix_memalign(&mem, BT_NODE_ALIGN, sizeof(cx##_btree_t)) != 0)
+            return NULL;
+        node = mem;
+        node->n = 0;
+        node->leaf = leaf;
+        node->ptrs[BT_CAP(ktype)] = NULL;
+        return node;
+    }
+    /* First index with a key not less than key */
+    static
+    int
+    cx##_bt_lower(
+            cx##_btree_t* node,
+            ktype key
+    )
+    {
+        int lo = 0;
+        int hi = node->n;
+        int mid;
+        while(lo < hi) {
+            mid = (lo + hi) / 2;
+            if(cx##_key_cmp_m((node->keys[mid]), (key)) < 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+    /* First index with a key greater than key, the child to descend */
+    static
+    int
+    cx##_bt_upper(
+            cx##_btree_t* node,
+            ktype key
+    )
+    {
+        int lo = 0;
+        int hi = node->n;
+        int mid;
+        while(lo < hi) {
+            mid = (lo + hi) / 2;
+            if(cx##_key_cmp_m((node->keys[mid]), (key)) <= 0)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        return lo;
+    }
+    static
+    cx##_btree_t*
+    cx##_bt_leaf(
+            cx##_btree_t* tree,
+            ktype key
+    )
+    {
+        while(!tree->leaf)
+            tree = tree->ptrs[cx##_bt_upper(tree, key)];
+        return tree;
+    }
+    /* Split the full child i of parent, parent is not full. */
+    static
+    int
+    cx##_bt_split(
+            cx##_btree_t* parent,
+            int i
+    )
+    {
+        cx##_btree_t* child = parent->ptrs[i];
+        cx##_btree_t* right = cx##_bt_new(child->leaf);
+        ktype sep;
+        int m = child->n / 2;
+        if(right == NULL)
+            return 1;
+        if(child->leaf) {
+            right->n = child->n - m;
+            memcpy(right->keys, child->keys + m, right->n * sizeof(ktype));
+            memcpy(right->ptrs, child->ptrs + m, right->n * sizeof(void*));
+            right->ptrs[BT_CAP(ktype)] = child->ptrs[BT_CAP(ktype)];
+            child->ptrs[BT_CAP(ktype)] = right;
+            sep = right->keys[0];
+        } else {
+            sep = child->keys[m];
+            right->n = child->n - m - 1;
+            memcpy(
+                right->keys,
+                child->keys + m + 1,
+                right->n * sizeof(ktype)
+            );
+            memcpy(
+                right->ptrs,
+                child->ptrs + m + 1,
+                (right->n + 1) * sizeof(void*)
+            );
+        }
+        child->n = m;
+        memmove(
+            parent->keys + i + 1,
+            parent->keys + i,
+            (parent->n - i) * sizeof(ktype)
+        );
+        memmove(
+            parent->ptrs + i + 2,
+            parent->ptrs + i + 1,
+            (parent->n - i) * sizeof(void*)
+        );
+        parent->keys[i] = sep;
+        parent->ptrs[i + 1] = right;
+        parent->n += 1;
+        return 0;
+    }
+    int
+    cx##_insert(
+            cx##_btree_t** tree,
+            type* node
+    )
+    {
+        cx##_btree_t* cur = *tree;
+        cx##_btree_t* root;
+        ktype key = cx##_key_m(node);
+        int i;
+        if(cur == NULL) {
+            cur = cx##_bt_new(1);
+            if(cur == NULL)
+                return 2;
+            *tree = cur;
+        }
+        if(cur->n == (int) BT_CAP(ktype)) {
+            root = cx##_bt_new(0);
+            if(root == NULL)
+                return 2;
+            root->ptrs[0] = cur;
+            if(cx##_bt_split(root, 0) != 0) {
+                free(root);
+                return 2;
+            }
+            *tree = root;
+            cur = root;
+        }
+        while(!cur->leaf) {
+            i = cx##_bt_upper(cur, key);
+            if(((cx##_btree_t*) cur->ptrs[i])->n == (int) BT_CAP(ktype)) {
+                if(cx##_bt_split(cur, i) != 0)
+                    return 2;
+                if(cx##_key_cmp_m((cur->keys[i]), (key)) <= 0)
+                    i += 1;
+            }
+            cur = cur->ptrs[i];
+        }
+        i = cx##_bt_lower(cur, key);
+        if(i < cur->n && cx##_key_cmp_m((cur->keys[i]), (key)) == 0)
+            return 1;
+        memmove(
+            cur->keys + i + 1,
+            cur->keys + i,
+            (cur->n - i) * sizeof(ktype)
+        );
+        memmove(
+            cur->ptrs + i + 1,
+            cur->ptrs + i,
+            (cur->n - i) * sizeof(void*)
+        );
+        cur->keys[i] = key;
+        cur->ptrs[i] = node;
+        cur->n += 1;
+        return 0;
+    }
+    /* Merge child i + 1 of parent into child i. */
+    static
+    void
+    cx##_bt_merge(
+            cx##_btree_t* parent,
+            int i
+    )
+    {
+        cx##_btree_t* left = parent->ptrs[i];
+        cx##_btree_t* right = parent->ptrs[i + 1];
+        if(left->leaf) {
+            memcpy(
+                left->keys + left->n,
+                right->keys,
+                right->n * sizeof(ktype)
+            );
+            memcpy(
+                left->ptrs + left->n,
+                right->ptrs,
+                right->n * sizeof(void*)
+            );
+            left->n += right->n;
+            left->ptrs[BT_CAP(ktype)] = right->ptrs[BT_CAP(ktype)];
+        } else {
+            left->keys[left->n] = parent->keys[i];
+            memcpy(
+                left->keys + left->n + 1,
+                right->keys,
+                right->n * sizeof(ktype)
+            );
+            memcpy(
+                left->ptrs + left->n + 1,
+                right->ptrs,
+                (right->n + 1) * sizeof(void*)
+            );
+            left->n += right->n + 1;
+        }
+        memmove(
+            parent->keys + i,
+            parent->keys + i + 1,
+            (parent->n - i - 1) * sizeof(ktype)
+        );
+        memmove(
+            parent->ptrs + i + 1,
+            parent->ptrs + i + 2,
+            (parent->n - i - 1) * sizeof(void*)
+        );
+        parent->n -= 1;
+        free(right);
+    }
+    /* Move the last key of child i - 1 to child i. */
+    static
+    void
+    cx##_bt_from_left(
+            cx##_btree_t* parent,
+            int i
+    )
+    {
+        cx##_btree_t* left = parent->ptrs[i - 1];
+        cx##_btree_t* child = parent->ptrs[i];
+        int shift = child->leaf ? child->n : child->n + 1;
+        memmove(child->keys + 1, child->keys, child->n * sizeof(ktype));
+        memmove(child->ptrs + 1, child->ptrs, shift * sizeof(void*));
+        if(child->leaf) {
+            child->keys[0] = left->keys[left->n - 1];
+            child->ptrs[0] = left->ptrs[left->n - 1];
+            parent->keys[i - 1] = child->keys[0];
+        } else {
+            child->keys[0] = parent->keys[i - 1];
+            child->ptrs[0] = left->ptrs[left->n];
+            parent->keys[i - 1] = left->keys[left->n - 1];
+        }
+        left->n -= 1;
+        child->n += 1;
+    }
+    /* Move the first key of child i + 1 to child i. */
+    static
+    void
+    cx##_bt_from_right(
+            cx##_btree_t* parent,
+            int i
+    )
+    {
+        cx##_btree_t* child = parent->ptrs[i];
+        cx##_btree_t* right = parent->ptrs[i + 1];
+        int shift = right->leaf ? right->n - 1 : right->n;
+        if(child->leaf) {
+            child->keys[child->n] = right->keys[0];
+            child->ptrs[child->n] = right->ptrs[0];
+        } else {
+            child->keys[child->n] = parent->keys[i];
+            child->ptrs[child->n + 1] = right->ptrs[0];
+            parent->keys[i] = right->keys[0];
+        }
+        child->n += 1;
+        memmove(right->keys, right->keys + 1, (right->n - 1) * sizeof(ktype));
+        memmove(right->ptrs, right->ptrs + 1, shift * sizeof(void*));
+        right->n -= 1;
+        if(child->leaf)
+            parent->keys[i] = right->keys[0];
+    }
+    /* Make sure child i has more than BT_MIN keys, returns the new index. */
+    static
+    int
+    cx##_bt_fill(
+            cx##_btree_t* parent,
+            int i
+    )
+    {
+        cx##_btree_t* child = parent->ptrs[i];
+        if(child->n > (int) BT_MIN(ktype))
+            return i;
+        if(
+                i > 0 &&
+                ((cx##_btree_t*) parent->ptrs[i - 1])->n > (int) BT_MIN(ktype)
+        )
+            cx##_bt_from_left(parent, i);
+        else if(
+                i < parent->n &&
+                ((cx##_btree_t*) parent->ptrs[i + 1])->n > (int) BT_MIN(ktype)
+        )
+            cx##_bt_from_right(parent, i);
+        else if(i < parent->n)
+            cx##_bt_merge(parent, i);
+        else {
+            cx##_bt_merge(parent, i - 1);
+            i -= 1;
+        }
+        return i;
+    }
+    int
+    cx##_delete(
+            cx##_btree_t** tree,
+            type* key
+    )
+    {
+        cx##_btree_t* cur = *tree;
+        ktype k = cx##_key_m(key);
+        int i;
+        if(cur == NULL)
+            return 1;
+        while(!cur->leaf) {
+            i = cx##_bt_fill(cur, cx##_bt_upper(cur, k));
+            if(cur->n == 0) {
+                /* Only the root can become empty, the tree shrinks. */
+                assert(cur == *tree);
+                *tree = cur->ptrs[0];
+                free(cur);
+                cur = *tree;
+            } else
+                cur = cur->ptrs[i];
+        }
+        i = cx##_bt_lower(cur, k);
+        if(i == cur->n || cx##_key_cmp_m((cur->keys[i]), (k)) != 0)
+            return 1;
+        memmove(
+            cur->keys + i,
+            cur->keys + i + 1,
+            (cur->n - i - 1) * sizeof(ktype)
+        );
+        memmove(
+            cur->ptrs + i,
+            cur->ptrs + i + 1,
+            (cur->n - i - 1) * sizeof(void*)
+        );
+        cur->n -= 1;
+        if(cur->n == 0) {
+            assert(cur == *tree);
+            free(cur);
+            *tree = NULL;
+        }
+        return 0;
+    }
+    void
+    cx##_delete_node(
+            cx##_btree_t** tree,
+            type* node
+    )
+    {
+        int ret = cx##_delete(tree, node);
+        (void)(ret);
+        assert(ret == 0 && "Node not in tree");
+    }
+    int
+    cx##_find_key(
+            cx##_btree_t* tree,
+            ktype key,
+            type** node
+    )
+    {
+        int i;
+        if(tree == NULL)
+            return 1;
+        tree = cx##_bt_leaf(tree, key);
+        i = cx##_bt_lower(tree, key);
+        if(i == tree->n || cx##_key_cmp_m((tree->keys[i]), (key)) != 0)
+            return 1;
+        *node = tree->ptrs[i];
+        return 0;
+    }
+    int
+    cx##_find(
+            cx##_btree_t* tree,
+            type* key,
+            type** node
+    )
+    {
+        return cx##_find_key(tree, cx##_key_m(key), node);
+    }
+    int
+    cx##_lower_bound(
+            cx##_btree_t* tree,
+            type* key,
+            type** node
+    )
+    {
+        ktype k = cx##_key_m(key);
+        int i;
+        *node = NULL;
+        if(tree == NULL)
+            return 1;
+        tree = cx##_bt_leaf(tree, k);
+        i = cx##_bt_lower(tree, k);
+        if(i == tree->n) {
+            /* The next leaf starts with a key greater than key. */
+            tree = tree->ptrs[BT_CAP(ktype)];
+            i = 0;
+            if(tree == NULL)
+                return 1;
+        }
+        *node = tree->ptrs[i];
+        return 0;
+    }
+    void
+    cx##_iter_init(
+            cx##_btree_t* tree,
+            cx##_iter_t** iter,
+            type** elem
+    )
+    {
+        cx##_iter_t* it = *iter;
+        it->leaf = tree;
+        it->i = 0;
+        *elem = NULL;
+        if(tree == NULL)
+            return;
+        while(!it->leaf->leaf)
+            it->leaf = it->leaf->ptrs[0];
+        if(it->leaf->n > 0)
+            *elem = it->leaf->ptrs[0];
+    }
+    void
+    cx##_iter_next(
+            cx##_iter_t* iter,
+            type** elem
+    )
+    {
+        iter->i += 1;
+        if(iter->i == iter->leaf->n) {
+            iter->leaf = iter->leaf->ptrs[BT_CAP(ktype)];
+            iter->i = 0;
+            if(iter->leaf == NULL) {
+                *elem = NULL;
+                return;
+            }
+        }
+        *elem = iter->leaf->ptrs[iter->i];
+    }
+    static
+    void
+    cx##_bt_clear(
+            cx##_btree_t* node,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    )
+    {
+        int i;
+        if(node->leaf) {
+            if(callback != NULL) {
+                for(i = 0; i < node->n; i++)
+                    callback(node->ptrs[i], ctx);
+            }
+        } else {
+            for(i = 0; i <= node->n; i++)
+                cx##_bt_clear(node->ptrs[i], callback, ctx);
+        }
+        free(node);
+    }
+    void
+    cx##_clear(
+            cx##_btree_t** tree,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    )
+    {
+        if(*tree != NULL)
+            cx##_bt_clear(*tree, callback, ctx);
+        *tree = NULL;
+    }
+    size_t
+    cx##_size(
+            cx##_btree_t* tree
+    )
+    {
+        size_t size = 0;
+        if(tree == NULL)
+            return 0;
+        while(!tree->leaf)
+            tree = tree->ptrs[0];
+        for(; tree != NULL; tree = tree->ptrs[BT_CAP(ktype)])
+            size += tree->n;
+        return size;
+    }
+    /* Returns the height, lo and hi bound the keys if not NULL */
+    static
+    int
+    cx##_bt_check(
+            cx##_btree_t* node,
+            int root,
+            ktype* lo,
+            ktype* hi,
+            cx##_btree_t** prev
+    )
+    {
+        int i;
+        int height = 0;
+        int h;
+        (void)(lo);
+        (void)(hi);
+        (void)(root);
+        assert(node->n <= (int) BT_CAP(ktype) && "Node overflow");
+        assert((root || node->n >= (int) BT_MIN(ktype)) && "Node underflow");
+        for(i = 1; i < node->n; i++)
+            assert(
+                cx##_key_cmp_m((node->keys[i - 1]), (node->keys[i])) < 0 &&
+                "Keys not sorted"
+            );
+        if(node->n > 0) {
+            assert(
+                (lo == NULL || cx##_key_cmp_m((*lo), (node->keys[0])) <= 0) &&
+                "Key below separator"
+            );
+            assert(
+                (
+                    hi == NULL ||
+                    cx##_key_cmp_m((node->keys[node->n - 1]), (*hi)) < 0
+                ) &&
+                "Key above separator"
+            );
+        }
+        if(node->leaf) {
+            for(i = 0; i < node->n; i++)
+                assert(
+                    cx##_key_cmp_m(
+                        (cx##_key_m((type*) node->ptrs[i])),
+                        (node->keys[i])
+                    ) == 0 &&
+                    "Key differs from node"
+                );
+            assert(
+                (*prev == NULL || (*prev)->ptrs[BT_CAP(ktype)] == node) &&
+                "Leaves not linked"
+            );
+            *prev = node;
+            return 1;
+        }
+        for(i = 0; i <= node->n; i++) {
+            h = cx##_bt_check(
+                node->ptrs[i],
+                0,
+                i == 0 ? lo : &node->keys[i - 1],
+                i == node->n ? hi : &node->keys[i],
+                prev
+            );
+            assert((i == 0 || h == height) && "Leaves not at the same depth");
+            height = h;
+        }
+        return height + 1;
+    }
+    void
+    cx##_check_tree(
+            cx##_btree_t* tree
+    )
+    {
+        cx##_btree_t* prev = NULL;
+        if(tree == NULL)
+            return;
+        assert(tree->n > 0 && "Empty root");
+        cx##_bt_check(tree, 1, NULL, NULL, &prev);
+        assert(prev->ptrs[BT_CAP(ktype)] == NULL && "Leaves not linked");
+    }
+#enddef
+
+#define bt_bind_impl_cx_m(cx, type, ktype) bt_bind_impl_m(cx, type, ktype)
+
+#begindef bt_bind_m(cx, type, ktype)
+    bt_bind_decl_m(cx, type, ktype)
+    bt_bind_impl_m(cx, type, ktype)
+#enddef
+
+#define bt_bind_cx_m(cx, type, ktype) bt_bind_m(cx, type, ktype)
+
+#endif
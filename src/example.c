@@ -4,6 +4,7 @@
 #include <stdio.h>
 
 rb_bind_impl_m(bk, book_t)
+rb_key_bind_impl_m(bk, book_t, const char*)
 
 book_t* tree;
 
@@ -33,6 +34,15 @@ lookup_book(char isbn[14])
     );
 }
 
+void
+lookup_isbn(const char* isbn)
+{
+    book_t* book;
+    /* No key node needed */
+    bk_find_key(tree, isbn, &book);
+    printf("Found:  %s\n\n", book->title);
+}
+
 void
 remove_book(book_t* book)
 {
@@ -41,6 +51,14 @@ remove_book(book_t* book)
     free(book);
 }
 
+void
+free_book(book_t* book, void* ctx)
+{
+    (void)(ctx);
+    printf("Removing %s\n", book->isbn);
+    free(book);
+}
+
 int
 main(void)
 {
@@ -64,6 +82,7 @@ main(void)
     lookup_book("9780060147891");
     lookup_book("9780060855901");
     lookup_book("9780441182008");
+    lookup_isbn("9780060855901");
     rb_iter_decl_cx_m(bk, bk_iter, bk_elem);
     printf("Catalog:\n\n");
     /* The red-black tree may not be modified during iteration. */
@@ -71,9 +90,9 @@ main(void)
         printf("%s\n", bk_elem->isbn);
     }
     printf("\nRemoving:\n\n");
-    /* But we can remove the root till the tree is empty */
-    while(tree != bk_nil_ptr) {
-        remove_book(tree);
-    }
+    /* Remove one book, then clear the rest in O(N) */
+    remove_book(tree);
+    bk_clear(&tree, free_book, NULL);
+    assert(tree == bk_nil_ptr);
     return 0;
 }
@@ -18,4 +18,8 @@ struct book_s {
 #define bk_cmp_m(x, y) memcmp(x->isbn, y->isbn, 13)
 rb_bind_decl_m(bk, book_t)
 
+#define bk_key_m(x) (x)->isbn
+#define bk_key_cmp_m(x, y) memcmp(x, y, 13)
+rb_key_bind_decl_m(bk, book_t, const char*)
+
 #endif
@@ -0,0 +1,73 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+
+#define MSIZE 10000000
+#define MLOOKUP 2000000
+#define MBATCH 64
+
+node_t mnodes[MSIZE];
+node_t knodes[MLOOKUP];
+node_t* keys[MLOOKUP];
+node_t* out[MLOOKUP];
+
+int
+main(void)
+{
+    node_t* tree;
+    node_t* node;
+    clock_t start, end;
+    double scalar;
+    double cpu_time_used = 0.1;
+    size_t found = 0;
+    (void)(cpu_time_used);
+    fprintf(stderr, "preheat: ");
+    for(int i = 0; i < 200000000; i++)
+        cpu_time_used = cpu_time_used * cpu_time_used;
+    fprintf(stderr, "%d\n", (int) cpu_time_used);
+    fprintf(stderr, "prepare: ");
+    srand(42);
+    my_tree_init(&tree);
+    for(int i = 0; i < MSIZE; i++) {
+        node = &mnodes[i];
+        my_node_init(node);
+        rb_value_m(node) = rand();
+        my_insert(&tree, node);
+    }
+    for(int i = 0; i < MLOOKUP; i++) {
+        rb_value_m(&knodes[i]) = rb_value_m(&mnodes[rand() % MSIZE]);
+        keys[i] = &knodes[i];
+    }
+    fprintf(stderr, "done\n");
+    /* Lookups per second by batch size, the scalar loop is flat. */
+    fprintf(stderr, "rbtree_find\n");
+    start = clock();
+    for(int i = 0; i < MLOOKUP; i++)
+        found += my_find(tree, keys[i], &out[i]) == 0;
+    end = clock();
+    scalar = MLOOKUP / ((double) (end - start) / CLOCKS_PER_SEC);
+    printf("\"rbtree_find\"\n");
+    for(int b = 1; b <= MBATCH; b *= 2)
+        printf("%d %f\n", b, scalar);
+    fprintf(stderr, "rbtree_find_batch\n");
+    printf("\n\n\"rbtree_find_batch\"\n");
+    for(int b = 1; b <= MBATCH; b *= 2) {
+        start = clock();
+        for(int i = 0; i < MLOOKUP; i += b)
+            found += my_find_batch(
+                tree,
+                &keys[i],
+                MLOOKUP - i < b ? MLOOKUP - i : b,
+                &out[i]
+            );
+        end = clock();
+        cpu_time_used = MLOOKUP / ((double) (end - start) / CLOCKS_PER_SEC);
+        printf("%d %f\n", b, cpu_time_used);
+    }
+    printf("\n\n");
+    fprintf(stderr, "found: %d\n", (int) found);
+    return 0;
+}
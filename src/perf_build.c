@@ -0,0 +1,59 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+
+#define MSIZE 10000000
+#define MSTEP 100000
+
+node_t mnodes[MSIZE];
+node_t* pnodes[MSIZE];
+
+int
+main(void)
+{
+    node_t* tree;
+    node_t* node;
+    clock_t start, end;
+    double cpu_time_used = 0.1;
+    (void)(cpu_time_used);
+    fprintf(stderr, "preheat: ");
+    for(int i = 0; i < 200000000; i++)
+        cpu_time_used = cpu_time_used * cpu_time_used;
+    fprintf(stderr, "%d\n", (int) cpu_time_used);
+    fprintf(stderr, "prepare: ");
+    for(int i = 0; i < MSIZE; i++) {
+        node = &mnodes[i];
+        my_node_init(node);
+        rb_value_m(node) = i;
+        pnodes[i] = node;
+    }
+    fprintf(stderr, "rbtree_insert\n");
+    printf("\"rbtree_insert\"\n");
+    my_tree_init(&tree);
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        my_insert(&tree, &mnodes[i]);
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    fprintf(stderr, "rbtree_build_sorted\n");
+    printf("\n\n\"rbtree_build_sorted\"\n");
+    for(int i = MSTEP; i <= MSIZE; i += MSTEP) {
+        my_tree_init(&tree);
+        start = clock();
+        my_build_sorted(&tree, pnodes, i);
+        end = clock();
+        cpu_time_used = (double) (end - start);
+        printf("%d %f\n", i - 1, cpu_time_used);
+    }
+    printf("\n\n");
+    return 0;
+}
@@ -0,0 +1,165 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#ifdef __linux__
+#   include <linux/perf_event.h>
+#   include <sys/ioctl.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#endif
+
+#define MSIZE 10000000
+#define MSTEP 100000
+
+node_t mnodes[MSIZE];
+chnode_t cnodes[MSIZE];
+int keys[MSIZE];
+
+/* Count the branch misses of the lookups, if the kernel lets us. */
+static
+int
+misses_open(void)
+{
+#ifdef __linux__
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+    attr.disabled = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+#else
+    return -1;
+#endif
+}
+
+static
+void
+misses_start(int fd)
+{
+#ifdef __linux__
+    if(fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+        ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+    }
+#else
+    (void)(fd);
+#endif
+}
+
+static
+long long
+misses_stop(int fd)
+{
+    long long count = -1;
+#ifdef __linux__
+    if(fd >= 0) {
+        ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+        if(read(fd, &count, sizeof(count)) != sizeof(count))
+            count = -1;
+    }
+#else
+    (void)(fd);
+#endif
+    return count;
+}
+
+int
+main(void)
+{
+    node_t* tree;
+    node_t* node;
+    node_t key;
+    chnode_t* ctree;
+    chnode_t* cnode;
+    chnode_t ckey;
+    clock_t start, end;
+    double cpu_time_used = 0.1;
+    long long misses;
+    int fd = misses_open();
+    (void)(cpu_time_used);
+    fprintf(stderr, "preheat: ");
+    for(int i = 0; i < 200000000; i++)
+        cpu_time_used = cpu_time_used * cpu_time_used;
+    fprintf(stderr, "%d\n", (int) cpu_time_used);
+    srand(42);
+    for(int i = 0; i < MSIZE; i++)
+        keys[i] = rand();
+    fprintf(stderr, "rbtree_insert_find\n");
+    printf("\"rbtree_insert_find\"\n");
+    my_tree_init(&tree);
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        node = &mnodes[i];
+        my_node_init(node);
+        rb_value_m(node) = keys[i];
+        my_insert(&tree, node);
+        rb_value_m(&key) = keys[i / 2];
+        my_find(tree, &key, &node);
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    fprintf(stderr, "rbtree_child_insert_find\n");
+    printf("\n\n\"rbtree_child_insert_find\"\n");
+    mb_tree_init(&ctree);
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        cnode = &cnodes[i];
+        mb_node_init(cnode);
+        cnode->value = keys[i];
+        mb_insert(&ctree, cnode);
+        ckey.value = keys[i / 2];
+        mb_find(ctree, &ckey, &cnode);
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    printf("\n\n");
+    /* Lookup throughput of the full trees. */
+    misses_start(fd);
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        rb_value_m(&key) = keys[i];
+        my_find(tree, &key, &node);
+    }
+    end = clock();
+    misses = misses_stop(fd);
+    fprintf(
+        stderr,
+        "find: %.0f lookups/s, %lld branch misses\n",
+        MSIZE / ((double) (end - start) / CLOCKS_PER_SEC),
+        misses
+    );
+    misses_start(fd);
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        ckey.value = keys[i];
+        mb_find(ctree, &ckey, &cnode);
+    }
+    end = clock();
+    misses = misses_stop(fd);
+    fprintf(
+        stderr,
+        "child find: %.0f lookups/s, %lld branch misses\n",
+        MSIZE / ((double) (end - start) / CLOCKS_PER_SEC),
+        misses
+    );
+    if(fd < 0)
+        fprintf(stderr, "branch misses not available (-1)\n");
+    return 0;
+}
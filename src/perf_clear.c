@@ -0,0 +1,64 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+
+#define MSIZE 10000000
+#define MSTEP 1000000
+
+node_t mnodes[MSIZE];
+node_t* pnodes[MSIZE];
+
+static
+void
+build(node_t** tree, int n)
+{
+    for(int i = 0; i < n; i++)
+        my_node_init(&mnodes[i]);
+    my_tree_init(tree);
+    my_build_sorted(tree, pnodes, n);
+}
+
+int
+main(void)
+{
+    node_t* tree;
+    node_t* node;
+    clock_t start, end;
+    double cpu_time_used = 0.1;
+    (void)(cpu_time_used);
+    fprintf(stderr, "preheat: ");
+    for(int i = 0; i < 200000000; i++)
+        cpu_time_used = cpu_time_used * cpu_time_used;
+    fprintf(stderr, "%d\n", (int) cpu_time_used);
+    for(int i = 0; i < MSIZE; i++) {
+        node = &mnodes[i];
+        rb_value_m(node) = i;
+        pnodes[i] = node;
+    }
+    fprintf(stderr, "rbtree_delete_root\n");
+    printf("\"rbtree_delete_root\"\n");
+    for(int i = MSTEP; i <= MSIZE; i += MSTEP) {
+        build(&tree, i);
+        start = clock();
+        while(tree != my_nil_ptr)
+            my_delete_node(&tree, tree);
+        end = clock();
+        cpu_time_used = (double) (end - start);
+        printf("%d %f\n", i - 1, cpu_time_used);
+    }
+    fprintf(stderr, "rbtree_clear\n");
+    printf("\n\n\"rbtree_clear\"\n");
+    for(int i = MSTEP; i <= MSIZE; i += MSTEP) {
+        build(&tree, i);
+        start = clock();
+        my_clear(&tree, NULL, NULL);
+        end = clock();
+        cpu_time_used = (double) (end - start);
+        printf("%d %f\n", i - 1, cpu_time_used);
+    }
+    printf("\n\n");
+    return 0;
+}
@@ -9,6 +9,7 @@
 #define MSIZE 10000000
 
 node_t mnodes[MSIZE];
+cpnode_t cnodes[MSIZE];
 
 SGLIB_DEFINE_RBTREE_PROTOTYPES(
     node_t,
@@ -33,6 +34,9 @@ main(void)
     my_tree_init(&tree);
     node_t* node;
     node_t* key;
+    cpnode_t* ctree;
+    cpnode_t* cnode;
+    mt_btree_t* btree;
     clock_t start, end;
     double cpu_time_used = 0.1;
     (void)(cpu_time_used);
@@ -65,7 +69,7 @@ main(void)
         }
     }
     fprintf(stderr, "prepare: ");
-    assert(tree = my_nil_ptr);
+    assert(tree == my_nil_ptr);
     for(int i = 0; i < MSIZE; i++) {
         node = &mnodes[i];
         if(rb_value_m(node) != 0)
@@ -85,7 +89,7 @@ main(void)
             start = clock();
         }
     }
-    assert(tree = my_nil_ptr);
+    assert(tree == my_nil_ptr);
     fprintf(stderr, "prepare: ");
     tree = NULL;
     for(int i = 0; i < MSIZE; i++) {
@@ -110,6 +114,49 @@ main(void)
         }
     }
     assert(tree == NULL);
+    fprintf(stderr, "prepare: ");
+    mc_tree_init(&ctree);
+    for(int i = 0; i < MSIZE; i++) {
+        cnode = &cnodes[i];
+        mc_node_init(cnode);
+        rb_value_m(cnode) = rb_value_m(&mnodes[i]);
+        mc_insert(&ctree, cnode);
+    }
+    fprintf(
+        stderr,
+        "rbtree_compact: %d vs %d bytes per node\n",
+        (int) sizeof(cpnode_t),
+        (int) sizeof(node_t)
+    );
+    printf("\n\n\"rbtree_compact\"\n");
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        mc_delete_node(&ctree, &cnodes[i]);
+        if(((i + 1) % 10000) == 0) {
+            end = clock();
+            cpu_time_used = (double) (end - start);
+            printf("%d %f\n", MSIZE - i, cpu_time_used);
+            start = clock();
+        }
+    }
+    assert(ctree == mc_nil_ptr);
+    fprintf(stderr, "prepare: ");
+    mt_tree_init(&btree);
+    for(int i = 0; i < MSIZE; i++)
+        mt_insert(&btree, &mnodes[i]);
+    fprintf(stderr, "btree: %d keys per node\n", (int) BT_CAP(int));
+    printf("\n\n\"btree\"\n");
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        mt_delete_node(&btree, &mnodes[i]);
+        if(((i + 1) % 10000) == 0) {
+            end = clock();
+            cpu_time_used = (double) (end - start);
+            printf("%d %f\n", MSIZE - i, cpu_time_used);
+            start = clock();
+        }
+    }
+    assert(btree == NULL);
     printf("\n\n");
     return 0;
 }
@@ -0,0 +1,90 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+
+#define MSIZE 10000000
+#define MLOOKUP 2000000
+
+node_t mnodes[MSIZE];
+int keys[MLOOKUP];
+
+int
+main(void)
+{
+    node_t* tree;
+    node_t* node;
+    my_frozen_t frozen;
+    mt_btree_t* btree;
+    clock_t start, end;
+    double cpu_time_used = 0.1;
+    size_t found = 0;
+    (void)(cpu_time_used);
+    fprintf(stderr, "preheat: ");
+    for(int i = 0; i < 200000000; i++)
+        cpu_time_used = cpu_time_used * cpu_time_used;
+    fprintf(stderr, "%d\n", (int) cpu_time_used);
+    srand(42);
+    for(int i = 0; i < MSIZE; i++) {
+        node = &mnodes[i];
+        my_node_init(node);
+        rb_value_m(node) = rand();
+    }
+    /* Lookups per second by tree size, find_key vs frozen_find vs btree. */
+    printf("\"rbtree_find_key\"\n");
+    for(int size = 1000; size <= MSIZE; size *= 10) {
+        fprintf(stderr, "rbtree_find_key %d\n", size);
+        my_tree_init(&tree);
+        for(int i = 0; i < size; i++)
+            my_insert(&tree, &mnodes[i]);
+        for(int i = 0; i < MLOOKUP; i++)
+            keys[i] = rb_value_m(&mnodes[rand() % size]);
+        start = clock();
+        for(int i = 0; i < MLOOKUP; i++)
+            found += my_find_key(tree, keys[i], &node) == 0;
+        end = clock();
+        cpu_time_used = MLOOKUP / ((double) (end - start) / CLOCKS_PER_SEC);
+        printf("%d %f\n", size, cpu_time_used);
+        my_clear(&tree, NULL, NULL);
+    }
+    printf("\n\n\"rbtree_frozen_find\"\n");
+    for(int size = 1000; size <= MSIZE; size *= 10) {
+        fprintf(stderr, "rbtree_frozen_find %d\n", size);
+        my_tree_init(&tree);
+        for(int i = 0; i < size; i++)
+            my_insert(&tree, &mnodes[i]);
+        if(my_freeze(tree, &frozen) != 0)
+            return 1;
+        for(int i = 0; i < MLOOKUP; i++)
+            keys[i] = rb_value_m(&mnodes[rand() % size]);
+        start = clock();
+        for(int i = 0; i < MLOOKUP; i++)
+            found += my_frozen_find(&frozen, keys[i], &node) == 0;
+        end = clock();
+        cpu_time_used = MLOOKUP / ((double) (end - start) / CLOCKS_PER_SEC);
+        printf("%d %f\n", size, cpu_time_used);
+        my_frozen_free(&frozen);
+        my_clear(&tree, NULL, NULL);
+    }
+    printf("\n\n\"btree_find_key\"\n");
+    for(int size = 1000; size <= MSIZE; size *= 10) {
+        fprintf(stderr, "btree_find_key %d\n", size);
+        mt_tree_init(&btree);
+        for(int i = 0; i < size; i++)
+            mt_insert(&btree, &mnodes[i]);
+        for(int i = 0; i < MLOOKUP; i++)
+            keys[i] = rb_value_m(&mnodes[rand() % size]);
+        start = clock();
+        for(int i = 0; i < MLOOKUP; i++)
+            found += mt_find_key(btree, keys[i], &node) == 0;
+        end = clock();
+        cpu_time_used = MLOOKUP / ((double) (end - start) / CLOCKS_PER_SEC);
+        printf("%d %f\n", size, cpu_time_used);
+        mt_clear(&btree, NULL, NULL);
+    }
+    printf("\n\n");
+    fprintf(stderr, "found: %d\n", (int) found);
+    return 0;
+}
@@ -0,0 +1,90 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+
+#define MSIZE 10000000
+#define MSTEP 100000
+
+node_t mnodes[MSIZE];
+int keys[MSIZE];
+
+static
+void
+prepare(void)
+{
+    for(int i = 0; i < MSIZE; i++) {
+        my_node_init(&mnodes[i]);
+        rb_value_m(&mnodes[i]) = keys[i];
+    }
+}
+
+int
+main(void)
+{
+    node_t* tree;
+    node_t* hint;
+    mh_tree_t htree;
+    clock_t start, end;
+    double cpu_time_used = 0.1;
+    (void)(cpu_time_used);
+    fprintf(stderr, "preheat: ");
+    for(int i = 0; i < 200000000; i++)
+        cpu_time_used = cpu_time_used * cpu_time_used;
+    fprintf(stderr, "%d\n", (int) cpu_time_used);
+    /* Near-sorted keys, like timestamps that arrive a bit out of order. */
+    srand(42);
+    for(int i = 0; i < MSIZE; i++)
+        keys[i] = i * 8 + (rand() % 16);
+    fprintf(stderr, "rbtree_insert\n");
+    printf("\"rbtree_insert\"\n");
+    prepare();
+    my_tree_init(&tree);
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        my_insert(&tree, &mnodes[i]);
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    fprintf(stderr, "rbtree_insert_hint\n");
+    printf("\n\n\"rbtree_insert_hint\"\n");
+    prepare();
+    my_tree_init(&tree);
+    hint = my_nil_ptr;
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        if(my_insert_hint(&tree, hint, &mnodes[i]) == 0)
+            hint = &mnodes[i];
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    fprintf(stderr, "rbtree_head_insert\n");
+    printf("\n\n\"rbtree_head_insert\"\n");
+    prepare();
+    mh_tree_init(&htree);
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        mh_insert(&htree, &mnodes[i]);
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    printf("\n\n");
+    return 0;
+}
@@ -9,6 +9,7 @@
 #define MSIZE 10000000
 
 node_t mnodes[MSIZE];
+cpnode_t cnodes[MSIZE];
 
 SGLIB_DEFINE_RBTREE_PROTOTYPES(
     node_t,
@@ -32,6 +33,9 @@ main(void)
     node_t* tree;
     my_tree_init(&tree);
     node_t* node;
+    cpnode_t* ctree;
+    cpnode_t* cnode;
+    mt_btree_t* btree;
     clock_t start, end;
     double cpu_time_used = 0.1;
     (void)(cpu_time_used);
@@ -78,6 +82,44 @@ main(void)
             start = clock();
         }
     }
+    fprintf(stderr, "prepare: ");
+    mc_tree_init(&ctree);
+    for(int i = 0; i < MSIZE; i++) {
+        cnode = &cnodes[i];
+        mc_node_init(cnode);
+        rb_value_m(cnode) = rb_value_m(&mnodes[i]);
+    }
+    fprintf(
+        stderr,
+        "rbtree_compact: %d vs %d bytes per node\n",
+        (int) sizeof(cpnode_t),
+        (int) sizeof(node_t)
+    );
+    printf("\n\n\"rbtree_compact\"\n");
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        mc_insert(&ctree, &cnodes[i]);
+        if(((i + 1) % 10000) == 0) {
+            end = clock();
+            cpu_time_used = (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    mt_tree_init(&btree);
+    fprintf(stderr, "btree: %d keys per node\n", (int) BT_CAP(int));
+    printf("\n\n\"btree\"\n");
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        mt_insert(&btree, &mnodes[i]);
+        if(((i + 1) % 10000) == 0) {
+            end = clock();
+            cpu_time_used = (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    mt_clear(&btree, NULL, NULL);
     printf("\n\n");
     return 0;
 }
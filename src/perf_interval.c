@@ -0,0 +1,108 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+
+#define MSIZE 10000000
+#define MSTEP 1000000
+#define MSCANS 4
+#define MQUERIES 10000
+#define MRANGE 1000
+
+ivnode_t mnodes[MSIZE];
+
+static
+long
+query_scan(ivnode_t* tree, ivnode_t* key)
+{
+    long count = 0;
+    rb_iter_decl_cx_m(mi, iter, node);
+    rb_for_m(mi, tree, iter, node) {
+        if(
+                rb_start_m(node) <= rb_end_m(key) &&
+                rb_end_m(node) >= rb_start_m(key)
+        )
+            count += 1;
+    }
+    return count;
+}
+
+static
+long
+query_tree(ivnode_t* tree, ivnode_t* key)
+{
+    long count = 0;
+    ivnode_t* elem;
+    rb_for_overlap_m(mi, tree, key, elem) {
+        count += 1;
+    }
+    return count;
+}
+
+static
+void
+random_key(ivnode_t* key)
+{
+    rb_start_m(key) = rand();
+    rb_end_m(key) = rb_start_m(key) + (rand() % MRANGE);
+}
+
+int
+main(void)
+{
+    ivnode_t* tree;
+    ivnode_t* node;
+    ivnode_t* found;
+    ivnode_t key;
+    clock_t start, end;
+    long count_scan = 0;
+    long count_tree = 0;
+    double time_scan[MSIZE / MSTEP];
+    double time_tree[MSIZE / MSTEP];
+    double cpu_time_used = 0.1;
+    (void)(cpu_time_used);
+    fprintf(stderr, "preheat: ");
+    for(int i = 0; i < 200000000; i++)
+        cpu_time_used = cpu_time_used * cpu_time_used;
+    fprintf(stderr, "%d\n", (int) cpu_time_used);
+    fprintf(stderr, "prepare\n");
+    srand(42);
+    mi_tree_init(&tree);
+    for(int i = 0; i < MSIZE; i++) {
+        node = &mnodes[i];
+        mi_node_init(node);
+        do {
+            random_key(node);
+        } while(mi_find(tree, node, &found) == 0);
+        mi_insert(&tree, node);
+        if(((i + 1) % MSTEP) == 0) {
+            int s = i / MSTEP;
+            fprintf(stderr, "query %d\n", i + 1);
+            start = clock();
+            for(int j = 0; j < MSCANS; j++) {
+                random_key(&key);
+                count_scan += query_scan(tree, &key);
+            }
+            end = clock();
+            time_scan[s] = (double) (end - start) / MSCANS;
+            start = clock();
+            for(int j = 0; j < MQUERIES; j++) {
+                random_key(&key);
+                count_tree += query_tree(tree, &key);
+            }
+            end = clock();
+            time_tree[s] = (double) (end - start) / MQUERIES;
+        }
+    }
+    fprintf(stderr, "overlaps %ld %ld\n", count_scan, count_tree);
+    printf("\"linear_scan\"\n");
+    for(int s = 0; s < MSIZE / MSTEP; s++)
+        printf("%d %f\n", (s + 1) * MSTEP, time_scan[s]);
+    printf("\n\n\"rbtree_overlap\"\n");
+    for(int s = 0; s < MSIZE / MSTEP; s++)
+        printf("%d %f\n", (s + 1) * MSTEP, time_tree[s]);
+    printf("\n\n");
+    return 0;
+}
@@ -0,0 +1,118 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+#include <pthread.h>
+
+#define MTHREADS 8
+#define MSIZE 500000
+
+node_t mnodes[MTHREADS][MSIZE];
+cpnode_t cnodes[MTHREADS][MSIZE];
+node_t* trees[MTHREADS];
+cpnode_t* ctrees[MTHREADS];
+int keys[MSIZE];
+
+/* The threads run in parallel, so we measure wall time. */
+static
+double
+wall_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static
+void*
+delete_tree(void* arg)
+{
+    int t = (int) (intptr_t) arg;
+    for(int i = 0; i < MSIZE; i++)
+        my_delete_node(&trees[t], &mnodes[t][i]);
+    return NULL;
+}
+
+static
+void*
+delete_ctree(void* arg)
+{
+    int t = (int) (intptr_t) arg;
+    for(int i = 0; i < MSIZE; i++)
+        mc_delete_node(&ctrees[t], &cnodes[t][i]);
+    return NULL;
+}
+
+static
+double
+run(void* (*task)(void*), int threads)
+{
+    pthread_t thread[MTHREADS];
+    double start = wall_time();
+    for(int t = 0; t < threads; t++)
+        pthread_create(&thread[t], NULL, task, (void*) (intptr_t) t);
+    for(int t = 0; t < threads; t++)
+        pthread_join(thread[t], NULL);
+    return wall_time() - start;
+}
+
+static
+void
+prepare(int threads)
+{
+    for(int t = 0; t < threads; t++) {
+        my_tree_init(&trees[t]);
+        mc_tree_init(&ctrees[t]);
+        for(int i = 0; i < MSIZE; i++) {
+            my_node_init(&mnodes[t][i]);
+            rb_value_m(&mnodes[t][i]) = keys[i];
+            my_insert(&trees[t], &mnodes[t][i]);
+            mc_node_init(&cnodes[t][i]);
+            rb_value_m(&cnodes[t][i]) = keys[i];
+            mc_insert(&ctrees[t], &cnodes[t][i]);
+        }
+    }
+}
+
+int
+main(void)
+{
+    double time_used[MTHREADS + 1];
+    double ctime_used[MTHREADS + 1];
+    double cpu_time_used = 0.1;
+    (void)(cpu_time_used);
+    fprintf(stderr, "preheat: ");
+    for(int i = 0; i < 200000000; i++)
+        cpu_time_used = cpu_time_used * cpu_time_used;
+    fprintf(stderr, "%d\n", (int) cpu_time_used);
+    /* Unique keys in random order, every thread deletes its own tree. */
+    for(int i = 0; i < MSIZE; i++)
+        keys[i] = i;
+    srand(42);
+    for(int i = MSIZE - 1; i > 0; i--) {
+        int j = rand() % (i + 1);
+        int tmp = keys[i];
+        keys[i] = keys[j];
+        keys[j] = tmp;
+    }
+    for(int threads = 1; threads <= MTHREADS; threads++) {
+        fprintf(stderr, "threads: %d\n", threads);
+        prepare(threads);
+        time_used[threads] = run(delete_tree, threads);
+        ctime_used[threads] = run(delete_ctree, threads);
+        for(int t = 0; t < threads; t++) {
+            assert(trees[t] == my_nil_ptr);
+            assert(ctrees[t] == mc_nil_ptr);
+        }
+    }
+    printf("\"rbtree_delete_node\"\n");
+    for(int threads = 1; threads <= MTHREADS; threads++)
+        printf("%d %f\n", threads, time_used[threads]);
+    printf("\n\n\"rbtree_compact_delete_node\"\n");
+    for(int threads = 1; threads <= MTHREADS; threads++)
+        printf("%d %f\n", threads, ctime_used[threads]);
+    printf("\n\n");
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+
+#define MSIZE 10000000
+#define MSTEP 100000
+
+node_t mnodes[MSIZE];
+ixnode_t mpool[MSIZE + 1];
+int keys[MSIZE];
+
+int
+main(void)
+{
+    node_t* tree;
+    node_t* node;
+    node_t key;
+    ixnode_t* itree;
+    ixnode_t* inode;
+    ixnode_t ikey;
+    clock_t start, end;
+    double cpu_time_used = 0.1;
+    (void)(cpu_time_used);
+    fprintf(stderr, "preheat: ");
+    for(int i = 0; i < 200000000; i++)
+        cpu_time_used = cpu_time_used * cpu_time_used;
+    fprintf(stderr, "%d\n", (int) cpu_time_used);
+    fprintf(
+        stderr,
+        "node size: pointer %d, pool %d, pool links %d bytes\n",
+        (int) sizeof(node_t),
+        (int) sizeof(ixnode_t),
+        (int) (sizeof(ixnode_t) - sizeof(int))
+    );
+    srand(42);
+    for(int i = 0; i < MSIZE; i++)
+        keys[i] = rand();
+    fprintf(stderr, "rbtree_insert_find\n");
+    printf("\"rbtree_insert_find\"\n");
+    my_tree_init(&tree);
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        node = &mnodes[i];
+        my_node_init(node);
+        rb_value_m(node) = keys[i];
+        my_insert(&tree, node);
+        rb_value_m(&key) = keys[i / 2];
+        my_find(tree, &key, &node);
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    fprintf(stderr, "rbtree_pool_insert_find\n");
+    printf("\n\n\"rbtree_pool_insert_find\"\n");
+    mq_pool_init(mpool);
+    mq_tree_init(&itree);
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        inode = &mpool[i + 1];
+        mq_node_init(inode);
+        inode->value = keys[i];
+        mq_insert(&itree, inode);
+        ikey.value = keys[i / 2];
+        mq_find(itree, &ikey, &inode);
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    printf("\n\n");
+    return 0;
+}
@@ -0,0 +1,159 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+#include <pthread.h>
+
+#define MTHREADS 64
+#define MSIZE 1000000
+#define MLOOKUP 2000000
+#define MOWN 1024
+
+node_t tnodes[MSIZE];
+node_t snodes[MSIZE];
+node_t wnodes[2][MOWN];
+my_ts_t ts;
+my_seq_t seq;
+int threads;
+int stop;
+
+/* The threads run in parallel, so we measure wall time. */
+static
+double
+wall_time(void)
+{
+    struct timespec tv;
+    clock_gettime(CLOCK_MONOTONIC, &tv);
+    return tv.tv_sec + tv.tv_nsec / 1000000000.0;
+}
+
+static
+void*
+ts_reader(void* arg)
+{
+    unsigned int seed = (int) (intptr_t) arg + 1;
+    node_t key;
+    node_t* node;
+    for(int i = 0; i < MLOOKUP / threads; i++) {
+        rb_value_m(&key) = rand_r(&seed) % (2 * MSIZE);
+        my_ts_find(&ts, &key, &node);
+    }
+    return NULL;
+}
+
+static
+void*
+seq_reader(void* arg)
+{
+    unsigned int seed = (int) (intptr_t) arg + 1;
+    node_t key;
+    node_t* node;
+    for(int i = 0; i < MLOOKUP / threads; i++) {
+        rb_value_m(&key) = rand_r(&seed) % (2 * MSIZE);
+        my_seq_find(&seq, &key, &node);
+    }
+    return NULL;
+}
+
+/* One writer inserts and deletes odd keys until the readers are done. */
+static
+void*
+ts_writer(void* arg)
+{
+    (void)(arg);
+    while(!__atomic_load_n(&stop, __ATOMIC_RELAXED)) {
+        for(int j = 0; j < MOWN; j++)
+            my_ts_insert(&ts, &wnodes[0][j]);
+        for(int j = 0; j < MOWN; j++)
+            my_ts_delete_node(&ts, &wnodes[0][j]);
+    }
+    return NULL;
+}
+
+static
+void*
+seq_writer(void* arg)
+{
+    (void)(arg);
+    while(!__atomic_load_n(&stop, __ATOMIC_RELAXED)) {
+        for(int j = 0; j < MOWN; j++)
+            my_seq_insert(&seq, &wnodes[1][j]);
+        for(int j = 0; j < MOWN; j++)
+            my_seq_delete_node(&seq, &wnodes[1][j]);
+    }
+    return NULL;
+}
+
+static
+double
+run(void* (*reader)(void*), void* (*writer)(void*))
+{
+    pthread_t thread[MTHREADS];
+    pthread_t wthread;
+    double start;
+    double time;
+    stop = 0;
+    if(writer != NULL)
+        pthread_create(&wthread, NULL, writer, NULL);
+    start = wall_time();
+    for(int t = 0; t < threads; t++)
+        pthread_create(&thread[t], NULL, reader, (void*) (intptr_t) t);
+    for(int t = 0; t < threads; t++)
+        pthread_join(thread[t], NULL);
+    time = wall_time() - start;
+    __atomic_store_n(&stop, 1, __ATOMIC_RELAXED);
+    if(writer != NULL)
+        pthread_join(wthread, NULL);
+    return MLOOKUP / time;
+}
+
+static
+void
+series(
+        const char* name,
+        void* (*reader)(void*),
+        void* (*writer)(void*)
+)
+{
+    printf("\"%s\"\n", name);
+    for(threads = 1; threads <= MTHREADS; threads *= 2) {
+        fprintf(stderr, "%s threads: %d\n", name, threads);
+        printf("%d %f\n", threads, run(reader, writer));
+    }
+    printf("\n\n");
+}
+
+int
+main(void)
+{
+    double cpu_time_used = 0.1;
+    (void)(cpu_time_used);
+    fprintf(stderr, "preheat: ");
+    for(int i = 0; i < 200000000; i++)
+        cpu_time_used = cpu_time_used * cpu_time_used;
+    fprintf(stderr, "%d\n", (int) cpu_time_used);
+    /* Even keys are in the trees, the writers use odd keys. */
+    my_ts_init(&ts);
+    my_seq_init(&seq);
+    for(int i = 0; i < MSIZE; i++) {
+        my_node_init(&tnodes[i]);
+        rb_value_m(&tnodes[i]) = 2 * i;
+        my_ts_insert(&ts, &tnodes[i]);
+        my_node_init(&snodes[i]);
+        rb_value_m(&snodes[i]) = 2 * i;
+        my_seq_insert(&seq, &snodes[i]);
+    }
+    for(int j = 0; j < MOWN; j++) {
+        for(int w = 0; w < 2; w++) {
+            my_node_init(&wnodes[w][j]);
+            rb_value_m(&wnodes[w][j]) = 2 * j * (MSIZE / MOWN) + 1;
+        }
+    }
+    series("rwlock", ts_reader, NULL);
+    series("seqlock", seq_reader, NULL);
+    series("rwlock_writer", ts_reader, ts_writer);
+    series("seqlock_writer", seq_reader, seq_writer);
+    return 0;
+}
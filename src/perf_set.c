@@ -0,0 +1,116 @@
+/* Not testing.h, it runs the set operations in threads even for tiny trees.
+ * We keep the production RB_PAR_BH and make RB_PAR_DEPTH a variable, so one
+ * binary measures 1 to 2^MDEPTH threads. */
+#define RB_PTHREAD
+#define RB_PAR_DEPTH par_depth
+#include "rbtree.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+
+#define MSIZE 4000000
+#define MDEPTH 4
+
+struct node_s;
+typedef struct node_s node_t;
+struct node_s {
+    int     value;
+    char    color;
+    node_t* parent;
+    node_t* left;
+    node_t* right;
+};
+
+static int par_depth;
+
+#define ps_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
+rb_bind_m(ps, node_t)
+
+typedef void (*set_op_f)(node_t** tree, node_t** other, node_t** rest);
+
+node_t anodes[MSIZE];
+node_t bnodes[MSIZE];
+node_t* apnodes[MSIZE];
+node_t* bpnodes[MSIZE];
+
+/* The set operations run in threads, so we measure wall time. */
+static
+double
+wall_time(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+static
+void
+build(node_t** a, node_t** b)
+{
+    ps_tree_init(a);
+    ps_tree_init(b);
+    ps_build_sorted(a, apnodes, MSIZE);
+    ps_build_sorted(b, bpnodes, MSIZE);
+}
+
+int
+main(void)
+{
+    node_t* a;
+    node_t* b;
+    node_t* rest;
+    double start, end;
+    double serial;
+    set_op_f ops[] = {ps_union, ps_intersect, ps_difference};
+    const char* names[] = {
+        "rbtree_union",
+        "rbtree_intersect",
+        "rbtree_difference"
+    };
+    double cpu_time_used = 0.1;
+    (void)(cpu_time_used);
+    fprintf(stderr, "preheat: ");
+    for(int i = 0; i < 200000000; i++)
+        cpu_time_used = cpu_time_used * cpu_time_used;
+    fprintf(stderr, "%d\n", (int) cpu_time_used);
+    fprintf(stderr, "prepare\n");
+    /* A third of the keys are in both trees. */
+    for(int i = 0; i < MSIZE; i++) {
+        rb_value_m(&anodes[i]) = i * 2;
+        rb_value_m(&bnodes[i]) = i * 3;
+        apnodes[i] = &anodes[i];
+        bpnodes[i] = &bnodes[i];
+    }
+    /* The depth d runs the halves in up to 2^d threads. */
+    for(int o = 0; o < 3; o++) {
+        fprintf(stderr, "%s\n", names[o]);
+        printf("\"%s\"\n", names[o]);
+        for(par_depth = 0; par_depth <= MDEPTH; par_depth++) {
+            build(&a, &b);
+            ps_tree_init(&rest);
+            start = wall_time();
+            ops[o](&a, &b, &rest);
+            end = wall_time();
+            printf("%d %f\n", 1 << par_depth, end - start);
+        }
+        printf("\n\n");
+    }
+    /* The serial baseline inserts the nodes of b one by one. */
+    fprintf(stderr, "rbtree_insert_loop\n");
+    printf("\"rbtree_insert_loop\"\n");
+    build(&a, &b);
+    start = wall_time();
+    for(int i = 0; i < MSIZE; i++) {
+        node_t* node = bpnodes[i];
+        ps_node_init(node);
+        ps_insert(&a, node);
+    }
+    end = wall_time();
+    serial = end - start;
+    for(par_depth = 0; par_depth <= MDEPTH; par_depth++)
+        printf("%d %f\n", 1 << par_depth, serial);
+    printf("\n\n");
+    return 0;
+}
@@ -0,0 +1,122 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+
+#define MSIZE 5000000
+#define MSTEP 100000
+
+int keys[MSIZE];
+node_t* nodes[MSIZE];
+void* junk[MSIZE];
+
+int
+main(void)
+{
+    node_t* tree;
+    node_t* node;
+    node_t key;
+    my_slab_t slab;
+    clock_t start, end;
+    double cpu_time_used = 0.1;
+    (void)(cpu_time_used);
+    fprintf(stderr, "preheat: ");
+    for(int i = 0; i < 200000000; i++)
+        cpu_time_used = cpu_time_used * cpu_time_used;
+    fprintf(stderr, "%d\n", (int) cpu_time_used);
+    srand(42);
+    for(int i = 0; i < MSIZE; i++)
+        keys[i] = rand();
+    /* Interleave other allocations, so the nodes are scattered on the heap
+     * like in a long running program. */
+    fprintf(stderr, "rbtree_malloc_insert_find\n");
+    printf("\"rbtree_malloc_insert_find\"\n");
+    my_tree_init(&tree);
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        node = malloc(sizeof(node_t));
+        junk[i] = malloc(16 + (keys[i] % 8) * 16);
+        my_node_init(node);
+        rb_value_m(node) = keys[i];
+        if(my_insert(&tree, node) != 0) {
+            free(node);
+            node = NULL;
+        }
+        nodes[i] = node;
+        rb_value_m(&key) = keys[i / 2];
+        my_find(tree, &key, &node);
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    fprintf(stderr, "rbtree_malloc_delete\n");
+    printf("\n\n\"rbtree_malloc_delete\"\n");
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        if(nodes[i] != NULL) {
+            my_delete_node(&tree, nodes[i]);
+            free(nodes[i]);
+        }
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    for(int i = 0; i < MSIZE; i++)
+        free(junk[i]);
+    fprintf(stderr, "rbtree_slab_insert_find\n");
+    printf("\n\n\"rbtree_slab_insert_find\"\n");
+    my_slab_init(&slab, RB_SLAB_HUGEPAGE);
+    my_tree_init(&tree);
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        node = my_alloc(&slab);
+        junk[i] = malloc(16 + (keys[i] % 8) * 16);
+        my_node_init(node);
+        rb_value_m(node) = keys[i];
+        if(my_insert(&tree, node) != 0) {
+            my_free(&slab, node);
+            node = NULL;
+        }
+        nodes[i] = node;
+        rb_value_m(&key) = keys[i / 2];
+        my_find(tree, &key, &node);
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    fprintf(stderr, "rbtree_slab_delete\n");
+    printf("\n\n\"rbtree_slab_delete\"\n");
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        if(nodes[i] != NULL) {
+            my_delete_node(&tree, nodes[i]);
+            my_free(&slab, nodes[i]);
+        }
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    printf("\n\n");
+    for(int i = 0; i < MSIZE; i++)
+        free(junk[i]);
+    my_slab_destroy(&slab);
+    return 0;
+}
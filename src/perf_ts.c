@@ -0,0 +1,102 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+#include <pthread.h>
+
+#define MTHREADS 8
+#define MSIZE 1000000
+#define MOPS 2000000
+#define MOWN 1024
+
+node_t mnodes[MSIZE];
+node_t onodes[MTHREADS][MOWN];
+char inserted[MTHREADS][MOWN];
+my_ts_t ts;
+int reads;
+int threads;
+
+/* The threads run in parallel, so we measure wall time. */
+static
+double
+wall_time(void)
+{
+    struct timespec tv;
+    clock_gettime(CLOCK_MONOTONIC, &tv);
+    return tv.tv_sec + tv.tv_nsec / 1000000000.0;
+}
+
+/* Reads find a random key, writes insert or delete a node of the thread. */
+static
+void*
+worker(void* arg)
+{
+    int t = (int) (intptr_t) arg;
+    unsigned int seed = t + 1;
+    node_t key;
+    node_t* node;
+    for(int i = 0; i < MOPS / threads; i++) {
+        if((int) (rand_r(&seed) % 100) < reads) {
+            rb_value_m(&key) = rand_r(&seed) % (2 * MSIZE);
+            my_ts_find(&ts, &key, &node);
+        } else {
+            int j = rand_r(&seed) % MOWN;
+            if(inserted[t][j])
+                my_ts_delete_node(&ts, &onodes[t][j]);
+            else
+                my_ts_insert(&ts, &onodes[t][j]);
+            inserted[t][j] = !inserted[t][j];
+        }
+    }
+    return NULL;
+}
+
+static
+double
+run(void)
+{
+    pthread_t thread[MTHREADS];
+    double start = wall_time();
+    for(int t = 0; t < threads; t++)
+        pthread_create(&thread[t], NULL, worker, (void*) (intptr_t) t);
+    for(int t = 0; t < threads; t++)
+        pthread_join(thread[t], NULL);
+    return MOPS / (wall_time() - start);
+}
+
+int
+main(void)
+{
+    int ratios[] = {100, 90, 50};
+    double cpu_time_used = 0.1;
+    (void)(cpu_time_used);
+    fprintf(stderr, "preheat: ");
+    for(int i = 0; i < 200000000; i++)
+        cpu_time_used = cpu_time_used * cpu_time_used;
+    fprintf(stderr, "%d\n", (int) cpu_time_used);
+    /* Even keys are in the tree, the threads own disjoint odd keys. */
+    my_ts_init(&ts);
+    for(int i = 0; i < MSIZE; i++) {
+        my_node_init(&mnodes[i]);
+        rb_value_m(&mnodes[i]) = 2 * i;
+        my_ts_insert(&ts, &mnodes[i]);
+    }
+    for(int t = 0; t < MTHREADS; t++) {
+        for(int j = 0; j < MOWN; j++) {
+            my_node_init(&onodes[t][j]);
+            rb_value_m(&onodes[t][j]) = 2 * (j * MTHREADS + t) + 1;
+        }
+    }
+    for(int r = 0; r < 3; r++) {
+        reads = ratios[r];
+        printf("\"%d%% reads\"\n", reads);
+        for(threads = 1; threads <= MTHREADS; threads++) {
+            fprintf(stderr, "reads: %d%% threads: %d\n", reads, threads);
+            printf("%d %f\n", threads, run());
+        }
+        printf("\n\n");
+    }
+    return 0;
+}
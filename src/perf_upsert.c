@@ -0,0 +1,100 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+#include <math.h>
+
+#define MSIZE 10000000
+#define MSTEP 100000
+#define MKEYS 1000000
+
+node_t mnodes[MKEYS];
+int keys[MSIZE];
+
+int
+main(void)
+{
+    node_t* tree;
+    node_t* node;
+    node_t* existing;
+    node_t key;
+    my_slot_t slot;
+    int used;
+    clock_t start, end;
+    double cpu_time_used = 0.1;
+    (void)(cpu_time_used);
+    fprintf(stderr, "preheat: ");
+    for(int i = 0; i < 200000000; i++)
+        cpu_time_used = cpu_time_used * cpu_time_used;
+    fprintf(stderr, "%d\n", (int) cpu_time_used);
+    srand(42);
+    for(int i = 0; i < MSIZE; i++)
+        keys[i] = rand() % MKEYS;
+    /* Count the keys, a node is only used on a miss. */
+    fprintf(stderr, "rbtree_find_insert\n");
+    printf("\"rbtree_find_insert\"\n");
+    my_tree_init(&tree);
+    used = 0;
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        rb_value_m(&key) = keys[i];
+        if(my_find(tree, &key, &existing) == 0)
+            existing->color += 0;
+        else {
+            node = &mnodes[used++];
+            my_node_init(node);
+            rb_value_m(node) = keys[i];
+            my_insert(&tree, node);
+        }
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    fprintf(stderr, "rbtree_insert_or_get\n");
+    printf("\n\n\"rbtree_insert_or_get\"\n");
+    my_tree_init(&tree);
+    used = 0;
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        node = &mnodes[used];
+        my_node_init(node);
+        rb_value_m(node) = keys[i];
+        if(my_insert_or_get(&tree, node, &existing) == 0)
+            used += 1;
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    fprintf(stderr, "rbtree_find_slot\n");
+    printf("\n\n\"rbtree_find_slot\"\n");
+    my_tree_init(&tree);
+    used = 0;
+    cpu_time_used = 0;
+    start = clock();
+    for(int i = 0; i < MSIZE; i++) {
+        rb_value_m(&key) = keys[i];
+        if(my_find_slot(tree, &key, &existing, &slot) != 0) {
+            node = &mnodes[used++];
+            my_node_init(node);
+            rb_value_m(node) = keys[i];
+            my_insert_at_slot(&tree, &slot, node);
+        }
+        if(((i + 1) % MSTEP) == 0) {
+            end = clock();
+            cpu_time_used += (double) (end - start);
+            printf("%d %f\n", i, cpu_time_used);
+            start = clock();
+        }
+    }
+    printf("\n\n");
+    return 0;
+}
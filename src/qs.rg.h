@@ -270,12 +270,12 @@
     _qs_queue_bind_impl_tr_m(cx, type, qs_next_m)
 #enddef
 
-#begindef qs_queue_bind_cx_m((cx, type)
+#begindef qs_queue_bind_cx_m(cx, type)
     qs_queue_bind_decl_cx_m(cx, type)
     qs_queue_bind_impl_cx_m(cx, type)
 #enddef
 
-#begindef qs_queue_bind_impl_m(cx, type)
+#begindef qs_queue_bind_m(cx, type)
     qs_queue_bind_decl_m(cx, type)
     qs_queue_bind_impl_m(cx, type)
 #enddef
@@ -3,5 +3,20 @@
 char rb_err[1024];
 
 rb_bind_impl_m(my, node_t)
+rb_head_bind_impl_m(mh, my, node_t)
+rb_slab_bind_impl_m(my, node_t)
+rb_key_bind_impl_m(my, node_t, int)
+rb_frozen_int_bind_impl_m(my, node_t, int)
+rb_ts_bind_impl_m(my, node_t)
+rb_seq_bind_impl_m(my, node_t)
+rb_multi_bind_impl_m(mm, node_t)
+bt_bind_impl_m(mt, node_t, int)
+rb_compact_bind_impl_m(mc, cpnode_t)
+rb_child_bind_impl_m(mb, chnode_t)
+rb_os_bind_impl_m(mo, osnode_t)
+rb_aug_bind_impl_m(ma, augnode_t)
+rb_interval_bind_impl_m(mi, ivnode_t)
+rb_tagged_bind_impl_cx_m(mp, pknode_t)
+rb_pool_bind_impl_cx_m(mq, ixnode_t)
 
 qs_queue_bind_impl_m(qq, item_t)
@@ -14,6 +14,7 @@
 // ==============
 //
 // * Bonus: `qs.h`_ (Queue / Stack)
+// * Bonus: `btree.h`_ (B+ tree with the same API)
 // * Textbook implementation
 // * Extensive tests
 // * Has parent pointers and therefore faster delete_node and constant time
@@ -38,6 +39,8 @@
 //
 // .. _`qs.h`: https://github.com/ganwell/rbtree/blob/master/qs.rst
 //
+// .. _`btree.h`: https://github.com/ganwell/rbtree/blob/master/btree.rst
+//
 //
 // WORK IN PROGRESS
 // ================
@@ -206,6 +209,22 @@
 // The *key* is just another node, we don't have to initialize it, but only set
 // the fields used by the comparator. bk_find will set *book* to the node found.
 //
+// For a large node this is a large copy on the stack for every lookup. If we
+// tell rbtree how to get and compare the keys, we can look up the bare ISBN.
+//
+// .. code-block:: cpp
+//
+//    #define bk_key_m(x) (x)->isbn
+//    #define bk_key_cmp_m(x, y) memcmp(x, y, 13)
+//    rb_key_bind_decl_m(bk, book_t, const char*)
+//
+//    rb_key_bind_impl_m(bk, book_t, const char*)
+//
+//    bk_find_key(tree, isbn, &book);
+//
+// The key comparator has to order like bk_cmp_m. rb_key_bind_m adds
+// bk_find_key, bk_lower_bound_key and bk_delete_key to the context.
+//
 // We can also iterate over the tree, the result will be sorted, lesser element
 // first. The tree may not be modified during iteration.
 //
@@ -228,15 +247,22 @@
 //        free(book);
 //    }
 //
-// But we cannot use the iterator. Therefore we just remove the root till the
-// tree is empty.
+// But we cannot use the iterator to remove all books. bk_clear visits every
+// node once, resets it and passes it to the callback. It doesn't rebalance, so
+// it is O(N).
 //
 // .. code-block:: cpp
 //
-//    while(tree != bk_nil_ptr) {
-//        remove_book(tree);
+//    void
+//    free_book(book_t* book, void* ctx)
+//    {
+//        (void)(ctx);
+//        printf("Removing %s\n", book->isbn);
+//        free(book);
 //    }
 //
+//    bk_clear(&tree, free_book, NULL);
+//
 // API
 // ---
 //
@@ -269,6 +295,32 @@
 //    Insert *node* into *tree*. If a node with the same key exists the
 //    function returns 1 and *node* is not inserted, 0 on success.
 //
+// cx##_insert_hint(type** tree, type* hint, type* node)
+//    Same as cx##_insert, but the search starts at the node *hint* in *tree*.
+//    If *node* is inserted close to *hint*, for example next to the last
+//    inserted node, this costs O(log(d)) in the distance d instead of
+//    O(log(N)). If *hint* is *cx##_nil_ptr* the search starts at the root.
+//
+// cx##_append(type** tree, type* last, type* node)
+//    Same as cx##_insert, but *last* has to be the greatest node of *tree*.
+//    If *node* is greater than *last*, it is linked as its right child
+//    without a search, which is amortized O(1). Otherwise *last* is used as
+//    hint. If *tree* is empty *last* is *cx##_nil_ptr*.
+//
+// cx##_insert_or_get(type** tree, type* node, type** existing)
+//    Same as cx##_insert, but if a node with the same key exists, it is
+//    returned in *existing* from the same descent. Returns 1 in that case,
+//    otherwise 0 and *existing* is *node*.
+//
+// cx##_find_slot(type* tree, type* key, type** node, cx##_slot_t* slot)
+//    Same as cx##_find, but if *key* is not found *slot* is set to the
+//    position where it would be inserted. This allows to create the node only
+//    after a miss.
+//
+// cx##_insert_at_slot(type** tree, cx##_slot_t* slot, type* node)
+//    Insert *node* at *slot* without a search. *node* has to be equal to the
+//    key passed to cx##_find_slot and *tree* must not be modified in between.
+//
 // cx##_delete_node(type** tree, type* node)
 //    Delete the known *node* from *tree*.
 //
@@ -291,10 +343,63 @@
 //    the tree *node* will not be assigned and the function returns 1, 0 on
 //    success.
 //
+// cx##_find_batch(type* tree, type** keys, size_t n, type** out)
+//    Find the nodes for the *n* keys in *keys* and set them in *out*, nil if a
+//    key was not found. The lookups run interleaved with prefetching, so their
+//    cache misses overlap. Returns the number of keys found.
+//
+// cx##_lower_bound(type* tree, type* key, type** node)
+//    Find the least node that is not less than *key* and assign it to *node*.
+//    If there is no such node *node* will be set to *cx##_nil_ptr* and the
+//    function returns 1, 0 on success.
+//
+// cx##_upper_bound(type* tree, type* key, type** node)
+//    Same as cx##_lower_bound, but find the least node that is greater than
+//    *key*.
+//
+// cx##_floor(type* tree, type* key, type** node)
+//    Same as cx##_lower_bound, but find the greatest node that is not greater
+//    than *key*.
+//
+// cx##_ceil(type* tree, type* key, type** node)
+//    Same as cx##_lower_bound, but named as counterpart of cx##_floor.
+//
+// cx##_build_sorted(type** tree, type** nodes, size_t n)
+//    Build *tree* from the array *nodes* of *n* nodes in O(N) without any
+//    comparison. *nodes* has to be sorted by the comparator and may not
+//    contain equal nodes. *tree* has to be empty, the nodes have not to be
+//    initialized.
+//
+// cx##_split(type** tree, type* key, type** rtree)
+//    Move the nodes of *tree* that are not less than *key* to the empty tree
+//    *rtree*. *tree* keeps the nodes that are less than *key*. O(log(N)).
+//
+// cx##_join(type** tree, type** rtree)
+//    Move all nodes of *rtree* to *tree*. All nodes of *rtree* have to be
+//    greater than the nodes of *tree*. *rtree* will be empty. O(log(N)).
+//
+// cx##_union(type** tree, type** other, type** rest)
+//    Move all nodes of *other* to *tree*. If a node of *other* is equal to a
+//    node of *tree*, it is moved to the empty tree *rest* instead.
+//    O(m log(n/m + 1)) for trees of the sizes m <= n.
+//
+// cx##_intersect(type** tree, type** other, type** rest)
+//    Move the nodes of *tree* that are not equal to a node of *other* to the
+//    empty tree *rest*. *other* keeps its nodes. O(m log(n/m + 1)).
+//
+// cx##_difference(type** tree, type** other, type** rest)
+//    Move the nodes of *tree* that are equal to a node of *other* to the empty
+//    tree *rest*. *other* keeps its nodes. O(m log(n/m + 1)).
+//
+// cx##_clear(type** tree, void (*callback)(type* node, void* ctx), void* ctx)
+//    Remove all nodes from *tree* without rebalancing. Every node is reset
+//    like cx##_node_init and then passed to *callback* with *ctx*, so the
+//    callback may free it. *callback* may be NULL. O(N).
+//
 // cx##_size(type* tree)
 //    Returns the size of tree. By default RB_SIZE_T is int to avoid additional
-//    dependencies. Feel free to define RB_SIZE_T as size_t for example. O(log
-//    (N)).
+//    dependencies. Feel free to define RB_SIZE_T as size_t for example. O(N),
+//    use a tree head (see below) if you need the size often.
 //
 // rb_iter_decl_m(cx, iter, elem)
 //    Declares the variables *iter* and *elem* for the context *cx*.
@@ -308,10 +413,624 @@
 //    Move *elem* to the next element in the tree. *elem* will point to
 //    NULL at the end.
 //
+// cx##_iter_init_last(type* tree, cx##_iter_t* iter, type** elem)
+//    Initializes *elem* to point to the last element in tree. If the tree is
+//    empty *elem* will be NULL.
+//
+// cx##_iter_prev(cx##_iter_t* iter, type** elem)
+//    Move *elem* to the previous element in the tree. *elem* will point to
+//    NULL at the beginning. iter_next and iter_prev can be mixed.
+//
+// cx##_range_init(type* tree, type* start, type* end, cx##_iter_t* iter,
+// type** elem)
+//    Initializes *elem* to point to the least element that is not less than
+//    *start*. The element after the range is stored in *iter*, so
+//    cx##_range_next needs no comparison. If no element is in the range
+//    [*start*, *end*] *elem* will be NULL. O(log(N)).
+//
+// cx##_range_next(cx##_iter_t* iter, type** elem)
+//    Move *elem* to the next element in the range. *elem* will point to NULL
+//    after *end*.
+//
+// rb_for_reverse_m(cx, tree, iter, elem)
+//    Same as rb_for_m, but from the last to the first element.
+//
+// rb_for_range_m(cx, tree, start, end, iter, elem)
+//    Same as rb_for_m, but only for the elements in the range [*start*,
+//    *end*]. It only visits the k elements in the range: O(log(N) + k).
+//
+// .. code-block:: cpp
+//
+//    book_t from;
+//    book_t to;
+//    memcpy(from.isbn, "9780000000000", 14);
+//    memcpy(to.isbn, "9780999999999", 14);
+//    rb_iter_decl_m(bk, bk_iter, bk_elem);
+//    rb_for_range_m(bk, tree, &from, &to, bk_iter, bk_elem) {
+//        printf("%s\n", bk_elem->isbn);
+//    }
+//
 // cx##_check_tree(type* tree)
 //    Check the consistency of a tree. Only interesting for development of
 //    rbtree itself. If will fail with an assert if there is an inconsistency.
 //
+// Tree head
+// ---------
+//
+// A bare root pointer is enough for most uses, but it can't answer size, first
+// and last in constant time. A tree head keeps the root, the number of nodes
+// and the first and last node. The head functions are bound to a second
+// context *hcx*, that uses the functions of *cx*.
+//
+// .. code-block:: cpp
+//
+//    rb_bind_decl_m(bk, book_t)
+//    rb_head_bind_decl_m(bh, bk, book_t)
+//
+// .. code-block:: cpp
+//
+//    rb_bind_impl_m(bk, book_t)
+//    rb_head_bind_impl_m(bh, bk, book_t)
+//    bh_tree_t catalog;
+//
+// rb_head_bind_decl_m(hcx, cx, type)
+//    Bind the tree head function declarations for *type* to *hcx*, using the
+//    functions bound to *cx*.
+//
+// rb_head_bind_impl_m(hcx, cx, type)
+//    Bind the tree head function implementations for *type* to *hcx*. This
+//    variant uses the standard rb_*_m traits, rb_head_bind_impl_cx_m uses the
+//    cx##_*_m traits. *cx* has to be bound with rb_bind_m or rb_bind_cx_m,
+//    hcx##_insert links an appended node itself.
+//
+// Then the following functions will be available. They work like the
+// functions of *cx*, but take a pointer to the tree head.
+//
+// hcx##_tree_init(hcx##_tree_t* tree)
+//    Initialize the empty *tree* head.
+//
+// hcx##_insert(hcx##_tree_t* tree, type* node)
+//    Same as cx##_insert, but if *node* is greater than the last node, it is
+//    appended in amortized O(1) (see cx##_append). Inserting sorted or
+//    timestamp keys doesn't need a search.
+//
+// hcx##_node_init, hcx##_insert_hint, hcx##_delete_node, hcx##_delete,
+// hcx##_replace_node, hcx##_replace, hcx##_find, hcx##_lower_bound,
+// hcx##_upper_bound, hcx##_floor, hcx##_ceil, hcx##_build_sorted,
+// hcx##_clear
+//    Same as the *cx* functions, but they keep the tree head up to date.
+//
+// hcx##_size(hcx##_tree_t* tree)
+//    Returns the size of *tree*. O(1).
+//
+// hcx##_first(hcx##_tree_t* tree)
+//    Returns the least node in *tree* or *hcx##_nil_ptr* if it is empty. O(1).
+//
+// hcx##_last(hcx##_tree_t* tree)
+//    Returns the greatest node in *tree* or *hcx##_nil_ptr* if it is empty.
+//    O(1).
+//
+// hcx##_iter_init, hcx##_iter_next
+//    The iterator starts at the first node in O(1), so rb_for_m(hcx, &tree,
+//    iter, elem) can be used.
+//
+// hcx##_iter_init_last, hcx##_iter_prev, hcx##_range_init, hcx##_range_next
+//    The reverse iterator starts at the last node in O(1), so
+//    rb_for_reverse_m(hcx, &tree, iter, elem) and rb_for_range_m(hcx, &tree,
+//    start, end, iter, elem) can be used.
+//
+// hcx##_check_tree(hcx##_tree_t* tree)
+//    Check the consistency of the tree and the tree head.
+//
+// Threads
+// -------
+//
+// All trees of a context share the nil sentinel, but only cx##_tree_init
+// writes it. So different trees of one context can be modified by different
+// threads without locking, as long as cx##_tree_init isn't called
+// concurrently. Each tree still has to be used by one thread at a time.
+//
+// To share one tree between threads bind a thread-safe tree to *cx*. It keeps
+// the root and a reader-writer lock. Lookups and iteration take the lock
+// shared, all changes take it exclusive. The binding uses pthread_rwlock_t,
+// include pthread.h before binding it and link with -pthread.
+//
+// .. code-block:: cpp
+//
+//    rb_bind_m(bk, book_t)
+//    rb_ts_bind_m(bk, book_t)
+//
+//    bk_ts_t catalog;
+//    bk_ts_init(&catalog);
+//    bk_ts_insert(&catalog, book);
+//    rb_iter_decl_cx_m(bk, iter, elem);
+//    rb_ts_for_m(bk, &catalog, iter, elem) {
+//        printf("%s\n", elem->isbn);
+//    }
+//
+// rb_ts_bind_decl_m(cx, type)
+//    Bind the thread-safe function declarations for *type* to *cx*.
+//
+// rb_ts_bind_impl_m(cx, type)
+//    Bind the thread-safe function implementations for *type* to *cx*. They
+//    call the functions bound to *cx*, so the traits don't matter.
+//
+// cx##_ts_init(cx##_ts_t* ts)
+//    Initialize the empty tree and the lock. Returns the error of
+//    pthread_rwlock_init, 0 on success.
+//
+// cx##_ts_destroy(cx##_ts_t* ts)
+//    Destroy the lock. Use cx##_ts_clear before, if the tree is not empty.
+//
+// cx##_ts_insert, cx##_ts_insert_or_get, cx##_ts_delete,
+// cx##_ts_delete_node, cx##_ts_replace, cx##_ts_clear
+//    Same as the *cx* functions, but they take the lock exclusive.
+//
+// cx##_ts_find, cx##_ts_lower_bound, cx##_ts_upper_bound, cx##_ts_floor,
+// cx##_ts_ceil, cx##_ts_size
+//    Same as the *cx* functions, but they take the lock shared. Other threads
+//    may delete the node found as soon as the function returns.
+//
+// cx##_ts_rdlock(cx##_ts_t* ts), cx##_ts_wrlock(cx##_ts_t* ts),
+// cx##_ts_unlock(cx##_ts_t* ts)
+//    Lock the tree to combine operations, for example a find and an update of
+//    the node found. Use the *cx* functions on ts->root while locked.
+//
+// rb_ts_for_m(cx, ts, iter, elem)
+//    Same as rb_for_m, but the tree is locked shared during the loop. A break
+//    in the loop releases the lock, return and goto don't.
+//
+// rb_ts_for_reverse_m(cx, ts, iter, elem)
+//    Same as rb_ts_for_m, but from the last to the first element.
+//
+// Even a shared lock writes the cache line of the lock, so readers on many
+// cores slow each other down. For read-mostly trees bind a sequence-locked
+// tree instead. Writers take a mutex and increment a sequence counter before
+// and after each change. Readers don't write anything: they search the tree
+// and retry if the counter was odd or has changed meanwhile.
+//
+// .. code-block:: cpp
+//
+//    rb_bind_m(bk, book_t)
+//    rb_seq_bind_m(bk, book_t)
+//
+//    bk_seq_t catalog;
+//    bk_seq_init(&catalog);
+//    bk_seq_insert(&catalog, book);
+//    bk_seq_find(&catalog, key, &book);
+//
+// A reader can follow a node that a writer just removed or rotated away,
+// so the rules are stricter than for the rwlock:
+//
+// * Removed nodes must stay readable while readers run. They can be reused,
+//   but not returned to the system. Nodes from slab.h are fine as long as
+//   the slab allocator isn't destroyed.
+// * The link fields of a reused node must be nil, NULL or a pointer to such a
+//   node, which is true for nodes from slab.h.
+// * The comparator must not crash on the key of a node that is being
+//   changed. Comparing values is fine, following pointers usually isn't.
+// * It needs the __atomic builtins of gcc or clang.
+//
+// rb_seq_bind_decl_m(cx, type)
+//    Bind the sequence-locked function declarations for *type* to *cx*.
+//
+// rb_seq_bind_impl_m(cx, type)
+//    Bind the sequence-locked function implementations for *type* to *cx*.
+//    This variant uses the standard rb_*_m traits, rb_seq_bind_impl_cx_m
+//    uses the cx##_*_m traits.
+//
+// cx##_seq_init(cx##_seq_t* seq)
+//    Initialize the empty tree, the counter and the mutex. Returns the error
+//    of pthread_mutex_init, 0 on success.
+//
+// cx##_seq_destroy(cx##_seq_t* seq)
+//    Destroy the mutex.
+//
+// cx##_seq_insert, cx##_seq_insert_or_get, cx##_seq_delete,
+// cx##_seq_delete_node, cx##_seq_replace, cx##_seq_clear
+//    Same as the *cx* functions, the writers are serialized by the mutex.
+//
+// cx##_seq_find, cx##_seq_lower_bound, cx##_seq_upper_bound,
+// cx##_seq_floor, cx##_seq_ceil
+//    Same as the *cx* functions, but lock-free. Other threads may delete the
+//    node found as soon as the function returns.
+//
+// cx##_seq_lock(cx##_seq_t* seq), cx##_seq_unlock(cx##_seq_t* seq)
+//    Start and end a change, to combine operations. Use the *cx* functions on
+//    a copy of seq->root while locked and store it back with
+//    __atomic_store_n(&seq->root, root, __ATOMIC_RELAXED), readers may load
+//    the root at any time.
+//
+// Tagged parent pointer
+// ---------------------
+//
+// Every node needs a color, which usually pads out to the size of a pointer.
+// The tagged binding stores the color in the low bit of the parent pointer
+// instead. Since the color and the parent trait are not lvalues anymore, you
+// have to define setters: cx##_color_m_set, cx##_parent_m_set,
+// cx##_left_m_set and cx##_right_m_set. rb_tag_*_m helps to write the traits.
+//
+// .. code-block:: cpp
+//
+//    struct pk_s {
+//        int       value;
+//        uintptr_t parent;
+//        pk_t*     left;
+//        pk_t*     right;
+//    };
+//
+//    #define pk_color_m(x) rb_tag_color_m((x)->parent)
+//    #define pk_color_m_set(x, c) rb_tag_set_color_m((x)->parent, c)
+//    #define pk_parent_m(x) rb_tag_ptr_m(pk_t, (x)->parent)
+//    #define pk_parent_m_set(x, p) rb_tag_set_ptr_m((x)->parent, p)
+//    #define pk_left_m(x) (x)->left
+//    #define pk_left_m_set(x, l) rb_lvalue_set_m(pk_left_m, x, l)
+//    #define pk_right_m(x) (x)->right
+//    #define pk_right_m_set(x, r) rb_lvalue_set_m(pk_right_m, x, r)
+//    #define pk_cmp_m(x, y) rb_safe_cmp_m((x)->value, (y)->value)
+//
+//    rb_tagged_bind_cx_m(pk, pk_t)
+//
+// rb_tagged_bind_decl_cx_m(context, type)
+//    Alias for rb_bind_decl_cx_m, since there are no additional functions.
+//
+// rb_tagged_bind_impl_cx_m(context, type)
+//    Bind the rbtree function implementations for *type* to *context*, using
+//    the cx##_*_m traits and the setters.
+//
+// All rbtree functions are available. rb_make_red_m and rb_make_black_m need
+// an lvalue color, with tagged traits use rb_tag_make_red_m((x)->parent),
+// rb_tag_make_black_m((x)->parent) or cx##_color_m_set(x, RB_RED) instead.
+//
+// Index pool
+// ----------
+//
+// On 64-bit machines the pointers of a node take 24 bytes. The pool binding
+// links the nodes by 32-bit indexes into a contiguous pool instead. The node
+// at index 0 is nil, so *cx##_nil_ptr* is the base of the pool. The traits
+// decode the indexes with rb_pool_ptr_m and encode them with rb_pool_idx_m,
+// like the tagged binding all traits need a setter. Like the tagged binding
+// the color can be stored in the top bit of the parent index, so the links
+// and the color take 12 bytes and the pool holds up to 2^31 nodes.
+//
+// .. code-block:: cpp
+//
+//    struct ix_s {
+//        int      value;
+//        uint32_t parent;
+//        uint32_t left;
+//        uint32_t right;
+//    };
+//
+//    #define ix_color_m(x) rb_pool_tag_color_m((x)->parent)
+//    #define ix_color_m_set(x, c) rb_pool_tag_set_color_m((x)->parent, c)
+//    #define ix_parent_m(x) rb_pool_tag_ptr_m(ix, (x)->parent)
+//    #define ix_parent_m_set(x, p) rb_pool_tag_set_ptr_m(ix, (x)->parent, p)
+//    #define ix_left_m(x) rb_pool_ptr_m(ix, (x)->left)
+//    #define ix_left_m_set(x, l) (x)->left = rb_pool_idx_m(ix, l)
+//    #define ix_right_m(x) rb_pool_ptr_m(ix, (x)->right)
+//    #define ix_right_m_set(x, r) (x)->right = rb_pool_idx_m(ix, r)
+//    #define ix_cmp_m(x, y) rb_safe_cmp_m((x)->value, (y)->value)
+//
+//    rb_pool_bind_cx_m(ix, ix_t)
+//
+//    ix_t* pool = malloc(count * sizeof(ix_t));
+//    ix_t* tree;
+//    ix_pool_init(pool);
+//    ix_tree_init(&tree);
+//    ix_node_init(&pool[1]);
+//    ix_insert(&tree, &pool[1]);
+//
+// All rbtree functions are available, there is a single pool per context.
+// Since the nodes only contain indexes the pool is relocatable: copy it,
+// remember the root as index and call cx##_pool_move.
+//
+// .. code-block:: cpp
+//
+//    uint32_t root = rb_pool_idx_m(ix, tree);
+//    pool = realloc(pool, 2 * count * sizeof(ix_t));
+//    ix_pool_move(pool);
+//    tree = rb_pool_ptr_m(ix, root);
+//
+// rb_pool_bind_decl_cx_m(context, type)
+//    Bind the rbtree function declarations for *type* to *context*.
+//
+// rb_pool_bind_impl_cx_m(context, type)
+//    Bind the rbtree function implementations for *type* to *context*.
+//
+// cx##_pool_init(type* pool)
+//    Use *pool* as the pool and initialize nil at index 0.
+//
+// cx##_pool_move(type* pool)
+//    Use *pool* as the pool, which contains a copy of the old pool.
+//
+// Multisets
+// ---------
+//
+// cx##_insert refuses equal nodes, so a tree with duplicate keys needs a
+// tiebreaker in the comparator. The multiset binding accepts equal nodes
+// instead, a new node is inserted after the equal nodes in the tree.
+//
+// .. code-block:: cpp
+//
+//    rb_multi_bind_m(ms, node_t)
+//
+//    node_t* first;
+//    node_t* last;
+//    ms_insert(&tree, node);
+//    if(ms_equal_range(tree, key, &first, &last) == 0) {
+//        ...
+//    }
+//
+// rb_multi_bind_cx_m uses the cx##_*_m traits and the setters, like the
+// tagged binding. cx##_tree_init, cx##_node_init, cx##_iter_*,
+// cx##_delete_node, cx##_delete, cx##_clear, cx##_find, cx##_lower_bound,
+// cx##_upper_bound, cx##_size and cx##_check_tree work like above,
+// cx##_insert always succeeds and returns nothing. cx##_find and cx##_delete
+// take any of the equal nodes.
+//
+// cx##_equal_range(type* tree, type* key, type** first, type** last)
+//    Set *first* and *last* to the first and the last node equal to *key*.
+//    Returns 1 and sets both to nil if there is none. O(log(N)).
+//
+// cx##_count_equal(type* tree, type* key)
+//    Returns the number of nodes equal to *key*. O(log(N) + k).
+//
+// cx##_delete_all_equal(type** tree, type* key, callback, ctx)
+//    Delete all nodes equal to *key*, each deleted node is passed to
+//    callback(node, ctx) if it isn't NULL. Returns the number of nodes
+//    deleted. We split off the nodes less than *key* and the nodes greater,
+//    clear the middle tree and join the outer trees again. O(log(N) + k).
+//
+// Frozen snapshots
+// ----------------
+//
+// A tree that is built once and then only queried can be frozen into a
+// sorted array in Eytzinger (BFS) order. The search in the array has no
+// branch on the keys and prefetches the next levels, so it is much faster
+// than cx##_find. It needs the key traits of rb_key_bind_m.
+//
+// .. code-block:: cpp
+//
+//    rb_frozen_bind_m(bk, book_t, const char*)
+//
+//    bk_frozen_t frozen;
+//    bk_freeze(tree, &frozen);
+//    bk_frozen_find(&frozen, isbn, &book);
+//    bk_frozen_free(&frozen);
+//
+// cx##_freeze(type* tree, cx##_frozen_t* frozen)
+//    Copy the keys and the nodes of *tree* into *frozen*. Returns 1 if the
+//    system is out of memory. The snapshot doesn't change with the tree. O(N).
+//
+// cx##_frozen_find(cx##_frozen_t* frozen, ktype key, type** node)
+//    Same as cx##_find_key. The node is the original node of the tree.
+//
+// cx##_frozen_lower_bound(cx##_frozen_t* frozen, ktype key, type** node)
+//    Same as cx##_lower_bound_key.
+//
+// cx##_frozen_free(cx##_frozen_t* frozen)
+//    Free the memory of the snapshot.
+//
+// rb_frozen_int_bind_m(cx, type, ktype) binds the same functions for int32_t
+// or int64_t keys in their natural order. Its search uses AVX2 or SSE if the
+// target has it. Define RB_FROZEN_SIMD before including rbtree.h to use it.
+//
+// Child arrays
+// ------------
+//
+// On random keys the step r > 0 ? left(x) : right(x) of a descent is a coin
+// flip for the branch predictor. If the children are an array, the child
+// binding loads child[r < 0] instead, which compiles to an indexed load.
+//
+// .. code-block:: cpp
+//
+//    struct ch_s {
+//        int    value;
+//        char   color;
+//        ch_t*  parent;
+//        ch_t*  child[2];
+//    };
+//
+//    #define ch_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
+//    rb_child_bind_m(ch, ch_t)
+//
+// rb_child_bind_m uses rb_child_m, rb_child_left_m (child[0]) and
+// rb_child_right_m (child[1]). cx##_tree_init, cx##_node_init, cx##_iter_*,
+// cx##_insert, cx##_delete_node, cx##_delete, cx##_clear, cx##_find,
+// cx##_lower_bound, cx##_upper_bound, cx##_size and cx##_check_tree work like
+// above. The rotations and fixups are the ones of the parent engine, the
+// mirrored cases are already written once and instantiated with left and
+// right switched.
+//
+// Compact trees
+// -------------
+//
+// Read-mostly indexes that never replace a known node don't need the parent
+// pointer. The compact engine drops the parent trait, it remembers the path
+// from the root on a bounded stack (RB_MAX_HEIGHT) and rebalances along it.
+//
+// .. code-block:: cpp
+//
+//    struct cp_s {
+//        int    value;
+//        char   color;
+//        cp_t*  left;
+//        cp_t*  right;
+//    };
+//
+//    #define cp_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
+//
+//    rb_compact_bind_m(cp, cp_t)
+//
+//    rb_compact_iter_decl_cx_m(cp, iter, elem);
+//    rb_for_m(cp, tree, iter, elem) {
+//        printf("%d\n", elem->value);
+//    }
+//
+// The iterator contains the stack, so it has to be declared with
+// rb_compact_iter_decl_cx_m. rb_compact_bind_cx_m uses the cx##_*_m traits
+// and needs the setters, like the tagged binding.
+//
+// cx##_tree_init, cx##_node_init, cx##_insert, cx##_delete, cx##_clear,
+// cx##_find, cx##_iter_init, cx##_iter_next, cx##_size and cx##_check_tree
+// work like above. cx##_delete_node(type** tree, type* node) searches the
+// path to *node* by its key, so it is O(log(N)) and *node* has to be in the
+// tree.
+//
+// Order statistics
+// ----------------
+//
+// If the nodes have a size field, the tree can keep the size of every
+// sub-tree up to date, which allows to find the n-th node and the rank of a
+// node in O(log(N)).
+//
+// .. code-block:: cpp
+//
+//    struct node_s {
+//        int       value;
+//        char      color;
+//        node_t*   parent;
+//        node_t*   left;
+//        node_t*   right;
+//        RB_SIZE_T size;
+//    };
+//
+// rb_os_bind_decl_m(context, type)
+//    Bind the rbtree function and the order statistics function declarations
+//    for *type* to *context*.
+//
+// rb_os_bind_impl_m(context, type)
+//    Bind the rbtree function and the order statistics function
+//    implementations for *type* to *context*. This variant uses the standard
+//    rb_*_m traits and rb_size_m. rb_os_bind_impl_cx_m uses the cx##_*_m traits
+//    and cx##_size_m.
+//
+// All the rbtree functions are available and additionally:
+//
+// cx##_size(type* tree)
+//    Returns the stored size of the root of *tree*, or 0 for an empty tree.
+//    It replaces the recursive cx##_size of the plain binding. O(1).
+//
+// cx##_rank(type* tree, type* key)
+//    Returns the number of nodes in *tree* that are less than *key*. If *key*
+//    is in the tree, this is its zero-based position.
+//
+// cx##_rank_node(type* node)
+//    Returns the zero-based position of the known *node* in its tree.
+//
+// cx##_select(type* tree, RB_SIZE_T index, type** node)
+//    Find the node at the zero-based position *index* and assign it to *node*.
+//    If *index* is out of range *node* will be set to *cx##_nil_ptr* and the
+//    function returns 1, 0 on success.
+//
+// cx##_iter_skip(cx##_iter_t* iter, type** elem, RB_SIZE_T count)
+//    Move *elem* *count* elements forward. *elem* will point to NULL if it
+//    moves past the end.
+//
+// The size of a tree is the size of its root node: size(tree). The size of
+// *cx##_nil_ptr* is always zero.
+//
+// Augmented trees
+// ---------------
+//
+// Order statistics are a special case of an augmented tree. Any aggregate of a
+// sub-tree, that can be computed from the node and the aggregates of its
+// children, can be kept up to date. For example the maximum end of a sub-tree of
+// time ranges:
+//
+// .. code-block:: cpp
+//
+//    #define ev_cmp_m(x, y) rb_safe_cmp_m((x)->start, (y)->start)
+//    #define ev_augment_m(x) ev_augment(x)
+//    rb_aug_bind_decl_m(ev, event_t)
+//
+//    static
+//    void
+//    ev_augment(event_t* x)
+//    {
+//        x->max = x->end;
+//        if(x->left != ev_nil_ptr && x->left->max > x->max)
+//            x->max = x->left->max;
+//        if(x->right != ev_nil_ptr && x->right->max > x->max)
+//            x->max = x->right->max;
+//    }
+//    rb_aug_bind_impl_m(ev, event_t)
+//
+// The children of *x* might be *cx##_nil_ptr*. cx##_augment_m is called for
+// every node on the changed path after insert, delete_node, replace_node and
+// for the nodes of every rotation. This costs O(log(N)) per update. The
+// rbtree functions are the same as with rb_bind_m. Without augmentation nothing
+// is called, so the rbtree functions don't get slower.
+//
+// rb_aug_bind_decl_m(context, type)
+//    Alias for rb_bind_decl_m, since there are no additional functions.
+//
+// rb_aug_bind_impl_m(context, type)
+//    Bind the rbtree function implementations for *type* to *context*, calling
+//    cx##_augment_m. This variant uses the standard rb_*_m traits.
+//    rb_aug_bind_impl_cx_m uses the cx##_*_m traits.
+//
+// If you need both, order statistics and your own aggregate, bind with
+// rb_aug_bind_m and update the size in cx##_augment_m.
+//
+// Interval trees
+// --------------
+//
+// An interval tree stores closed intervals [start, end] ordered by start and
+// keeps the maximal end of every sub-tree. The comparator has to order by
+// start first, ties can be broken by end or any other field, since equal nodes
+// are not inserted.
+//
+// .. code-block:: cpp
+//
+//    struct event_s {
+//        int      start;
+//        int      end;
+//        char     color;
+//        event_t* parent;
+//        event_t* left;
+//        event_t* right;
+//        int      max;
+//    };
+//
+// rb_interval_bind_decl_m(context, type)
+//    Bind the rbtree function and the interval function declarations for
+//    *type* to *context*.
+//
+// rb_interval_bind_impl_m(context, type)
+//    Bind the rbtree function and the interval function implementations for
+//    *type* to *context*. This variant uses the standard rb_*_m traits and
+//    rb_start_m, rb_end_m, rb_max_m. rb_interval_bind_impl_cx_m uses the
+//    cx##_*_m traits and cx##_start_m, cx##_end_m, cx##_max_m.
+//
+// All the rbtree functions are available and additionally:
+//
+// cx##_overlap_first(type* tree, type* key, type** elem)
+//    Initializes *elem* to point to the first interval in *tree*, that
+//    overlaps the interval of *key*. *elem* will be NULL if there is none.
+//
+// cx##_overlap_next(type* key, type** elem)
+//    Move *elem* to the next interval that overlaps the interval of *key*.
+//    *elem* will point to NULL at the end.
+//
+// cx##_stab_first(type* tree, type* key, type** elem), cx##_stab_next(type*
+// key, type** elem)
+//    Same as overlap, but only the start of *key* is used: the intervals that
+//    contain the point start(key).
+//
+// Each interval is found in O(log(N)), unlike a scan with rb_for_m, the
+// sub-trees that end before the start of *key* are skipped. The intervals are
+// returned in tree order. rb_for_overlap_m and rb_for_stab_m generate a
+// for-loop-header.
+//
+// .. code-block:: cpp
+//
+//    event_t* elem;
+//    rb_for_overlap_m(ev, tree, &key, elem) {
+//        printf("%d %d\n", elem->start, elem->end);
+//    }
+//
 // Extended
 // --------
 //
@@ -433,6 +1152,65 @@
 // Because we have parent pointer we can implement replace_node in constant
 // time O(1). With sglib we have to add/remove for a replacement.
 //
+// perf_parallel deletes one tree per thread, all trees use the same context.
+// Since nil is never written, the threads share no cache line and the time
+// should stay flat up to the number of cores.
+//
+// perf_insert and perf_delete also measure the compact engine. Its test node
+// is 24 instead of 32 bytes, it inserts faster than the parent engine and
+// deletes by key about as fast as sglib.
+//
+// perf_slab compares nodes from malloc, scattered between other allocations,
+// with nodes from the slab allocator in slab.h, for insert and find and for
+// delete_node and free. See `slab.rst`_.
+//
+// .. _`slab.rst`: https://github.com/ganwell/rbtree/blob/master/slab.rst
+//
+// perf_clear compares removing the root till the tree is empty with
+// cx##_clear. For 10M nodes clear is about five times faster.
+//
+// perf_upsert counts 10M random keys out of 1M. cx##_insert_or_get and
+// cx##_find_slot save the second descent on a miss, on a hit they cost the
+// same as cx##_find.
+//
+// perf_batch looks up 2M random keys in a tree of 10M nodes and reports
+// lookups per second by batch size. With a batch of RB_BATCH (16) lookups
+// cx##_find_batch is about seven times faster than the cx##_find loop,
+// batches larger than RB_BATCH don't help.
+//
+// perf_child compares the left/right layout with the child binding. Random
+// lookups in 10M nodes are about a third faster with the child array, insert
+// is about the same. It also prints the branch misses of the lookups, if the
+// kernel allows perf_event_open, otherwise -1.
+//
+// perf_frozen compares cx##_find_key with cx##_frozen_find for trees of 1K
+// to 10M nodes. The snapshot is about three times faster for small trees
+// and about five times faster for 10M nodes, where the tree misses the cache
+// on almost every level.
+//
+// perf_insert, perf_delete and perf_frozen also measure the B-tree in
+// btree.h with the default node of 256 bytes. For 10M nodes it inserts and
+// deletes by key about twice as fast as rbtree and finds keys about twice as
+// fast. For small trees that fit the cache rbtree finds keys faster. Use
+// rbtree for intrusive nodes, stable node pointers, augmented trees and many
+// small trees, the B-tree for large sets of small keys. See `btree.rst`_.
+//
+// .. _`btree.rst`: https://github.com/ganwell/rbtree/blob/master/btree.rst
+//
+// perf_ts runs 2M operations on one thread-safe tree of 1M nodes, split
+// between 1 to 8 threads, with 100%, 90% and 50% finds. The other operations
+// insert or delete nodes owned by the thread. Readers scale with the cores
+// as long as there are no writers, each write serializes all threads.
+//
+// perf_seq compares lookups in one tree of 1M nodes by 1 to 64 reader
+// threads, using the rwlock or the seqlock, without and with one writer. On
+// a single core the seqlock readers are about 50% faster without a writer,
+// since they do no atomic read-modify-write. On more cores the rwlock readers
+// also wait for the cache line of the lock, the seqlock readers don't. If
+// there are more threads than cores, a reader that finds a preempted writer
+// has to yield. So the seqlock is meant for read-mostly trees with writers
+// that are not starved of cores.
+//
 // Code size
 // =========
 //
@@ -520,14 +1298,50 @@
 //
 // RB_SIZE_T can be defined by the user to use size_t for example.
 //
+// RB_MAX_HEIGHT is the maximal height of a tree. The height of a red-black
+// tree is at most 2 * log2(N + 1), so 128 is enough for any tree that fits
+// into memory. It is used by functions that need a stack.
+//
+// RB_BATCH is the number of lookups cx##_find_batch advances in lock-step.
+// rb_prefetch_m(x) prefetches a node, it does nothing on compilers without
+// __builtin_prefetch.
+//
+// If RB_PTHREAD is defined the set operations run the recursive halves in
+// threads, up to a depth of RB_PAR_DEPTH (2^RB_PAR_DEPTH threads). Sub-trees
+// with a black height below RB_PAR_BH (about 2^RB_PAR_BH nodes) are always
+// done in the current thread.
+//
 // .. code-block:: cpp
 //
 #ifndef rb_tree_h
 #define rb_tree_h
 #include <assert.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
 #ifndef RB_SIZE_T
 #   define RB_SIZE_T int
 #endif
+#ifndef RB_MAX_HEIGHT
+#   define RB_MAX_HEIGHT 128
+#endif
+#ifndef RB_BATCH
+#   define RB_BATCH 16
+#endif
+#if defined(__GNUC__) || defined(__clang__)
+#   define rb_prefetch_m(x) __builtin_prefetch(x)
+#else
+#   define rb_prefetch_m(x) (void)(x)
+#endif
+#ifdef RB_PTHREAD
+#   include <pthread.h>
+#endif
+#ifndef RB_PAR_DEPTH
+#   define RB_PAR_DEPTH 4
+#endif
+#ifndef RB_PAR_BH
+#   define RB_PAR_BH 8
+#endif
 //
 // Basic traits
 // ============
@@ -541,6 +1355,13 @@
 #define rb_left_m(x) (x)->left
 #define rb_right_m(x) (x)->right
 #define rb_value_m(x) (x)->value
+#define rb_size_m(x) (x)->size
+#define rb_start_m(x) (x)->start
+#define rb_end_m(x) (x)->end
+#define rb_max_m(x) (x)->max
+#define rb_child_m(x) (x)->child
+#define rb_child_left_m(x) (x)->child[0]
+#define rb_child_right_m(x) (x)->child[1]
 //
 // Context creation
 // ================
@@ -636,58 +1457,190 @@
 #define rb_make_black_m(x) x = RB_BLACK
 #define rb_make_red_m(x)   x = RB_RED
 
-// API
-// ===
+// Setters
+// =======
 //
-// Functions that are part of the API. The standard arguments are documented
-// once:
-//
-// type
-//    The type of the nodes in the red-black tree.
-//
-// nil
-//    A pointer to the nil object.
+// The rbtree functions write the color, parent, left and right through a
+// setter: set(color, x, RB_RED). rb_lvalue_set_m assigns to the trait, it is
+// used by the standard bindings. rb_trait_set_m calls trait##_set, so the
+// traits don't have to be lvalues.
 //
-// color
-//    The color trait of the nodes in the rbtree.
+// .. code-block:: cpp
 //
-// parent
-//    The parent trait of the nodes in the rbtree is a pointer back to the
-//    parent node.
+#define rb_lvalue_set_m(trait, x, v) trait(x) = (v)
+#define rb_trait_set_m(trait, x, v) trait##_set(x, v)
+
+// Tagged parent pointer
+// ---------------------
 //
-// left
-//    The left trait of the nodes in the rbtree is a pointer to the left branch
-//    of the node.
+// Store the color in the low bit of the parent pointer. *tag* is an uintptr_t
+// field of the node. The nodes have to be aligned to at least 2 bytes, which
+// every node containing a pointer is.
+// rb_tag_make_red_m and rb_tag_make_black_m are rb_make_red_m and
+// rb_make_black_m for the tagged field.
 //
-// right
-//    The right trait of the nodes in the rbtree is a pointer to the right
-//    branch of the node.
+// .. code-block:: cpp
 //
-// rb_node_init_m
-// --------------
+#define rb_tag_color_m(tag) ((char) ((tag) & 1))
+#define rb_tag_ptr_m(type, tag) ((type*) ((tag) & ~(uintptr_t) 1))
+
+#begindef rb_tag_set_color_m(tag, c)
+    (tag) = ((tag) & ~(uintptr_t) 1) | (uintptr_t) (c)
+#enddef
+
+#begindef rb_tag_set_ptr_m(tag, p)
+    (tag) = (uintptr_t) (p) | ((tag) & 1)
+#enddef
+
+#define rb_tag_make_black_m(tag) rb_tag_set_color_m(tag, RB_BLACK)
+#define rb_tag_make_red_m(tag)   rb_tag_set_color_m(tag, RB_RED)
+
+// Index pool
+// ----------
 //
-// Bound: cx##_node_init
+// Convert between the index *i* and the pointer *x* of a node in the pool of
+// the pool context *cx*.
 //
-// Initializes a node by setting the color to black and all pointers to nil.
+// .. code-block:: cpp
 //
-// node
-//    The node to initialize.
+#define rb_pool_ptr_m(cx, i) (cx##_nil_ptr + (i))
+#define rb_pool_idx_m(cx, x) ((uint32_t) ((x) - cx##_nil_ptr))
+
+// Store the color in the top bit of the parent index *tag*, an uint32_t field
+// of the node.
 //
 // .. code-block:: cpp
 //
-#begindef rb_node_init_m(
-        nil,
-        color,
+#define rb_pool_tag_color_m(tag) ((char) ((tag) >> 31))
+#define rb_pool_tag_ptr_m(cx, tag) rb_pool_ptr_m(cx, (tag) & 0x7fffffffu)
+
+#begindef rb_pool_tag_set_color_m(tag, c)
+    (tag) = ((tag) & 0x7fffffffu) | ((uint32_t) (c) << 31)
+#enddef
+
+#begindef rb_pool_tag_set_ptr_m(cx, tag, p)
+    (tag) = rb_pool_idx_m(cx, p) | ((tag) & 0x80000000u)
+#enddef
+
+// Augmentation
+// ============
+//
+// A tree can keep an aggregate of each sub-tree in its nodes, for example the
+// size of the sub-tree. The macros take an augment trait, augment(node, stop)
+// has to recompute the aggregate of node and its ancestors till it reaches
+// stop (exclusive). Since the aggregate of a node only depends on its
+// sub-trees, it is called after the sub-trees of a node changed: on the path
+// from a changed position to the root and for the two nodes of a rotation.
+// This costs O(log(N)) per update.
+//
+// rb_no_augment_m is used if a tree has no aggregates, it expands to nothing.
+//
+// .. code-block:: cpp
+//
+#define rb_no_augment_m(node, stop)
+
+// rb_augment_path_m
+// -----------------
+//
+// Creates an augment trait from an update macro: walks from *node* to *stop*
+// (exclusive) and updates every node on the way.
+//
+// update
+//    Recomputes the aggregate of a single node from its children.
+//
+// node
+//    The first node to update. This variable is modified.
+//
+// stop
+//    The node to stop at.
+//
+// .. code-block:: cpp
+//
+#begindef rb_augment_path_m(parent, update, node, stop)
+{
+    while(node != stop) {
+        update(node);
+        node = parent(node);
+    }
+}
+#enddef
+
+// API
+// ===
+//
+// Functions that are part of the API. The standard arguments are documented
+// once:
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// nil
+//    A pointer to the nil object.
+//
+// color
+//    The color trait of the nodes in the rbtree.
+//
+// parent
+//    The parent trait of the nodes in the rbtree is a pointer back to the
+//    parent node.
+//
+// left
+//    The left trait of the nodes in the rbtree is a pointer to the left branch
+//    of the node.
+//
+// right
+//    The right trait of the nodes in the rbtree is a pointer to the right
+//    branch of the node.
+//
+// augment
+//    The augment trait recomputes the aggregates of the path from a node to
+//    an ancestor (see Augmentation), rb_no_augment_m if there are none.
+//
+// rb_node_init_m
+// --------------
+//
+// Bound: cx##_node_init
+//
+// Initializes a node by setting the color to black and all pointers to nil.
+//
+// node
+//    The node to initialize.
+//
+// .. code-block:: cpp
+//
+#begindef rb_node_init_m(
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        node
+)
+    _rb_node_init_m(
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        rb_lvalue_set_m,
+        node
+    )
+#enddef
+
+#begindef _rb_node_init_m(
+        nil,
+        color,
         parent,
         left,
         right,
+        set,
         node
 )
 {
-    color(node) = RB_BLACK;
-    parent(node) = nil;
-    left(node) = nil;
-    right(node) = nil;
+    set(color, node, RB_BLACK);
+    set(parent, node, nil);
+    set(left, node, nil);
+    set(right, node, nil);
 }
 #enddef
 
@@ -712,6 +1665,44 @@
     )
 #enddef
 
+// rb_for_reverse_m
+// ----------------
+//
+// Generates a for-loop-header using the iterator, from the last to the first
+// element.
+//
+// .. code-block:: cpp
+//
+#begindef rb_for_reverse_m(cx, tree, iter, elem)
+    for(
+            cx##_iter_init_last(tree, &iter, &elem);
+            elem != NULL;
+            cx##_iter_prev(iter, &elem)
+    )
+#enddef
+
+// rb_for_range_m
+// --------------
+//
+// Generates a for-loop-header using the range iterator. The elements from
+// *start* to *end* (inclusive) are visited.
+//
+// start
+//    The node used as first key.
+//
+// end
+//    The node used as last key.
+//
+// .. code-block:: cpp
+//
+#begindef rb_for_range_m(cx, tree, start, end, iter, elem)
+    for(
+            cx##_range_init(tree, start, end, &iter, &elem);
+            elem != NULL;
+            cx##_range_next(iter, &elem)
+    )
+#enddef
+
 // rb_iter_decl_m
 // ---------------
 //
@@ -866,6 +1857,8 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         cmp,
         tree,
         node,
@@ -884,7 +1877,8 @@ do {
     );
     if(tree == nil) {
         tree = node;
-        rb_make_black_m(color(tree));
+        set(color, tree, RB_BLACK);
+        augment(node, nil);
         break;
     } else {
         assert((
@@ -892,7 +1886,45 @@ do {
             rb_is_black_m(color(tree))
         ) && "Tree is not root");
     }
-    c = tree;
+    _rb_insert_from_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        cmp,
+        tree,
+        tree,
+        node,
+        c,
+        p,
+        r
+    );
+} while(0);
+#enddef
+
+#begindef _rb_insert_from_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        cmp,
+        tree,
+        start,
+        node,
+        c, /* current */
+        p, /* parent */
+        r  /* result */
+)
+do {
+    c = start;
     p = NULL;
     r = 0;
     while(c != nil) {
@@ -907,14 +1939,47 @@ do {
     /* The node is already in the rbtree, we break. */
     if(c != nil)
         break;
+    _rb_insert_link_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        tree,
+        p,
+        r,
+        node
+    );
+} while(0);
+#enddef
 
-    parent(node) = p;
-    rb_make_red_m(color(node));
+#begindef _rb_insert_link_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        tree,
+        p,
+        r,
+        node
+)
+{
+    set(parent, node, p);
+    set(color, node, RB_RED);
 
     if(r > 0)
-        left(p) = node;
+        set(left, p, node);
     else
-        right(p) = node;
+        set(right, p, node);
+    /* Update the path from the new node to the root. */
+    augment(node, nil);
 
     _rb_insert_fix_m(
             type,
@@ -923,10 +1988,12 @@ do {
             parent,
             left,
             right,
+            set,
+            augment,
             tree,
             node
     );
-} while(0);
+}
 #enddef
 
 #begindef rb_insert_m(
@@ -936,6 +2003,8 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         cmp,
         tree,
         node
@@ -951,6 +2020,8 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         cmp,
         tree,
         node,
@@ -961,127 +2032,370 @@ do {
 }
 #enddef
 
-// rb_delete_node_m
-// ----------------
-//
-// Bound: cx##_delete_node
-//
-// Delete a node from the tree. This function acts on an actual tree
-// node. If you don't have it; use rb_find_m first or rb_delete_m. The root node
-// (*tree*) can change.
+// rb_multi_insert_m
+// -----------------
 //
-// tree
-//    The root node of the tree. A pointer to nil represents an empty tree.
+// Bound: cx##_insert of the multiset binding
 //
-// node
-//    The node to delete.
+// Like rb_insert_m, but an equal node is no reason to stop. We continue on
+// the right, so the new node is inserted after the equal nodes in the tree
+// and the order of equal nodes is the order of insertion.
 //
 // .. code-block:: cpp
 //
-#begindef _rb_delete_node_m(
+#begindef rb_multi_insert_m(
         type,
         nil,
         color,
         parent,
         left,
         right,
+        set,
+        augment,
+        cmp,
         tree,
-        node,
-        x,
-        y
+        node
 )
 {
-    assert(tree != nil && "Cannot remove node from empty tree");
-    assert(node != nil && "Cannot delete nil node");
-    assert((
-        parent(node) != nil ||
-        left(node) != nil ||
-        right(node) != nil ||
-        rb_is_black_m(color(node))
-    ) && "Node is not in a tree");
-    if(left(node) == nil || right(node) == nil)
-        /* This node has at least one nil node, delete is simple. */
-        y = node;
-    else {
-        /* We need to find another node for deletion that has only one child.
-         * This is tree-next. */
-        y = right(node);
-        while(left(y) != nil)
-            y = left(y);
-    }
-
-    /* If y has a child we have to attach it to the parent. */
-    if(left(y) != nil)
-        x = left(y);
-    else
-        x = right(y);
-
-    /* Remove y from the tree. */
-    parent(x) = parent(y);
-    if(parent(y) != nil) {
-        if(y == left(parent(y)))
-            left(parent(y)) = x;
-        else
-            right(parent(y)) = x;
-    } else
-        tree = x;
-
-    /* A black node was removed, to fix the problem we pretend to have pushed the
-     * blackness onto x. Therefore x is double black and violates property 1. */
-    if(rb_is_black_m(color(y))) {
-        _rb_delete_fix_m(
-                type,
-                nil,
-                color,
-                parent,
-                left,
-                right,
-                tree,
-                x
-        );
-    }
-
-    /* Replace y with the node since we don't control memory. */
-    if(node != y) {
-        if(parent(node) == nil) {
-            tree = y;
-            parent(y) = nil;
-        } else {
-            if(node == left(parent(node)))
-                left(parent(node)) = y;
-            else if(node == right(parent(node)))
-                right(parent(node)) = y;
+    type* __rb_mins_c_;
+    type* __rb_mins_p_;
+    int   __rb_mins_r_;
+    assert(node != nil && "Cannot insert nil node");
+    assert(
+        parent(node) == nil &&
+        left(node) == nil &&
+        right(node) == nil &&
+        tree != node &&
+        "Node already used or not initialized"
+    );
+    if(tree == nil) {
+        tree = node;
+        set(color, tree, RB_BLACK);
+        augment(node, nil);
+    } else {
+        __rb_mins_c_ = tree;
+        __rb_mins_p_ = nil;
+        __rb_mins_r_ = 0;
+        while(__rb_mins_c_ != nil) {
+            __rb_mins_r_ = cmp((__rb_mins_c_), (node));
+            __rb_mins_p_ = __rb_mins_c_;
+            /* Lesser on the left, greater or equal on the right. */
+            __rb_mins_c_ = __rb_mins_r_ > 0 ?
+                left(__rb_mins_c_) :
+                right(__rb_mins_c_);
         }
-        if(left(node) != nil)
-            parent(left(node)) = y;
-        if(right(node) != nil)
-            parent(right(node)) = y;
-        parent(y) = parent(node);
-        left(y) = left(node);
-        right(y) = right(node);
-        color(y) = color(node);
+        _rb_insert_link_m(
+            type,
+            nil,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            augment,
+            tree,
+            __rb_mins_p_,
+            __rb_mins_r_,
+            node
+        );
     }
-    /* Clear the node. */
-    parent(node) = nil;
-    left(node) = nil;
-    right(node) = nil;
-    color(node) = RB_BLACK;
 }
 #enddef
 
-#begindef rb_delete_node_m(
-        type,
-        nil,
-        color,
-        parent,
+// rb_insert_hint_m
+// ----------------
+//
+// Bound: cx##_insert_hint
+//
+// Insert the node into the tree, starting the search at *hint* (finger
+// search). If *node* is greater than *hint*, its position is in the right
+// sub-tree of *hint*, unless an ancestor we reach from the left is less than
+// *node*. We climb from *hint* using the parent pointers and compare only
+// these ancestors. The last one, that is less than *node*, is where we
+// descend as in rb_insert_m. We stop at the first that is greater. If *hint*
+// is close to the position of *node*, this costs O(log(d)) comparisons in the
+// distance d, otherwise O(log(N)).
+//
+// The bound function will return 0 on success.
+//
+// hint
+//    A node in the tree, close to the position of *node*. If it is nil the
+//    search starts at the root.
+//
+// node
+//    The node to insert.
+//
+// .. code-block:: cpp
+//
+#begindef _rb_insert_hint_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        cmp,
+        tree,
+        hint,
+        node,
+        c, /* current */
+        p, /* parent */
+        s, /* start */
+        r, /* result */
+        q  /* result of parent */
+)
+do {
+    if(tree == nil || hint == nil) {
+        _rb_insert_m(
+            type,
+            nil,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            augment,
+            cmp,
+            tree,
+            node,
+            c,
+            p,
+            r
+        );
+        break;
+    }
+    assert(node != nil && "Cannot insert nil node");
+    assert(
+        parent(node) == nil &&
+        left(node) == nil &&
+        right(node) == nil &&
+        tree != node &&
+        "Node already used or not initialized"
+    );
+    r = cmp((hint), (node));
+    if(r == 0)
+        break;
+    c = hint;
+    s = hint;
+    while(parent(c) != nil) {
+        p = parent(c);
+        /* Only ancestors on the side of node can bound the sub-tree. */
+        if((r < 0) == (c == left(p))) {
+            q = cmp((p), (node));
+            if(q == 0) {
+                s = nil;
+                break;
+            }
+            if((q > 0) == (r < 0))
+                break;
+            s = p;
+        }
+        c = p;
+    }
+    /* The node is already in the rbtree, we break. */
+    if(s == nil)
+        break;
+    _rb_insert_from_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        cmp,
+        tree,
+        s,
+        node,
+        c,
+        p,
+        r
+    );
+} while(0);
+#enddef
+
+#begindef rb_insert_hint_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        cmp,
+        tree,
+        hint,
+        node
+)
+{
+    type* __rb_insh_current_;
+    type* __rb_insh_parent_;
+    type* __rb_insh_start_;
+    int   __rb_insh_result_;
+    int   __rb_insh_presult_;
+    _rb_insert_hint_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        cmp,
+        tree,
+        hint,
+        node,
+        __rb_insh_current_,
+        __rb_insh_parent_,
+        __rb_insh_start_,
+        __rb_insh_result_,
+        __rb_insh_presult_
+    )
+}
+#enddef
+
+// rb_delete_node_m
+// ----------------
+//
+// Bound: cx##_delete_node
+//
+// Delete a node from the tree. This function acts on an actual tree
+// node. If you don't have it; use rb_find_m first or rb_delete_m. The root node
+// (*tree*) can change.
+//
+// tree
+//    The root node of the tree. A pointer to nil represents an empty tree.
+//
+// node
+//    The node to delete.
+//
+// .. code-block:: cpp
+//
+#begindef _rb_delete_node_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        tree,
+        node,
+        x,
+        y,
+        xp
+)
+{
+    assert(tree != nil && "Cannot remove node from empty tree");
+    assert(node != nil && "Cannot delete nil node");
+    assert((
+        parent(node) != nil ||
+        left(node) != nil ||
+        right(node) != nil ||
+        rb_is_black_m(color(node))
+    ) && "Node is not in a tree");
+    if(left(node) == nil || right(node) == nil)
+        /* This node has at least one nil node, delete is simple. */
+        y = node;
+    else {
+        /* We need to find another node for deletion that has only one child.
+         * This is tree-next. */
+        y = right(node);
+        while(left(y) != nil)
+            y = left(y);
+    }
+
+    /* If y has a child we have to attach it to the parent. */
+    if(left(y) != nil)
+        x = left(y);
+    else
+        x = right(y);
+
+    /* Remove y from the tree. We remember the parent of x, since x can be
+     * nil and nil is never written. */
+    xp = parent(y);
+    if(x != nil)
+        set(parent, x, xp);
+    if(xp != nil) {
+        if(y == left(xp))
+            set(left, xp, x);
+        else
+            set(right, xp, x);
+    } else
+        tree = x;
+    /* Update the path from the removed position to the root. */
+    augment(xp, nil);
+
+    /* A black node was removed, to fix the problem we pretend to have pushed the
+     * blackness onto x. Therefore x is double black and violates property 1. */
+    if(rb_is_black_m(color(y))) {
+        _rb_delete_fix_m(
+                type,
+                nil,
+                color,
+                parent,
+                left,
+                right,
+                set,
+                augment,
+                tree,
+                x,
+                xp
+        );
+    }
+
+    /* Replace y with the node since we don't control memory. */
+    if(node != y) {
+        if(parent(node) == nil) {
+            tree = y;
+            set(parent, y, nil);
+        } else {
+            if(node == left(parent(node)))
+                set(left, parent(node), y);
+            else if(node == right(parent(node)))
+                set(right, parent(node), y);
+        }
+        if(left(node) != nil)
+            set(parent, left(node), y);
+        if(right(node) != nil)
+            set(parent, right(node), y);
+        set(parent, y, parent(node));
+        set(left, y, left(node));
+        set(right, y, right(node));
+        set(color, y, color(node));
+        /* y took the position of the node. */
+        augment(y, nil);
+    }
+    /* Clear the node. */
+    set(parent, node, nil);
+    set(left, node, nil);
+    set(right, node, nil);
+    set(color, node, RB_BLACK);
+}
+#enddef
+
+#begindef rb_delete_node_m(
+        type,
+        nil,
+        color,
+        parent,
         left,
         right,
+        set,
+        augment,
         tree,
         node
 )
 {
     type* __rb_del_x_;
     type* __rb_del_y_;
+    type* __rb_del_xp_;
     _rb_delete_node_m(
         type,
         nil,
@@ -1089,14 +2403,85 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         tree,
         node,
         __rb_del_x_,
-        __rb_del_y_
+        __rb_del_y_,
+        __rb_del_xp_
     )
 }
 #enddef
 
+// rb_clear_m
+// ----------
+//
+// Bound: cx##_clear
+//
+// Remove all nodes from a tree in O(N). We descend to a leaf, detach it from
+// its parent and continue with the parent, so the nodes are visited in
+// post-order. No stack is needed and since the tree is discarded there is
+// nothing to rebalance.
+//
+// tree
+//    The root node of the tree. It is nil afterwards.
+//
+// callback
+//    Function pointer callback(node, ctx) or NULL. It is called for every node
+//    after the node was reset, so it may free the node.
+//
+// ctx
+//    Passed to *callback*.
+//
+// .. code-block:: cpp
+//
+#begindef rb_clear_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        tree,
+        callback,
+        ctx
+)
+{
+    type* __rb_clr_node_ = tree;
+    type* __rb_clr_parent_;
+    while(__rb_clr_node_ != nil) {
+        if(left(__rb_clr_node_) != nil)
+            __rb_clr_node_ = left(__rb_clr_node_);
+        else if(right(__rb_clr_node_) != nil)
+            __rb_clr_node_ = right(__rb_clr_node_);
+        else {
+            __rb_clr_parent_ = parent(__rb_clr_node_);
+            if(__rb_clr_parent_ != nil) {
+                if(left(__rb_clr_parent_) == __rb_clr_node_)
+                    set(left, __rb_clr_parent_, nil);
+                else
+                    set(right, __rb_clr_parent_, nil);
+            }
+            _rb_node_init_m(
+                nil,
+                color,
+                parent,
+                left,
+                right,
+                set,
+                __rb_clr_node_
+            );
+            if(callback != NULL)
+                callback(__rb_clr_node_, ctx);
+            __rb_clr_node_ = __rb_clr_parent_;
+        }
+    }
+    tree = nil;
+}
+#enddef
+
 // rb_find_m
 // ---------
 //
@@ -1150,79 +2535,6489 @@ do {
 }
 #enddef
 
-// rb_replace_node_m
-// -----------------
-//
-// Bound: cx##_replace_node
-//
-// Replace a node with another. The cmp(old, new) has to return 0 or the
-// function won't do anything.
+// rb_find_batch_m
+// ---------------
 //
-// The bound function will return 0 on success.
+// Bound: cx##_find_batch
 //
-// cmp
-//    Comparator (rb_pointer_cmp_m or rb_safe_value_cmp_m could be used).
+// Find the nodes for *n* keys. Each descent is a chain of cache misses that
+// depend on each other, but the descents of different keys don't. So we
+// advance up to RB_BATCH lookups in lock-step, one level per round, and
+// prefetch the next child of each one. While the first lookup waits for its
+// child, the misses of the others are already in flight.
 //
-// tree
-//    The root node of the tree. A pointer to nil represents an empty tree.
+// keys
+//    Array of *n* nodes used as search keys.
 //
-// old
-//    The node to be replaced.
+// out
+//    Output array of *n* nodes, nil if the key was not found.
 //
-// new
-//    The new node. Has not to be initialized since all fields are replaced.
+// found
+//    Output number of keys found.
 //
 // .. code-block:: cpp
-
-#begindef rb_replace_node_m(
+//
+#begindef rb_find_batch_m(
         type,
         nil,
-        color,
-        parent,
         left,
         right,
         cmp,
         tree,
-        old,
-        new
+        keys,
+        n,
+        out,
+        found
 )
 {
-    assert(tree != nil && "The tree can't be nil");
-    assert(old != nil && "The old node can't be nil");
-    assert(new != nil && "The new node can't be nil");
-    assert(new != old && "The old and new node must differ");
-    if(cmp((old), (new)) == 0) {
-        if(old == tree)
-            tree = new;
-        else {
-            if(old == left(parent(old)))
-                left(parent(old)) = new;
-            else
-                right(parent(old)) = new;
+    type*  __rb_fb_cur_[RB_BATCH];
+    type*  __rb_fb_node_;
+    size_t __rb_fb_base_;
+    size_t __rb_fb_size_;
+    size_t __rb_fb_i_;
+    size_t __rb_fb_active_;
+    int    __rb_fb_result_;
+    found = 0;
+    rb_prefetch_m(tree);
+    for(__rb_fb_base_ = 0; __rb_fb_base_ < n; __rb_fb_base_ += RB_BATCH) {
+        __rb_fb_size_ = n - __rb_fb_base_;
+        if(__rb_fb_size_ > RB_BATCH)
+            __rb_fb_size_ = RB_BATCH;
+        for(__rb_fb_i_ = 0; __rb_fb_i_ < __rb_fb_size_; __rb_fb_i_++) {
+            assert(
+                keys[__rb_fb_base_ + __rb_fb_i_] != nil &&
+                "Do not use nil as search key"
+            );
+            __rb_fb_cur_[__rb_fb_i_] = tree;
+            out[__rb_fb_base_ + __rb_fb_i_] = nil;
+        }
+        __rb_fb_active_ = tree != nil;
+        while(__rb_fb_active_) {
+            __rb_fb_active_ = 0;
+            for(__rb_fb_i_ = 0; __rb_fb_i_ < __rb_fb_size_; __rb_fb_i_++) {
+                __rb_fb_node_ = __rb_fb_cur_[__rb_fb_i_];
+                if(__rb_fb_node_ == nil)
+                    continue;
+                __rb_fb_result_ = cmp(
+                    (__rb_fb_node_),
+                    (keys[__rb_fb_base_ + __rb_fb_i_])
+                );
+                if(__rb_fb_result_ == 0) {
+                    out[__rb_fb_base_ + __rb_fb_i_] = __rb_fb_node_;
+                    found += 1;
+                    __rb_fb_node_ = nil;
+                } else if(__rb_fb_result_ > 0)
+                    __rb_fb_node_ = left(__rb_fb_node_);
+                else
+                    __rb_fb_node_ = right(__rb_fb_node_);
+                __rb_fb_cur_[__rb_fb_i_] = __rb_fb_node_;
+                if(__rb_fb_node_ != nil) {
+                    rb_prefetch_m(__rb_fb_node_);
+                    __rb_fb_active_ += 1;
+                }
+            }
         }
-        if(left(old) != nil)
-            parent(left(old)) = new;
-        if(right(old) != nil)
-            parent(right(old)) = new;
-        parent(new) = parent(old);
-        left(new) = left(old);
-        right(new) = right(old);
-        color(new) = color(old);
-        /* Clear the old node. */
-        parent(old) = nil;
-        left(old) = nil;
-        right(old) = nil;
-        color(old) = RB_BLACK;
     }
 }
 #enddef
 
-// rb_bind_decl_m
-// --------------
+// rb_bound_m
+// ----------
 //
-// Bind rbtree functions to a context. This only generates declarations.
+// Bound: cx##_lower_bound, cx##_upper_bound, cx##_floor, cx##_ceil
 //
-// rb_bind_decl_cx_m is just an alias for consistency.
+// Find the least node for which cmp(node, key) op 0 is true, in one descent.
+// Every node that matches is a candidate and we look for a lesser one on the
+// left, otherwise the result can only be on the right. With left and right
+// switched, it finds the greatest node instead. The node will be set to nil if
+// no node matches.
+//
+// cmp
+//    Comparator (rb_pointer_cmp_m or rb_safe_value_cmp_m could be used).
+//
+// tree
+//    The root node of the tree. A pointer to nil represents an empty tree.
+//
+// key
+//    The node used as search key.
+//
+// node
+//    The output node.
+//
+// op
+//    The comparison operator: >= for lower bound, > for upper bound and <= for
+//    floor (with left and right switched).
+//
+// .. code-block:: cpp
+//
+#begindef rb_bound_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        cmp,
+        tree,
+        key,
+        node,
+        op
+)
+{
+    assert(key != nil && "Do not use nil as search key");
+    type* __rb_bound_node_ = tree;
+    node = nil;
+    while(__rb_bound_node_ != nil) {
+        if(cmp((__rb_bound_node_), (key)) op 0) {
+            node = __rb_bound_node_;
+            __rb_bound_node_ = left(__rb_bound_node_);
+        } else
+            __rb_bound_node_ = right(__rb_bound_node_);
+    }
+}
+#enddef
+
+// rb_find_key_m
+// -------------
+//
+// Bound: cx##_find_key, cx##_lower_bound_key
+//
+// Same as rb_find_m and rb_bound_m, but *key* is a bare key, which is
+// compared with the key of the node: key_cmp(key_m(node), key). There is no
+// dummy node to fill in and for simple keys the comparison is inline.
+//
+// key_m
+//    Key trait: returns the key of a node.
+//
+// key_cmp
+//    Key comparator, it has to order like the comparator of the nodes.
+//
+// .. code-block:: cpp
+//
+#begindef rb_find_key_m(
+        type,
+        nil,
+        left,
+        right,
+        key_m,
+        key_cmp,
+        tree,
+        key,
+        node
+)
+{
+    int __rb_fkey_result_;
+    node = tree;
+    while(node != nil) {
+        __rb_fkey_result_ = key_cmp(key_m(node), (key));
+        if(__rb_fkey_result_ == 0)
+            break;
+        node = __rb_fkey_result_ > 0 ? left(node) : right(node);
+    }
+}
+#enddef
+
+#begindef rb_bound_key_m(
+        type,
+        nil,
+        left,
+        right,
+        key_m,
+        key_cmp,
+        tree,
+        key,
+        node,
+        op
+)
+{
+    type* __rb_bkey_node_ = tree;
+    node = nil;
+    while(__rb_bkey_node_ != nil) {
+        if(key_cmp(key_m(__rb_bkey_node_), (key)) op 0) {
+            node = __rb_bkey_node_;
+            __rb_bkey_node_ = left(__rb_bkey_node_);
+        } else
+            __rb_bkey_node_ = right(__rb_bkey_node_);
+    }
+}
+#enddef
+
+// rb_child_find_m
+// ---------------
+//
+// Bound: cx##_find, cx##_lower_bound, cx##_upper_bound and cx##_insert of the
+// child binding
+//
+// Same as rb_find_m, rb_bound_m and rb_insert_m, but the children are an
+// array: child(x)[0] is left and child(x)[1] is right. Instead of r > 0 ?
+// left(x) : right(x), which mispredicts half of the time on random keys, we
+// load child(x)[r < 0]. The only branch left in the loop is the exit.
+//
+// child
+//    Child trait: returns the array of the two children.
+//
+// .. code-block:: cpp
+//
+#begindef rb_child_find_m(
+        type,
+        nil,
+        child,
+        cmp,
+        tree,
+        key,
+        node
+)
+{
+    int __rb_cfind_result_;
+    assert(key != nil && "Do not use nil as search key");
+    node = tree;
+    while(node != nil) {
+        __rb_cfind_result_ = cmp((node), (key));
+        if(__rb_cfind_result_ == 0)
+            break;
+        node = child(node)[__rb_cfind_result_ < 0];
+    }
+}
+#enddef
+
+#begindef rb_child_bound_m(
+        type,
+        nil,
+        child,
+        cmp,
+        tree,
+        key,
+        node,
+        op
+)
+{
+    type* __rb_cbound_node_ = tree;
+    int   __rb_cbound_match_;
+    assert(key != nil && "Do not use nil as search key");
+    node = nil;
+    while(__rb_cbound_node_ != nil) {
+        __rb_cbound_match_ = cmp((__rb_cbound_node_), (key)) op 0;
+        node = __rb_cbound_match_ ? __rb_cbound_node_ : node;
+        __rb_cbound_node_ = child(__rb_cbound_node_)[!__rb_cbound_match_];
+    }
+}
+#enddef
+
+#begindef rb_child_insert_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        child,
+        set,
+        cmp,
+        tree,
+        node,
+        ret
+)
+{
+    type* __rb_cins_c_;
+    type* __rb_cins_p_;
+    int   __rb_cins_r_;
+    assert(node != nil && "Cannot insert nil node");
+    assert(
+        parent(node) == nil &&
+        left(node) == nil &&
+        right(node) == nil &&
+        tree != node &&
+        "Node already used or not initialized"
+    );
+    ret = 0;
+    if(tree == nil) {
+        tree = node;
+        set(color, tree, RB_BLACK);
+    } else {
+        __rb_cins_c_ = tree;
+        __rb_cins_p_ = nil;
+        __rb_cins_r_ = 0;
+        while(__rb_cins_c_ != nil) {
+            __rb_cins_r_ = cmp((__rb_cins_c_), (node));
+            if(__rb_cins_r_ == 0)
+                break;
+            __rb_cins_p_ = __rb_cins_c_;
+            __rb_cins_c_ = child(__rb_cins_c_)[__rb_cins_r_ < 0];
+        }
+        if(__rb_cins_c_ != nil)
+            ret = 1;
+        else
+            _rb_insert_link_m(
+                type,
+                nil,
+                color,
+                parent,
+                left,
+                right,
+                set,
+                rb_no_augment_m,
+                tree,
+                __rb_cins_p_,
+                __rb_cins_r_,
+                node
+            );
+    }
+}
+#enddef
+
+// rb_replace_node_m
+// -----------------
+//
+// Bound: cx##_replace_node
+//
+// Replace a node with another. The cmp(old, new) has to return 0 or the
+// function won't do anything.
+//
+// The bound function will return 0 on success.
+//
+// cmp
+//    Comparator (rb_pointer_cmp_m or rb_safe_value_cmp_m could be used).
+//
+// tree
+//    The root node of the tree. A pointer to nil represents an empty tree.
+//
+// old
+//    The node to be replaced.
+//
+// new
+//    The new node. Has not to be initialized since all fields are replaced.
+//
+// .. code-block:: cpp
+
+#begindef rb_replace_node_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        cmp,
+        tree,
+        old,
+        new
+)
+{
+    assert(tree != nil && "The tree can't be nil");
+    assert(old != nil && "The old node can't be nil");
+    assert(new != nil && "The new node can't be nil");
+    assert(new != old && "The old and new node must differ");
+    if(cmp((old), (new)) == 0) {
+        if(old == tree)
+            tree = new;
+        else {
+            if(old == left(parent(old)))
+                set(left, parent(old), new);
+            else
+                set(right, parent(old), new);
+        }
+        if(left(old) != nil)
+            set(parent, left(old), new);
+        if(right(old) != nil)
+            set(parent, right(old), new);
+        set(parent, new, parent(old));
+        set(left, new, left(old));
+        set(right, new, right(old));
+        set(color, new, color(old));
+        /* The new node might have a different aggregate. */
+        augment(new, nil);
+        /* Clear the old node. */
+        set(parent, old, nil);
+        set(left, old, nil);
+        set(right, old, nil);
+        set(color, old, RB_BLACK);
+    }
+}
+#enddef
+
+// rb_rank_m
+// ---------
+//
+// Bound: cx##_rank (order statistics)
+//
+// Count the nodes that are less than *key*. Every node, we go right from, is
+// less than key and so is its left sub-tree.
+//
+// size
+//    The size trait of the nodes is the number of nodes in the sub-tree.
+//
+// key
+//    The node used as search key.
+//
+// rank
+//    The output rank.
+//
+// .. code-block:: cpp
+//
+#begindef rb_rank_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        size,
+        cmp,
+        tree,
+        key,
+        rank
+)
+{
+    assert(key != nil && "Do not use nil as search key");
+    type* __rb_rank_node_ = tree;
+    rank = 0;
+    while(__rb_rank_node_ != nil) {
+        if(cmp((__rb_rank_node_), (key)) < 0) {
+            rank += size(left(__rb_rank_node_)) + 1;
+            __rb_rank_node_ = right(__rb_rank_node_);
+        } else
+            __rb_rank_node_ = left(__rb_rank_node_);
+    }
+}
+#enddef
+
+// rb_rank_node_m
+// --------------
+//
+// Bound: cx##_rank_node (order statistics)
+//
+// Get the position of a known node. Moving up, every time we come from the
+// right, the parent and its left sub-tree are in front of the node.
+//
+// node
+//    The node to get the position of.
+//
+// rank
+//    The output rank.
+//
+// .. code-block:: cpp
+//
+#begindef rb_rank_node_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        size,
+        node,
+        rank
+)
+{
+    assert(node != nil && "Nil has no rank");
+    type* __rb_rank_node_ = node;
+    rank = size(left(__rb_rank_node_));
+    while(parent(__rb_rank_node_) != nil) {
+        if(__rb_rank_node_ == right(parent(__rb_rank_node_)))
+            rank += size(left(parent(__rb_rank_node_))) + 1;
+        __rb_rank_node_ = parent(__rb_rank_node_);
+    }
+}
+#enddef
+
+// rb_select_m
+// -----------
+//
+// Bound: cx##_select (order statistics)
+//
+// Find the node at a position. The node will be set to nil if the position is
+// out of range.
+//
+// index
+//    The zero-based position.
+//
+// node
+//    The output node.
+//
+// .. code-block:: cpp
+//
+#begindef rb_select_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        size,
+        tree,
+        index,
+        node
+)
+{
+    RB_SIZE_T __rb_sel_index_ = index;
+    RB_SIZE_T __rb_sel_left_;
+    node = tree;
+    while(node != nil) {
+        __rb_sel_left_ = size(left(node));
+        if(__rb_sel_index_ < __rb_sel_left_)
+            node = left(node);
+        else if(__rb_sel_index_ == __rb_sel_left_)
+            break;
+        else {
+            __rb_sel_index_ -= __rb_sel_left_ + 1;
+            node = right(node);
+        }
+    }
+}
+#enddef
+
+// rb_iter_skip_m
+// --------------
+//
+// Bound: cx##_iter_skip (order statistics)
+//
+// Move the iterator *count* elements forward. If the target is in the right
+// sub-tree of the element, we select it there. Otherwise we skip the right
+// sub-tree and move up to the next ancestor, that we come to from the left,
+// which is the next element. So we move up and then down once: O(log(N)).
+//
+// elem
+//    The pointer to the current element. Will be NULL if it moves past the end.
+//
+// count
+//    The number of elements to move forward.
+//
+// .. code-block:: cpp
+//
+#begindef rb_iter_skip_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        size,
+        elem,
+        count
+)
+{
+    RB_SIZE_T __rb_skip_count_ = count;
+    while(__rb_skip_count_ > 0) {
+        if(size(right(elem)) >= __rb_skip_count_) {
+            rb_select_m(
+                type,
+                nil,
+                color,
+                parent,
+                left,
+                right,
+                size,
+                right(elem),
+                __rb_skip_count_ - 1,
+                elem
+            );
+            break;
+        }
+        __rb_skip_count_ -= size(right(elem)) + 1;
+        while(parent(elem) != nil && elem == right(parent(elem)))
+            elem = parent(elem);
+        elem = parent(elem);
+        /* Next would be the root, we are done. */
+        if(elem == nil) {
+            elem = NULL;
+            break;
+        }
+    }
+}
+#enddef
+
+// rb_overlap_first_m
+// ------------------
+//
+// Bound: cx##_overlap_first, cx##_stab_first (interval tree)
+//
+// Find the first interval that overlaps [a, b]. If the left sub-tree contains
+// an interval that ends at or after a, we have to go left: either the first
+// overlap is there or the interval starts after b and so do all following
+// intervals. Otherwise the node itself is checked and we continue right.
+// Sub-trees that end before a are skipped.
+//
+// start, end
+//    The start and end traits of the nodes, the interval is [start, end].
+//
+// max
+//    The max trait of the nodes is the maximal end in the sub-tree.
+//
+// a, b
+//    The interval to find overlaps for.
+//
+// elem
+//    The output node. Is NULL if there is no overlap.
+//
+// .. code-block:: cpp
+//
+#begindef _rb_overlap_sub_m(
+        nil,
+        left,
+        right,
+        start,
+        end,
+        max,
+        a,
+        b,
+        node
+)
+{
+    if(node != nil && max(node) < (a))
+        node = nil;
+    while(node != nil) {
+        if(left(node) != nil && max(left(node)) >= (a))
+            node = left(node);
+        else if(start(node) > (b))
+            /* All following intervals start after b. */
+            node = nil;
+        else if(end(node) >= (a))
+            /* Overlaps. */
+            break;
+        else {
+            node = right(node);
+            if(node != nil && max(node) < (a))
+                node = nil;
+        }
+    }
+}
+#enddef
+
+#begindef rb_overlap_first_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        start,
+        end,
+        max,
+        tree,
+        a,
+        b,
+        elem
+)
+{
+    elem = tree;
+    _rb_overlap_sub_m(
+        nil,
+        left,
+        right,
+        start,
+        end,
+        max,
+        a,
+        b,
+        elem
+    );
+    if(elem == nil)
+        elem = NULL;
+}
+#enddef
+
+// rb_overlap_next_m
+// -----------------
+//
+// Bound: cx##_overlap_next, cx##_stab_next (interval tree)
+//
+// Find the next interval that overlaps [a, b]. The next overlap is either in
+// the right sub-tree or it is an ancestor we come to from the left, or in the
+// right sub-tree of that ancestor. If the search in a sub-tree fails because
+// an interval starts after b, the next ancestor starts after b too and we are
+// done. So we move up only once: O(log(N)).
+//
+// elem
+//    The pointer to the current element. Will be NULL at the end.
+//
+// .. code-block:: cpp
+//
+#begindef _rb_overlap_next_m(
+        nil,
+        parent,
+        left,
+        right,
+        start,
+        end,
+        max,
+        a,
+        b,
+        elem,
+        x
+)
+{
+    x = elem;
+    elem = right(x);
+    _rb_overlap_sub_m(
+        nil,
+        left,
+        right,
+        start,
+        end,
+        max,
+        a,
+        b,
+        elem
+    );
+    while(elem == nil) {
+        while(parent(x) != nil && x == right(parent(x)))
+            x = parent(x);
+        x = parent(x);
+        /* Next would be the root or starts after b, we are done. */
+        if(x == nil || start(x) > (b))
+            break;
+        if(end(x) >= (a)) {
+            elem = x;
+            break;
+        }
+        elem = right(x);
+        _rb_overlap_sub_m(
+            nil,
+            left,
+            right,
+            start,
+            end,
+            max,
+            a,
+            b,
+            elem
+        );
+    }
+    if(elem == nil)
+        elem = NULL;
+}
+#enddef
+
+#begindef rb_overlap_next_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        start,
+        end,
+        max,
+        a,
+        b,
+        elem
+)
+{
+    type* __rb_ovl_x_;
+    _rb_overlap_next_m(
+        nil,
+        parent,
+        left,
+        right,
+        start,
+        end,
+        max,
+        a,
+        b,
+        elem,
+        __rb_ovl_x_
+    );
+}
+#enddef
+
+// rb_for_overlap_m
+// ----------------
+//
+// Generates a for-loop-header over the intervals that overlap *key*.
+// rb_for_stab_m over the intervals that contain start(key).
+//
+// key
+//    The node with the interval to find overlaps for.
+//
+// elem
+//    The pointer to the current element.
+//
+// .. code-block:: cpp
+//
+#begindef rb_for_overlap_m(cx, tree, key, elem)
+    for(
+            cx##_overlap_first(tree, key, &elem);
+            elem != NULL;
+            cx##_overlap_next(key, &elem)
+    )
+#enddef
+
+#begindef rb_for_stab_m(cx, tree, key, elem)
+    for(
+            cx##_stab_first(tree, key, &elem);
+            elem != NULL;
+            cx##_stab_next(key, &elem)
+    )
+#enddef
+
+// rb_build_sorted_m
+// -----------------
+//
+// Bound: cx##_build_sorted
+//
+// Build a tree from an array of sorted nodes in O(N). The node in the middle
+// of a range becomes the root of the range, so the nodes are linked by their
+// position in the array and no comparisons are needed. Since the sizes of the
+// sub-trees of a node differ by at most one, all levels but the deepest are
+// full. The deepest level is colored red, all other nodes are black. Instead of
+// recursion we use a stack of ranges, its size is bound by twice the height of
+// the tree. A range stays on the stack till its sub-ranges are done, so
+// augment is called in post-order.
+//
+// tree
+//    The root node of the tree. Has to be an empty tree (nil).
+//
+// nodes
+//    Array of pointers to the nodes, sorted by the comparator. The nodes have
+//    not to be initialized since all fields are replaced.
+//
+// n
+//    The number of nodes in *nodes*.
+//
+// .. code-block:: cpp
+//
+typedef struct {
+    size_t lo;
+    size_t hi;
+    int    depth;
+    int    linked;
+} rb_range_t;
+
+#begindef _rb_build_sorted_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        tree,
+        nodes,
+        n,
+        stack, /* rb_range_t[RB_MAX_HEIGHT] */
+        sp,    /* stack pointer */
+        red,   /* depth of the red level */
+        r,     /* current range */
+        m,     /* middle of current range */
+        node,
+        child
+)
+{
+    assert(tree == nil && "Tree has to be empty");
+    if(n > 0) {
+        /* The depth of the deepest level is floor(log2(n)). */
+        red = 0;
+        while((((size_t) n) >> (red + 1)) != 0)
+            red += 1;
+        tree = nodes[(n) / 2];
+        set(parent, tree, nil);
+        stack[0].lo = 0;
+        stack[0].hi = n;
+        stack[0].depth = 0;
+        stack[0].linked = 0;
+        sp = 1;
+        while(sp > 0) {
+            r = stack[sp - 1];
+            m = r.lo + (r.hi - r.lo) / 2;
+            node = nodes[m];
+            if(r.linked) {
+                /* The sub-trees are done. */
+                augment(node, parent(node));
+                sp -= 1;
+                continue;
+            }
+            stack[sp - 1].linked = 1;
+            /* The root is always black. */
+            if(r.depth == red && r.depth > 0)
+                set(color, node, RB_RED);
+            else
+                set(color, node, RB_BLACK);
+            /* Link the middle of both sub-ranges and push them. */
+            if(r.lo < m) {
+                assert(sp < RB_MAX_HEIGHT && "Stack overflow");
+                child = nodes[r.lo + (m - r.lo) / 2];
+                set(left, node, child);
+                set(parent, child, node);
+                stack[sp].lo = r.lo;
+                stack[sp].hi = m;
+                stack[sp].depth = r.depth + 1;
+                stack[sp].linked = 0;
+                sp += 1;
+            } else
+                set(left, node, nil);
+            if(m + 1 < r.hi) {
+                assert(sp < RB_MAX_HEIGHT && "Stack overflow");
+                child = nodes[m + 1 + (r.hi - m - 1) / 2];
+                set(right, node, child);
+                set(parent, child, node);
+                stack[sp].lo = m + 1;
+                stack[sp].hi = r.hi;
+                stack[sp].depth = r.depth + 1;
+                stack[sp].linked = 0;
+                sp += 1;
+            } else
+                set(right, node, nil);
+        }
+    }
+}
+#enddef
+
+#begindef rb_build_sorted_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        tree,
+        nodes,
+        n
+)
+{
+    rb_range_t __rb_bld_stack_[RB_MAX_HEIGHT];
+    int        __rb_bld_sp_;
+    int        __rb_bld_red_;
+    rb_range_t __rb_bld_range_;
+    size_t     __rb_bld_mid_;
+    type*      __rb_bld_node_;
+    type*      __rb_bld_child_;
+    _rb_build_sorted_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        tree,
+        nodes,
+        n,
+        __rb_bld_stack_,
+        __rb_bld_sp_,
+        __rb_bld_red_,
+        __rb_bld_range_,
+        __rb_bld_mid_,
+        __rb_bld_node_,
+        __rb_bld_child_
+    )
+}
+#enddef
+
+// rb_black_height_m
+// -----------------
+//
+// Internal: not bound
+//
+// Count the black nodes from *tree* down to nil. All paths have the same
+// number of black nodes, so we take the left spine. nil has a black height of
+// zero.
+//
+// .. code-block:: cpp
+//
+#begindef rb_black_height_m(type, nil, color, left, tree, bh)
+{
+    type* __rb_bh_node_ = tree;
+    bh = 0;
+    while(__rb_bh_node_ != nil) {
+        if(rb_is_black_m(color(__rb_bh_node_)))
+            bh += 1;
+        __rb_bh_node_ = left(__rb_bh_node_);
+    }
+}
+#enddef
+
+// rb_split_m
+// ----------
+//
+// Bound: cx##_split
+//
+// Split a tree at *key*. We descend to *key*, if it is found its sub-trees
+// are the start of the left and the right tree. Then we move up the path using
+// the parent pointers. Every node on the path goes to the left or the right
+// tree, together with its sub-tree that is not on the path. The left and the
+// right tree are built bottom-up by joining them with these nodes. Moving up
+// the black height of the sub-trees grows, so the joins cost O(log(N)) in
+// total. The roots of both output trees are black.
+//
+// join
+//    Join function: join(ltree, lbh, node, rtree, rbh, &bh) returns the tree
+//    of ltree, node and rtree and sets bh to its black height.
+//
+// tree
+//    The root node of the tree. The tree is taken apart.
+//
+// key
+//    The node used as split key.
+//
+// ltree, lbh
+//    The output tree of the nodes less than *key* and its black height.
+//
+// rtree, rbh
+//    The output tree of the nodes greater than *key* and its black height.
+//
+// found
+//    The output node equal to *key* or nil. It is in neither tree.
+//
+// .. code-block:: cpp
+//
+#begindef rb_split_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        cmp,
+        join,
+        tree,
+        key,
+        ltree,
+        lbh,
+        rtree,
+        rbh,
+        found
+)
+{
+    assert(key != nil && "Do not use nil as split key");
+    type* __rb_split_node_ = tree;
+    type* __rb_split_last_ = nil;
+    type* __rb_split_parent_;
+    type* __rb_split_sub_;
+    int   __rb_split_bh_ = 0;
+    int   __rb_split_next_bh_;
+    int   __rb_split_cmp_;
+    found = nil;
+    ltree = nil;
+    rtree = nil;
+    lbh = 0;
+    rbh = 0;
+    while(__rb_split_node_ != nil) {
+        __rb_split_last_ = __rb_split_node_;
+        __rb_split_cmp_ = cmp((__rb_split_node_), (key));
+        if(__rb_split_cmp_ == 0) {
+            found = __rb_split_node_;
+            break;
+        }
+        if(__rb_split_cmp_ > 0)
+            __rb_split_node_ = left(__rb_split_node_);
+        else
+            __rb_split_node_ = right(__rb_split_node_);
+    }
+    /* __rb_split_bh_ is the black height of the children of the node. */
+    __rb_split_node_ = __rb_split_last_;
+    if(found != nil) {
+        ltree = left(found);
+        rtree = right(found);
+        if(ltree != nil)
+            set(parent, ltree, nil);
+        if(rtree != nil)
+            set(parent, rtree, nil);
+        rb_black_height_m(type, nil, color, left, ltree, lbh);
+        rbh = lbh;
+        __rb_split_bh_ = lbh;
+        if(rb_is_black_m(color(found)))
+            __rb_split_bh_ += 1;
+        __rb_split_node_ = parent(found);
+        /* Clear the node. */
+        set(parent, found, nil);
+        set(left, found, nil);
+        set(right, found, nil);
+        set(color, found, RB_BLACK);
+    }
+    while(__rb_split_node_ != nil) {
+        __rb_split_parent_ = parent(__rb_split_node_);
+        __rb_split_next_bh_ = __rb_split_bh_;
+        if(rb_is_black_m(color(__rb_split_node_)))
+            __rb_split_next_bh_ += 1;
+        if(cmp((__rb_split_node_), (key)) > 0) {
+            /* We came from the left, the right sub-tree is greater. */
+            __rb_split_sub_ = right(__rb_split_node_);
+            if(__rb_split_sub_ != nil)
+                set(parent, __rb_split_sub_, nil);
+            rtree = join(
+                rtree,
+                rbh,
+                __rb_split_node_,
+                __rb_split_sub_,
+                __rb_split_bh_,
+                &rbh
+            );
+        } else {
+            /* We came from the right, the left sub-tree is less. */
+            __rb_split_sub_ = left(__rb_split_node_);
+            if(__rb_split_sub_ != nil)
+                set(parent, __rb_split_sub_, nil);
+            ltree = join(
+                __rb_split_sub_,
+                __rb_split_bh_,
+                __rb_split_node_,
+                ltree,
+                lbh,
+                &lbh
+            );
+        }
+        __rb_split_node_ = __rb_split_parent_;
+        __rb_split_bh_ = __rb_split_next_bh_;
+    }
+    /* A sub-tree that was never joined can have a red root. */
+    if(ltree != nil && rb_is_red_m(color(ltree))) {
+        set(color, ltree, RB_BLACK);
+        lbh += 1;
+    }
+    if(rtree != nil && rb_is_red_m(color(rtree))) {
+        set(color, rtree, RB_BLACK);
+        rbh += 1;
+    }
+}
+#enddef
+
+// rb_fork_join
+// ------------
+//
+// Internal: not bound
+//
+// Run two tasks of the set operations. If RB_PTHREAD is defined and
+// *parallel* is true, task *a* runs in a new thread. If the thread can't be
+// created, both run in the current thread.
+//
+// .. code-block:: cpp
+//
+typedef void* (*rb_task_f)(void* arg);
+
+static inline
+void
+rb_fork_join(rb_task_f a, void* aarg, rb_task_f b, void* barg, int parallel)
+{
+#ifdef RB_PTHREAD
+    pthread_t thread;
+    if(parallel && pthread_create(&thread, NULL, a, aarg) == 0) {
+        b(barg);
+        pthread_join(thread, NULL);
+        return;
+    }
+#else
+    (void)(parallel);
+#endif
+    a(aarg);
+    b(barg);
+}
+
+// rb_bind_decl_m
+// --------------
+//
+// Bind rbtree functions to a context. This only generates declarations.
+//
+// rb_bind_decl_cx_m is just an alias for consistency.
+//
+// cx
+//    Name of the new context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#begindef rb_bind_decl_cx_m(cx, type)
+    rb_new_context_m(cx, type)
+    _rb_bind_decl_fn_m(cx, type)
+#enddef
+#define rb_bind_decl_m(cx, type) rb_bind_decl_cx_m(cx, type)
+
+#begindef _rb_bind_decl_fn_m(cx, type)
+    typedef struct {
+        type* link;
+        int   dir;
+    } cx##_slot_t;
+    void
+    cx##_tree_init(
+            type** tree
+    );
+    void
+    cx##_iter_init(
+            type* tree,
+            cx##_iter_t** iter,
+            type** elem
+    );
+    void
+    cx##_iter_next(
+            cx##_iter_t* iter,
+            type** elem
+    );
+    void
+    cx##_iter_init_last(
+            type* tree,
+            cx##_iter_t** iter,
+            type** elem
+    );
+    void
+    cx##_iter_prev(
+            cx##_iter_t* iter,
+            type** elem
+    );
+    void
+    cx##_range_init(
+            type* tree,
+            type* start,
+            type* end,
+            cx##_iter_t** iter,
+            type** elem
+    );
+    void
+    cx##_range_next(
+            cx##_iter_t* iter,
+            type** elem
+    );
+    void
+    cx##_node_init(
+            type* node
+    );
+    int
+    cx##_insert(
+            type** tree,
+            type* node
+    );
+    int
+    cx##_insert_hint(
+            type** tree,
+            type* hint,
+            type* node
+    );
+    int
+    cx##_append(
+            type** tree,
+            type* last,
+            type* node
+    );
+    int
+    cx##_insert_or_get(
+            type** tree,
+            type* node,
+            type** existing
+    );
+    int
+    cx##_find_slot(
+            type* tree,
+            type* key,
+            type** node,
+            cx##_slot_t* slot
+    );
+    void
+    cx##_insert_at_slot(
+            type** tree,
+            cx##_slot_t* slot,
+            type* node
+    );
+    void
+    cx##_delete_node(
+            type** tree,
+            type* node
+    );
+    int
+    cx##_delete(
+            type** tree,
+            type* key
+    );
+    void
+    cx##_clear(
+            type** tree,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    );
+    int
+    cx##_replace_node(
+            type** tree,
+            type* old,
+            type* new
+    );
+    int
+    cx##_replace(
+            type** tree,
+            type* key,
+            type* new
+    );
+    int
+    cx##_find(
+            type* tree,
+            type* key,
+            type** node
+    );
+    size_t
+    cx##_find_batch(
+            type* tree,
+            type** keys,
+            size_t n,
+            type** out
+    );
+    int
+    cx##_lower_bound(
+            type* tree,
+            type* key,
+            type** node
+    );
+    int
+    cx##_upper_bound(
+            type* tree,
+            type* key,
+            type** node
+    );
+    int
+    cx##_floor(
+            type* tree,
+            type* key,
+            type** node
+    );
+    int
+    cx##_ceil(
+            type* tree,
+            type* key,
+            type** node
+    );
+    void
+    cx##_build_sorted(
+            type** tree,
+            type** nodes,
+            size_t n
+    );
+    void
+    cx##_split(
+            type** tree,
+            type* key,
+            type** rtree
+    );
+    void
+    cx##_join(
+            type** tree,
+            type** rtree
+    );
+    void
+    cx##_union(
+            type** tree,
+            type** other,
+            type** rest
+    );
+    void
+    cx##_intersect(
+            type** tree,
+            type** other,
+            type** rest
+    );
+    void
+    cx##_difference(
+            type** tree,
+            type** other,
+            type** rest
+    );
+    RB_SIZE_T
+    cx##_size(
+            type* tree
+    );
+    void
+    cx##_check_tree(type* tree);
+    void
+    cx##_check_tree_rec(
+            type* node,
+            int depth,
+            int *pathdepth
+    );
+#enddef
+
+// rb_bind_impl_m
+// --------------
+//
+// Bind rbtree functions to a context. This only generates implementations.
+//
+// rb_bind_impl_m uses the standard traits: rb_color_m, rb_parent_m,
+// rb_left_m, rb_right_m, whereas rb_bind_impl_cx_m expects you to create:
+// cx##_color_m, cx##_parent_m, cx##_left_m, cx##_right_m.
+//
+// cx
+//    Name of the new context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#begindef _rb_bind_impl_tr_m(
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        cmp
+)
+    cx##_type_t cx##_nil_mem;
+    cx##_type_t* const cx##_nil_ptr = &cx##_nil_mem;
+    _rb_bind_impl_fn_tr_m(
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        cmp
+    )
+    _rb_size_impl_tr_m(cx, type, left, right)
+#enddef
+
+// Counts the nodes recursively, the order statistics binding returns the
+// stored size of the root instead.
+#begindef _rb_size_impl_tr_m(cx, type, left, right)
+    RB_SIZE_T
+    cx##_size(
+            type* tree
+    )
+    {
+        if(tree == cx##_nil_ptr)
+            return 0;
+        else
+            return (
+                cx##_size(left(tree)) +
+                cx##_size(right(tree)) + 1
+            );
+    }
+#enddef
+
+#begindef _rb_bind_impl_fn_tr_m(
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        cmp
+)
+    void
+    cx##_tree_init(
+            type** tree
+    )
+    {
+        _rb_node_init_m(
+                cx##_nil_ptr,
+                color,
+                parent,
+                left,
+                right,
+                set,
+                cx##_nil_ptr
+        );
+        *tree = cx##_nil_ptr;
+    }
+    void
+    cx##_iter_init(
+            type* tree,
+            cx##_iter_t** iter,
+            type** elem
+    )
+    {
+        (void)(iter);
+        rb_iter_init_m(
+            cx##_nil_ptr,
+            left,
+            tree,
+            *elem
+        );
+    }
+    void
+    cx##_iter_next(
+            cx##_iter_t* iter,
+            type** elem
+    )
+    {
+        (void)(iter);
+        rb_iter_next_m(
+            cx##_nil_ptr,
+            type,
+            parent,
+            left,
+            right,
+            *elem
+        )
+    }
+    void
+    cx##_iter_init_last(
+            type* tree,
+            cx##_iter_t** iter,
+            type** elem
+    )
+    {
+        (void)(iter);
+        rb_iter_init_m(
+            cx##_nil_ptr,
+            right, /* Switched */
+            tree,
+            *elem
+        );
+    }
+    void
+    cx##_iter_prev(
+            cx##_iter_t* iter,
+            type** elem
+    )
+    {
+        (void)(iter);
+        rb_iter_next_m(
+            cx##_nil_ptr,
+            type,
+            parent,
+            right, /* Switched */
+            left, /* Switched */
+            *elem
+        )
+    }
+    void
+    cx##_node_init(
+            type* node
+    )
+    {
+        _rb_node_init_m(
+                cx##_nil_ptr,
+                color,
+                parent,
+                left,
+                right,
+                set,
+                node
+        );
+    }
+    int
+    cx##_insert(
+            type** tree,
+            type* node
+    )
+    {
+        rb_insert_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            augment,
+            cmp,
+            *tree,
+            node
+        );
+        return !(
+            parent(node) != cx##_nil_ptr ||
+            left(node) != cx##_nil_ptr ||
+            right(node) != cx##_nil_ptr ||
+            *tree == node
+        );
+    }
+    int
+    cx##_insert_hint(
+            type** tree,
+            type* hint,
+            type* node
+    )
+    {
+        rb_insert_hint_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            augment,
+            cmp,
+            *tree,
+            hint,
+            node
+        );
+        return !(
+            parent(node) != cx##_nil_ptr ||
+            left(node) != cx##_nil_ptr ||
+            right(node) != cx##_nil_ptr ||
+            *tree == node
+        );
+    }
+    int
+    cx##_append(
+            type** tree,
+            type* last,
+            type* node
+    )
+    {
+        if(last == cx##_nil_ptr || cmp((last), (node)) >= 0)
+            return cx##_insert_hint(tree, last, node);
+        assert(right(last) == cx##_nil_ptr && "Last is not the greatest node");
+        assert(node != cx##_nil_ptr && "Cannot insert nil node");
+        assert(
+            parent(node) == cx##_nil_ptr &&
+            left(node) == cx##_nil_ptr &&
+            right(node) == cx##_nil_ptr &&
+            "Node already used or not initialized"
+        );
+        _rb_insert_link_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            augment,
+            *tree,
+            last,
+            -1,
+            node
+        );
+        return 0;
+    }
+    int
+    cx##_insert_or_get(
+            type** tree,
+            type* node,
+            type** existing
+    )
+    {
+        type* c = cx##_nil_ptr;
+        type* p;
+        int r;
+        _rb_insert_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            augment,
+            cmp,
+            *tree,
+            node,
+            c,
+            p,
+            r
+        );
+        (void)(p);
+        (void)(r);
+        if(c != cx##_nil_ptr) {
+            *existing = c;
+            return 1;
+        }
+        *existing = node;
+        return 0;
+    }
+    int
+    cx##_find_slot(
+            type* tree,
+            type* key,
+            type** node,
+            cx##_slot_t* slot
+    )
+    {
+        type* c = tree;
+        int r = 0;
+        assert(key != cx##_nil_ptr && "Do not use nil as search key");
+        slot->link = cx##_nil_ptr;
+        while(c != cx##_nil_ptr) {
+            r = cmp((c), (key));
+            if(r == 0) {
+                *node = c;
+                return 0;
+            }
+            slot->link = c;
+            /* Lesser on the left, greater on the right. */
+            c = r > 0 ? left(c) : right(c);
+        }
+        slot->dir = r;
+        *node = cx##_nil_ptr;
+        return 1;
+    }
+    void
+    cx##_insert_at_slot(
+            type** tree,
+            cx##_slot_t* slot,
+            type* node
+    )
+    {
+        assert(node != cx##_nil_ptr && "Cannot insert nil node");
+        assert(
+            parent(node) == cx##_nil_ptr &&
+            left(node) == cx##_nil_ptr &&
+            right(node) == cx##_nil_ptr &&
+            "Node already used or not initialized"
+        );
+        if(slot->link == cx##_nil_ptr) {
+            assert(*tree == cx##_nil_ptr && "Slot is outdated");
+            *tree = node;
+            set(color, node, RB_BLACK);
+            augment(node, cx##_nil_ptr);
+            return;
+        }
+        assert((
+            slot->dir > 0 ?
+            left(slot->link) :
+            right(slot->link)
+        ) == cx##_nil_ptr && "Slot is outdated");
+        _rb_insert_link_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            augment,
+            *tree,
+            slot->link,
+            slot->dir,
+            node
+        );
+    }
+    void
+    cx##_delete_node(
+            type** tree,
+            type* node
+    ) rb_delete_node_m(
+        type,
+        cx##_nil_ptr,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        *tree,
+        node
+    )
+    int
+    cx##_delete(
+            type** tree,
+            type* key
+    )
+    {
+        type* node;
+        if(cx##_find(*tree, key, &node) == 0) {
+            cx##_delete_node(tree, node);
+            return 0;
+        }
+        return 1;
+    }
+    void
+    cx##_clear(
+            type** tree,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    ) rb_clear_m(
+        type,
+        cx##_nil_ptr,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        *tree,
+        callback,
+        ctx
+    )
+    int
+    cx##_replace_node(
+            type** tree,
+            type* old,
+            type* new
+    )
+    {
+        rb_replace_node_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            augment,
+            cmp,
+            *tree,
+            old,
+            new
+        );
+        return !(
+            parent(old) == cx##_nil_ptr &&
+            left(old) == cx##_nil_ptr &&
+            right(old) == cx##_nil_ptr &&
+            old != *tree
+        );
+    }
+    int
+    cx##_replace(
+            type** tree,
+            type* key,
+            type* new
+    )
+    {
+        type* old;
+        if(cx##_find(*tree, key, &old) == 0) {
+            return cx##_replace_node(tree, old, new);
+        }
+        return 1;
+    }
+    int
+    cx##_find(
+            type* tree,
+            type* key,
+            type** node
+    )
+    {
+        rb_find_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            cmp,
+            tree,
+            key,
+            *node
+        );
+        return *node == cx##_nil_ptr;
+    }
+    size_t
+    cx##_find_batch(
+            type* tree,
+            type** keys,
+            size_t n,
+            type** out
+    )
+    {
+        size_t found;
+        rb_find_batch_m(
+            type,
+            cx##_nil_ptr,
+            left,
+            right,
+            cmp,
+            tree,
+            keys,
+            n,
+            out,
+            found
+        );
+        return found;
+    }
+    int
+    cx##_lower_bound(
+            type* tree,
+            type* key,
+            type** node
+    )
+    {
+        rb_bound_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            cmp,
+            tree,
+            key,
+            *node,
+            >=
+        );
+        return *node == cx##_nil_ptr;
+    }
+    int
+    cx##_upper_bound(
+            type* tree,
+            type* key,
+            type** node
+    )
+    {
+        rb_bound_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            cmp,
+            tree,
+            key,
+            *node,
+            >
+        );
+        return *node == cx##_nil_ptr;
+    }
+    int
+    cx##_floor(
+            type* tree,
+            type* key,
+            type** node
+    )
+    {
+        rb_bound_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            right, /* Switched */
+            left, /* Switched */
+            cmp,
+            tree,
+            key,
+            *node,
+            <=
+        );
+        return *node == cx##_nil_ptr;
+    }
+    int
+    cx##_ceil(
+            type* tree,
+            type* key,
+            type** node
+    )
+    {
+        return cx##_lower_bound(tree, key, node);
+    }
+    void
+    cx##_range_init(
+            type* tree,
+            type* start,
+            type* end,
+            cx##_iter_t** iter,
+            type** elem
+    )
+    {
+        /* The node after the range stops the iteration. */
+        if(
+                cx##_lower_bound(tree, start, elem) ||
+                cmp((*elem), (end)) > 0
+        ) {
+            *elem = NULL;
+            *iter = NULL;
+        } else if(cx##_upper_bound(tree, end, iter))
+            *iter = NULL;
+    }
+    void
+    cx##_range_next(
+            cx##_iter_t* iter,
+            type** elem
+    )
+    {
+        cx##_iter_next(iter, elem);
+        if(*elem == iter)
+            *elem = NULL;
+    }
+    void
+    cx##_build_sorted(
+            type** tree,
+            type** nodes,
+            size_t n
+    ) rb_build_sorted_m(
+        type,
+        cx##_nil_ptr,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        *tree,
+        nodes,
+        n
+    )
+    static
+    type*
+    cx##_join_bh(
+            type* ltree,
+            int lbh,
+            type* node,
+            type* rtree,
+            int rbh,
+            int* bh
+    )
+    {
+        type* tree;
+        _rb_join_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            augment,
+            ltree,
+            lbh,
+            node,
+            rtree,
+            rbh,
+            tree,
+            *bh
+        );
+        return tree;
+    }
+    static
+    type*
+    cx##_split_bh(
+            type* tree,
+            type* key,
+            type** ltree,
+            int* lbh,
+            type** rtree,
+            int* rbh
+    )
+    {
+        type* found;
+        rb_split_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            cmp,
+            cx##_join_bh,
+            tree,
+            key,
+            *ltree,
+            *lbh,
+            *rtree,
+            *rbh,
+            found
+        );
+        return found;
+    }
+    static
+    type*
+    cx##_join2_bh(
+            type* ltree,
+            int lbh,
+            type* rtree,
+            int rbh,
+            int* bh
+    )
+    {
+        type* node;
+        type* empty;
+        int ebh;
+        if(rtree == cx##_nil_ptr) {
+            *bh = lbh;
+            return ltree;
+        }
+        /* The least node of rtree joins the trees. */
+        node = rtree;
+        while(left(node) != cx##_nil_ptr)
+            node = left(node);
+        cx##_split_bh(rtree, node, &empty, &ebh, &rtree, &rbh);
+        return cx##_join_bh(ltree, lbh, node, rtree, rbh, bh);
+    }
+    static
+    void
+    cx##_black_root(
+            type* tree
+    )
+    {
+        /* Sub-trees passed through by the set operations can be red. */
+        if(tree != cx##_nil_ptr)
+            set(color, tree, RB_BLACK);
+    }
+    void
+    cx##_split(
+            type** tree,
+            type* key,
+            type** rtree
+    )
+    {
+        type* found;
+        int lbh;
+        int rbh;
+        assert(*rtree == cx##_nil_ptr && "The right tree has to be empty");
+        found = cx##_split_bh(*tree, key, tree, &lbh, rtree, &rbh);
+        if(found != cx##_nil_ptr)
+            *rtree = cx##_join_bh(cx##_nil_ptr, 0, found, *rtree, rbh, &rbh);
+    }
+    void
+    cx##_join(
+            type** tree,
+            type** rtree
+    )
+    {
+        int lbh;
+        int rbh;
+        int bh;
+        rb_black_height_m(type, cx##_nil_ptr, color, left, *tree, lbh);
+        rb_black_height_m(type, cx##_nil_ptr, color, left, *rtree, rbh);
+        *tree = cx##_join2_bh(*tree, lbh, *rtree, rbh, &bh);
+        *rtree = cx##_nil_ptr;
+    }
+    typedef struct {
+        type* tree;
+        int   tbh;
+        type* other;
+        int   obh;
+        type* rest;
+        int   rbh;
+        int   depth;
+    } cx##_set_t;
+    static
+    void*
+    cx##_union_task(
+            void* arg
+    )
+    {
+        cx##_set_t* s = arg;
+        cx##_set_t a;
+        cx##_set_t b;
+        type* node = s->tree;
+        type* found;
+        int bh;
+        if(s->tree == cx##_nil_ptr || s->other == cx##_nil_ptr) {
+            if(s->tree == cx##_nil_ptr) {
+                s->tree = s->other;
+                s->tbh = s->obh;
+            }
+            s->other = cx##_nil_ptr;
+            s->obh = 0;
+            s->rest = cx##_nil_ptr;
+            s->rbh = 0;
+            return NULL;
+        }
+        /* Split other at the root of tree and recurse on both sides. */
+        bh = s->tbh;
+        if(rb_is_black_m(color(node)))
+            bh -= 1;
+        a.tree = left(node);
+        b.tree = right(node);
+        if(a.tree != cx##_nil_ptr)
+            set(parent, a.tree, cx##_nil_ptr);
+        if(b.tree != cx##_nil_ptr)
+            set(parent, b.tree, cx##_nil_ptr);
+        a.tbh = bh;
+        b.tbh = bh;
+        a.depth = s->depth + 1;
+        b.depth = s->depth + 1;
+        found = cx##_split_bh(
+            s->other,
+            node,
+            &a.other,
+            &a.obh,
+            &b.other,
+            &b.obh
+        );
+        rb_fork_join(
+            cx##_union_task,
+            &a,
+            cx##_union_task,
+            &b,
+            s->depth < RB_PAR_DEPTH && bh >= RB_PAR_BH
+        );
+        s->tree = cx##_join_bh(a.tree, a.tbh, node, b.tree, b.tbh, &s->tbh);
+        s->other = cx##_nil_ptr;
+        s->obh = 0;
+        if(found != cx##_nil_ptr)
+            s->rest = cx##_join_bh(a.rest, a.rbh, found, b.rest, b.rbh, &s->rbh);
+        else
+            s->rest = cx##_join2_bh(a.rest, a.rbh, b.rest, b.rbh, &s->rbh);
+        return NULL;
+    }
+    static
+    void*
+    cx##_intersect_task(
+            void* arg
+    )
+    {
+        cx##_set_t* s = arg;
+        cx##_set_t a;
+        cx##_set_t b;
+        type* node = s->tree;
+        type* found;
+        int bh;
+        if(s->tree == cx##_nil_ptr || s->other == cx##_nil_ptr) {
+            s->rest = s->tree;
+            s->rbh = s->tbh;
+            s->tree = cx##_nil_ptr;
+            s->tbh = 0;
+            return NULL;
+        }
+        /* Split other at the root of tree and recurse on both sides. */
+        bh = s->tbh;
+        if(rb_is_black_m(color(node)))
+            bh -= 1;
+        a.tree = left(node);
+        b.tree = right(node);
+        if(a.tree != cx##_nil_ptr)
+            set(parent, a.tree, cx##_nil_ptr);
+        if(b.tree != cx##_nil_ptr)
+            set(parent, b.tree, cx##_nil_ptr);
+        a.tbh = bh;
+        b.tbh = bh;
+        a.depth = s->depth + 1;
+        b.depth = s->depth + 1;
+        found = cx##_split_bh(
+            s->other,
+            node,
+            &a.other,
+            &a.obh,
+            &b.other,
+            &b.obh
+        );
+        rb_fork_join(
+            cx##_intersect_task,
+            &a,
+            cx##_intersect_task,
+            &b,
+            s->depth < RB_PAR_DEPTH && bh >= RB_PAR_BH
+        );
+        /* The node stays if it was found, other is joined again. */
+        if(found != cx##_nil_ptr) {
+            s->tree = cx##_join_bh(a.tree, a.tbh, node, b.tree, b.tbh, &s->tbh);
+            s->rest = cx##_join2_bh(a.rest, a.rbh, b.rest, b.rbh, &s->rbh);
+            s->other = cx##_join_bh(
+                a.other,
+                a.obh,
+                found,
+                b.other,
+                b.obh,
+                &s->obh
+            );
+        } else {
+            s->tree = cx##_join2_bh(a.tree, a.tbh, b.tree, b.tbh, &s->tbh);
+            s->rest = cx##_join_bh(a.rest, a.rbh, node, b.rest, b.rbh, &s->rbh);
+            s->other = cx##_join2_bh(a.other, a.obh, b.other, b.obh, &s->obh);
+        }
+        return NULL;
+    }
+    static
+    void
+    cx##_set_init(
+            cx##_set_t* s,
+            type* tree,
+            type* other
+    )
+    {
+        s->tree = tree;
+        s->other = other;
+        s->depth = 0;
+        rb_black_height_m(type, cx##_nil_ptr, color, left, tree, s->tbh);
+        rb_black_height_m(type, cx##_nil_ptr, color, left, other, s->obh);
+    }
+    void
+    cx##_union(
+            type** tree,
+            type** other,
+            type** rest
+    )
+    {
+        cx##_set_t s;
+        assert(*rest == cx##_nil_ptr && "The rest tree has to be empty");
+        cx##_set_init(&s, *tree, *other);
+        cx##_union_task(&s);
+        *tree = s.tree;
+        *other = s.other;
+        *rest = s.rest;
+        cx##_black_root(*tree);
+        cx##_black_root(*other);
+        cx##_black_root(*rest);
+    }
+    void
+    cx##_intersect(
+            type** tree,
+            type** other,
+            type** rest
+    )
+    {
+        cx##_set_t s;
+        assert(*rest == cx##_nil_ptr && "The rest tree has to be empty");
+        cx##_set_init(&s, *tree, *other);
+        cx##_intersect_task(&s);
+        *tree = s.tree;
+        *other = s.other;
+        *rest = s.rest;
+        cx##_black_root(*tree);
+        cx##_black_root(*other);
+        cx##_black_root(*rest);
+    }
+    void
+    cx##_difference(
+            type** tree,
+            type** other,
+            type** rest
+    )
+    {
+        cx##_set_t s;
+        assert(*rest == cx##_nil_ptr && "The rest tree has to be empty");
+        cx##_set_init(&s, *tree, *other);
+        /* The difference is the rest of the intersection. */
+        cx##_intersect_task(&s);
+        *tree = s.rest;
+        *other = s.other;
+        *rest = s.tree;
+        cx##_black_root(*tree);
+        cx##_black_root(*other);
+        cx##_black_root(*rest);
+    }
+    void
+    cx##_check_tree(type* tree)
+    {
+        int pathdepth = -1;
+        cx##_check_tree_rec(tree, 0, &pathdepth);
+    }
+    void
+    cx##_check_tree_rec(
+            type* node,
+            int depth,
+            int *pathdepth
+    ) rb_check_tree_m(
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        cmp,
+        node,
+        depth,
+        *pathdepth
+    )
+#enddef
+
+#begindef rb_bind_impl_cx_m(cx, type)
+    _rb_bind_impl_tr_m(
+        cx,
+        type,
+        cx##_color_m,
+        cx##_parent_m,
+        cx##_left_m,
+        cx##_right_m,
+        rb_lvalue_set_m,
+        rb_no_augment_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_bind_impl_m(cx, type)
+    _rb_bind_impl_tr_m(
+        cx,
+        type,
+        rb_color_m,
+        rb_parent_m,
+        rb_left_m,
+        rb_right_m,
+        rb_lvalue_set_m,
+        rb_no_augment_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_bind_cx_m(cx, type)
+    rb_bind_decl_cx_m(cx, type)
+    rb_bind_impl_cx_m(cx, type)
+#enddef
+
+#begindef rb_bind_m(cx, type)
+    rb_bind_decl_m(cx, type)
+    rb_bind_impl_m(cx, type)
+#enddef
+
+// rb_tagged_bind_impl_cx_m
+// ------------------------
+//
+// Bind rbtree functions to a context, which write the traits using
+// cx##_color_m_set, cx##_parent_m_set, cx##_left_m_set and cx##_right_m_set.
+// This only generates implementations.
+//
+// cx
+//    Name of the new context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#define rb_tagged_bind_decl_cx_m(cx, type) rb_bind_decl_cx_m(cx, type)
+
+#begindef rb_tagged_bind_impl_cx_m(cx, type)
+    _rb_bind_impl_tr_m(
+        cx,
+        type,
+        cx##_color_m,
+        cx##_parent_m,
+        cx##_left_m,
+        cx##_right_m,
+        rb_trait_set_m,
+        rb_no_augment_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_tagged_bind_cx_m(cx, type)
+    rb_tagged_bind_decl_cx_m(cx, type)
+    rb_tagged_bind_impl_cx_m(cx, type)
+#enddef
+
+// rb_pool_bind_impl_cx_m
+// ----------------------
+//
+// Bind rbtree functions to a context, which links the nodes by indexes into
+// a pool. cx##_nil_ptr is the base of the pool and not constant. Writes use
+// the setters like rb_tagged_bind_impl_cx_m.
+//
+// cx
+//    Name of the new context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#begindef rb_pool_bind_decl_cx_m(cx, type)
+    typedef type cx##_type_t;
+    typedef type cx##_iter_t;
+    extern cx##_type_t* cx##_nil_ptr;
+    _rb_bind_decl_fn_m(cx, type)
+    void
+    cx##_pool_init(
+            type* pool
+    );
+    void
+    cx##_pool_move(
+            type* pool
+    );
+#enddef
+
+#begindef rb_pool_bind_impl_cx_m(cx, type)
+    cx##_type_t* cx##_nil_ptr;
+    void
+    cx##_pool_init(
+            type* pool
+    )
+    {
+        cx##_nil_ptr = pool;
+        cx##_node_init(pool);
+    }
+    void
+    cx##_pool_move(
+            type* pool
+    )
+    {
+        cx##_nil_ptr = pool;
+    }
+    _rb_bind_impl_fn_tr_m(
+        cx,
+        type,
+        cx##_color_m,
+        cx##_parent_m,
+        cx##_left_m,
+        cx##_right_m,
+        rb_trait_set_m,
+        rb_no_augment_m,
+        cx##_cmp_m
+    )
+    _rb_size_impl_tr_m(cx, type, cx##_left_m, cx##_right_m)
+#enddef
+
+#begindef rb_pool_bind_cx_m(cx, type)
+    rb_pool_bind_decl_cx_m(cx, type)
+    rb_pool_bind_impl_cx_m(cx, type)
+#enddef
+
+// rb_multi_bind_impl_m
+// --------------------
+//
+// Bind multiset functions to a context. Equal nodes are allowed, an equal
+// node is inserted after the equal nodes in the tree.
+//
+// rb_multi_bind_impl_m uses the standard traits: rb_color_m, rb_parent_m,
+// rb_left_m, rb_right_m, whereas rb_multi_bind_impl_cx_m expects you to
+// create: cx##_color_m, cx##_parent_m, cx##_left_m, cx##_right_m and the
+// setters.
+//
+// cx
+//    Name of the new context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#begindef rb_multi_bind_decl_cx_m(cx, type)
+    rb_new_context_m(cx, type)
+    void
+    cx##_tree_init(
+            type** tree
+    );
+    void
+    cx##_node_init(
+            type* node
+    );
+    void
+    cx##_iter_init(
+            type* tree,
+            cx##_iter_t** iter,
+            type** elem
+    );
+    void
+    cx##_iter_next(
+            cx##_iter_t* iter,
+            type** elem
+    );
+    void
+    cx##_iter_init_last(
+            type* tree,
+            cx##_iter_t** iter,
+            type** elem
+    );
+    void
+    cx##_iter_prev(
+            cx##_iter_t* iter,
+            type** elem
+    );
+    void
+    cx##_insert(
+            type** tree,
+            type* node
+    );
+    void
+    cx##_delete_node(
+            type** tree,
+            type* node
+    );
+    int
+    cx##_delete(
+            type** tree,
+            type* key
+    );
+    void
+    cx##_clear(
+            type** tree,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    );
+    int
+    cx##_find(
+            type* tree,
+            type* key,
+            type** node
+    );
+    int
+    cx##_lower_bound(
+            type* tree,
+            type* key,
+            type** node
+    );
+    int
+    cx##_upper_bound(
+            type* tree,
+            type* key,
+            type** node
+    );
+    int
+    cx##_equal_range(
+            type* tree,
+            type* key,
+            type** first,
+            type** last
+    );
+    RB_SIZE_T
+    cx##_count_equal(
+            type* tree,
+            type* key
+    );
+    RB_SIZE_T
+    cx##_delete_all_equal(
+            type** tree,
+            type* key,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    );
+    RB_SIZE_T
+    cx##_size(
+            type* tree
+    );
+    void
+    cx##_check_tree(type* tree);
+    void
+    cx##_check_tree_rec(
+            type* node,
+            int depth,
+            int *pathdepth
+    );
+#enddef
+#define rb_multi_bind_decl_m(cx, type) rb_multi_bind_decl_cx_m(cx, type)
+
+#begindef _rb_multi_bind_impl_tr_m(
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        cmp
+)
+    cx##_type_t cx##_nil_mem;
+    cx##_type_t* const cx##_nil_ptr = &cx##_nil_mem;
+    void
+    cx##_tree_init(
+            type** tree
+    )
+    {
+        cx##_node_init(cx##_nil_ptr);
+        *tree = cx##_nil_ptr;
+    }
+    void
+    cx##_node_init(
+            type* node
+    )
+    {
+        _rb_node_init_m(
+                cx##_nil_ptr,
+                color,
+                parent,
+                left,
+                right,
+                set,
+                node
+        );
+    }
+    void
+    cx##_iter_init(
+            type* tree,
+            cx##_iter_t** iter,
+            type** elem
+    )
+    {
+        (void)(iter);
+        rb_iter_init_m(
+            cx##_nil_ptr,
+            left,
+            tree,
+            *elem
+        );
+    }
+    void
+    cx##_iter_next(
+            cx##_iter_t* iter,
+            type** elem
+    )
+    {
+        (void)(iter);
+        rb_iter_next_m(
+            cx##_nil_ptr,
+            type,
+            parent,
+            left,
+            right,
+            *elem
+        )
+    }
+    void
+    cx##_iter_init_last(
+            type* tree,
+            cx##_iter_t** iter,
+            type** elem
+    )
+    {
+        (void)(iter);
+        rb_iter_init_m(
+            cx##_nil_ptr,
+            right, /* Switched */
+            tree,
+            *elem
+        );
+    }
+    void
+    cx##_iter_prev(
+            cx##_iter_t* iter,
+            type** elem
+    )
+    {
+        (void)(iter);
+        rb_iter_next_m(
+            cx##_nil_ptr,
+            type,
+            parent,
+            right, /* Switched */
+            left, /* Switched */
+            *elem
+        )
+    }
+    void
+    cx##_insert(
+            type** tree,
+            type* node
+    ) rb_multi_insert_m(
+        type,
+        cx##_nil_ptr,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        rb_no_augment_m,
+        cmp,
+        *tree,
+        node
+    )
+    void
+    cx##_delete_node(
+            type** tree,
+            type* node
+    ) rb_delete_node_m(
+        type,
+        cx##_nil_ptr,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        rb_no_augment_m,
+        *tree,
+        node
+    )
+    int
+    cx##_delete(
+            type** tree,
+            type* key
+    )
+    {
+        type* node;
+        if(cx##_find(*tree, key, &node) == 0) {
+            cx##_delete_node(tree, node);
+            return 0;
+        }
+        return 1;
+    }
+    void
+    cx##_clear(
+            type** tree,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    ) rb_clear_m(
+        type,
+        cx##_nil_ptr,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        *tree,
+        callback,
+        ctx
+    )
+    int
+    cx##_find(
+            type* tree,
+            type* key,
+            type** node
+    )
+    {
+        rb_find_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            cmp,
+            tree,
+            key,
+            *node
+        );
+        return *node == cx##_nil_ptr;
+    }
+    int
+    cx##_lower_bound(
+            type* tree,
+            type* key,
+            type** node
+    )
+    {
+        rb_bound_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            cmp,
+            tree,
+            key,
+            *node,
+            >=
+        );
+        return *node == cx##_nil_ptr;
+    }
+    int
+    cx##_upper_bound(
+            type* tree,
+            type* key,
+            type** node
+    )
+    {
+        rb_bound_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            cmp,
+            tree,
+            key,
+            *node,
+            >
+        );
+        return *node == cx##_nil_ptr;
+    }
+    int
+    cx##_equal_range(
+            type* tree,
+            type* key,
+            type** first,
+            type** last
+    )
+    {
+        cx##_lower_bound(tree, key, first);
+        if(*first == cx##_nil_ptr || cmp((*first), (key)) != 0) {
+            *first = cx##_nil_ptr;
+            *last = cx##_nil_ptr;
+            return 1;
+        }
+        rb_bound_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            right, /* Switched */
+            left, /* Switched */
+            cmp,
+            tree,
+            key,
+            *last,
+            <=
+        );
+        return 0;
+    }
+    RB_SIZE_T
+    cx##_count_equal(
+            type* tree,
+            type* key
+    )
+    {
+        type* elem;
+        type* last;
+        RB_SIZE_T count = 0;
+        if(cx##_equal_range(tree, key, &elem, &last) != 0)
+            return 0;
+        for(;;) {
+            count += 1;
+            if(elem == last)
+                break;
+            cx##_iter_next(NULL, &elem);
+        }
+        return count;
+    }
+    static
+    type*
+    cx##_join_bh(
+            type* ltree,
+            int lbh,
+            type* node,
+            type* rtree,
+            int rbh,
+            int* bh
+    )
+    {
+        type* tree;
+        _rb_join_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            rb_no_augment_m,
+            ltree,
+            lbh,
+            node,
+            rtree,
+            rbh,
+            tree,
+            *bh
+        );
+        return tree;
+    }
+    static
+    int
+    cx##_split_lt_cmp(
+            type* x,
+            type* key
+    )
+    {
+        /* Never equal: the nodes equal to key go to the right tree. */
+        return cmp((x), (key)) < 0 ? -1 : 1;
+    }
+    static
+    int
+    cx##_split_le_cmp(
+            type* x,
+            type* key
+    )
+    {
+        /* Never equal: the nodes equal to key go to the left tree. */
+        return cmp((x), (key)) <= 0 ? -1 : 1;
+    }
+    RB_SIZE_T
+    cx##_delete_all_equal(
+            type** tree,
+            type* key,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    )
+    {
+        type* ltree;
+        type* mtree;
+        type* etree;
+        type* rtree;
+        type* node;
+        type* found;
+        int lbh;
+        int mbh;
+        int ebh;
+        int rbh;
+        int bh;
+        RB_SIZE_T count = cx##_count_equal(*tree, key);
+        if(count == 0)
+            return 0;
+        /* Split off the nodes less than key, then the nodes greater. */
+        rb_split_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            cx##_split_lt_cmp,
+            cx##_join_bh,
+            *tree,
+            key,
+            ltree,
+            lbh,
+            mtree,
+            mbh,
+            found
+        );
+        rb_split_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            cx##_split_le_cmp,
+            cx##_join_bh,
+            mtree,
+            key,
+            etree,
+            ebh,
+            rtree,
+            rbh,
+            found
+        );
+        (void)(found);
+        (void)(mbh);
+        (void)(ebh);
+        rb_clear_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            etree,
+            callback,
+            ctx
+        );
+        if(rtree == cx##_nil_ptr) {
+            *tree = ltree;
+            return count;
+        }
+        /* The least node of rtree joins the outer trees. */
+        node = rtree;
+        while(left(node) != cx##_nil_ptr)
+            node = left(node);
+        cx##_delete_node(&rtree, node);
+        rb_black_height_m(type, cx##_nil_ptr, color, left, rtree, rbh);
+        *tree = cx##_join_bh(ltree, lbh, node, rtree, rbh, &bh);
+        return count;
+    }
+    RB_SIZE_T
+    cx##_size(
+            type* tree
+    )
+    {
+        if(tree == cx##_nil_ptr)
+            return 0;
+        else
+            return (
+                cx##_size(left(tree)) +
+                cx##_size(right(tree)) + 1
+            );
+    }
+    static
+    int
+    cx##_child_cmp(
+            type* x,
+            type* y
+    )
+    {
+        return x == left(y) ? -1 : 1;
+    }
+    void
+    cx##_check_tree(type* tree)
+    {
+        int pathdepth = -1;
+        type* elem;
+        type* prev = NULL;
+        cx##_check_tree_rec(tree, 0, &pathdepth);
+        /* Equal nodes can be on both sides, so we check the order here. */
+        cx##_iter_init(tree, NULL, &elem);
+        while(elem != NULL) {
+            if(prev != NULL)
+                assert(cmp((prev), (elem)) <= 0);
+            prev = elem;
+            cx##_iter_next(NULL, &elem);
+        }
+    }
+    void
+    cx##_check_tree_rec(
+            type* node,
+            int depth,
+            int *pathdepth
+    ) rb_check_tree_m(
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        cx##_child_cmp,
+        node,
+        depth,
+        *pathdepth
+    )
+#enddef
+
+#begindef rb_multi_bind_impl_cx_m(cx, type)
+    _rb_multi_bind_impl_tr_m(
+        cx,
+        type,
+        cx##_color_m,
+        cx##_parent_m,
+        cx##_left_m,
+        cx##_right_m,
+        rb_trait_set_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_multi_bind_impl_m(cx, type)
+    _rb_multi_bind_impl_tr_m(
+        cx,
+        type,
+        rb_color_m,
+        rb_parent_m,
+        rb_left_m,
+        rb_right_m,
+        rb_lvalue_set_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_multi_bind_cx_m(cx, type)
+    rb_multi_bind_decl_cx_m(cx, type)
+    rb_multi_bind_impl_cx_m(cx, type)
+#enddef
+
+#begindef rb_multi_bind_m(cx, type)
+    rb_multi_bind_decl_m(cx, type)
+    rb_multi_bind_impl_m(cx, type)
+#enddef
+
+// rb_key_bind_impl_m
+// ------------------
+//
+// Bind key lookups to an existing context. Expects you to create
+// cx##_key_m and cx##_key_cmp_m. This only generates implementations.
+//
+// rb_key_bind_impl_m uses the standard traits: rb_left_m, rb_right_m, whereas
+// rb_key_bind_impl_cx_m expects you to create: cx##_left_m, cx##_right_m.
+//
+// cx
+//    Name of the context, it has to be bound already.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// ktype
+//    The type of the keys, it is passed by value.
+//
+// .. code-block:: cpp
+//
+#begindef rb_key_bind_decl_cx_m(cx, type, ktype)
+    int
+    cx##_find_key(
+            type* tree,
+            ktype key,
+            type** node
+    );
+    int
+    cx##_lower_bound_key(
+            type* tree,
+            ktype key,
+            type** node
+    );
+    int
+    cx##_delete_key(
+            type** tree,
+            ktype key
+    );
+#enddef
+
+#begindef rb_key_bind_decl_m(cx, type, ktype)
+    rb_key_bind_decl_cx_m(cx, type, ktype)
+#enddef
+
+#begindef _rb_key_bind_impl_tr_m(
+        cx,
+        type,
+        ktype,
+        left,
+        right
+)
+    int
+    cx##_find_key(
+            type* tree,
+            ktype key,
+            type** node
+    )
+    {
+        rb_find_key_m(
+            type,
+            cx##_nil_ptr,
+            left,
+            right,
+            cx##_key_m,
+            cx##_key_cmp_m,
+            tree,
+            key,
+            *node
+        );
+        return *node == cx##_nil_ptr;
+    }
+    int
+    cx##_lower_bound_key(
+            type* tree,
+            ktype key,
+            type** node
+    )
+    {
+        rb_bound_key_m(
+            type,
+            cx##_nil_ptr,
+            left,
+            right,
+            cx##_key_m,
+            cx##_key_cmp_m,
+            tree,
+            key,
+            *node,
+            >=
+        );
+        return *node == cx##_nil_ptr;
+    }
+    int
+    cx##_delete_key(
+            type** tree,
+            ktype key
+    )
+    {
+        type* node;
+        if(cx##_find_key(*tree, key, &node) == 0) {
+            cx##_delete_node(tree, node);
+            return 0;
+        }
+        return 1;
+    }
+#enddef
+
+#begindef rb_key_bind_impl_cx_m(cx, type, ktype)
+    _rb_key_bind_impl_tr_m(
+        cx,
+        type,
+        ktype,
+        cx##_left_m,
+        cx##_right_m
+    )
+#enddef
+
+#begindef rb_key_bind_impl_m(cx, type, ktype)
+    _rb_key_bind_impl_tr_m(
+        cx,
+        type,
+        ktype,
+        rb_left_m,
+        rb_right_m
+    )
+#enddef
+
+#begindef rb_key_bind_cx_m(cx, type, ktype)
+    rb_key_bind_decl_cx_m(cx, type, ktype)
+    rb_key_bind_impl_cx_m(cx, type, ktype)
+#enddef
+
+#begindef rb_key_bind_m(cx, type, ktype)
+    rb_key_bind_decl_m(cx, type, ktype)
+    rb_key_bind_impl_m(cx, type, ktype)
+#enddef
+
+// rb_frozen_bind_impl_m
+// ---------------------
+//
+// Bind read-only snapshots to an existing context. Expects cx##_key_m and
+// cx##_key_cmp_m like rb_key_bind_impl_m.
+//
+// cx##_freeze copies the keys and the nodes in Eytzinger order: the root is
+// at index 1 and the children of k are at 2k and 2k + 1. The first levels
+// of all searches share a few cache lines and the descent has no branch
+// depending on the keys. The keys are 64-byte aligned and we prefetch the
+// cache line of the descendants four levels ahead (for 4-byte keys), as long
+// as it is inside the array. The snapshot doesn't follow changes of the tree.
+//
+// cx
+//    Name of the context, it has to be bound already.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// ktype
+//    The type of the keys, they are copied into the snapshot.
+//
+// .. code-block:: cpp
+//
+static inline
+size_t
+rb_eytzinger_up(size_t k)
+{
+    /* Return to the node where the search last went left. */
+#if defined(__GNUC__) || defined(__clang__)
+    return k >> (__builtin_ctzll(~(unsigned long long) k) + 1);
+#else
+    while(k & 1)
+        k >>= 1;
+    return k >> 1;
+#endif
+}
+
+#begindef rb_eytzinger_lower_bound_m(type, ktype, key_cmp, keys, n, key, k)
+{
+    size_t __rb_eytz_ahead_ = 64 / sizeof(ktype);
+    if(__rb_eytz_ahead_ == 0)
+        __rb_eytz_ahead_ = 1;
+    k = 1;
+    while(k <= n) {
+        size_t __rb_eytz_pf_ = __rb_eytz_ahead_ * k;
+        rb_prefetch_m(keys + (__rb_eytz_pf_ <= n ? __rb_eytz_pf_ : n));
+        k = 2 * k + (key_cmp((keys[k]), (key)) < 0);
+    }
+    k = rb_eytzinger_up(k);
+}
+#enddef
+
+#begindef rb_frozen_bind_decl_cx_m(cx, type, ktype)
+    typedef struct {
+        ktype*  keys;
+        type**  nodes;
+        size_t  n;
+    } cx##_frozen_t;
+    int
+    cx##_freeze(
+            type* tree,
+            cx##_frozen_t* frozen
+    );
+    int
+    cx##_frozen_find(
+            cx##_frozen_t* frozen,
+            ktype key,
+            type** node
+    );
+    int
+    cx##_frozen_lower_bound(
+            cx##_frozen_t* frozen,
+            ktype key,
+            type** node
+    );
+    void
+    cx##_frozen_free(
+            cx##_frozen_t* frozen
+    );
+#enddef
+
+#begindef rb_frozen_bind_decl_m(cx, type, ktype)
+    rb_frozen_bind_decl_cx_m(cx, type, ktype)
+#enddef
+
+#begindef _rb_frozen_bind_impl_tr_m(cx, type, ktype, search)
+    int
+    cx##_freeze(
+            type* tree,
+            cx##_frozen_t* frozen
+    )
+    {
+        size_t n = 0;
+        size_t k = 1;
+        void* mem;
+        rb_iter_decl_cx_m(cx, iter, elem);
+        rb_for_m(cx, tree, iter, elem) {
+            n += 1;
+        }
+        frozen->n = n;
+        /* Align the keys, the levels start at cache line boundaries. */
+        if(posix_memalign(&mem, 64, (n + 1) * sizeof(ktype)) != 0)
+            mem = NULL;
+        frozen->keys = mem;
+        frozen->nodes = malloc((n + 1) * sizeof(type*));
+        if(frozen->keys == NULL || frozen->nodes == NULL) {
+            cx##_frozen_free(frozen);
+            return 1;
+        }
+        /* Walk the tree and the implicit tree in-order together. */
+        while(2 * k <= n)
+            k *= 2;
+        rb_for_m(cx, tree, iter, elem) {
+            frozen->keys[k] = cx##_key_m(elem);
+            frozen->nodes[k] = elem;
+            if(2 * k + 1 <= n) {
+                k = 2 * k + 1;
+                while(2 * k <= n)
+                    k *= 2;
+            } else
+                k = rb_eytzinger_up(k);
+        }
+        return 0;
+    }
+    int
+    cx##_frozen_lower_bound(
+            cx##_frozen_t* frozen,
+            ktype key,
+            type** node
+    )
+    {
+        size_t k;
+        search(
+            type,
+            ktype,
+            cx##_key_cmp_m,
+            frozen->keys,
+            frozen->n,
+            key,
+            k
+        );
+        *node = k == 0 ? cx##_nil_ptr : frozen->nodes[k];
+        return k == 0;
+    }
+    int
+    cx##_frozen_find(
+            cx##_frozen_t* frozen,
+            ktype key,
+            type** node
+    )
+    {
+        size_t k;
+        search(
+            type,
+            ktype,
+            cx##_key_cmp_m,
+            frozen->keys,
+            frozen->n,
+            key,
+            k
+        );
+        if(k == 0 || cx##_key_cmp_m((frozen->keys[k]), (key)) != 0) {
+            *node = cx##_nil_ptr;
+            return 1;
+        }
+        *node = frozen->nodes[k];
+        return 0;
+    }
+    void
+    cx##_frozen_free(
+            cx##_frozen_t* frozen
+    )
+    {
+        free(frozen->keys);
+        free(frozen->nodes);
+        frozen->keys = NULL;
+        frozen->nodes = NULL;
+        frozen->n = 0;
+    }
+#enddef
+
+#begindef rb_frozen_bind_impl_m(cx, type, ktype)
+    _rb_frozen_bind_impl_tr_m(cx, type, ktype, rb_eytzinger_lower_bound_m)
+#enddef
+
+#begindef rb_frozen_bind_impl_cx_m(cx, type, ktype)
+    rb_frozen_bind_impl_m(cx, type, ktype)
+#enddef
+
+#begindef rb_frozen_bind_m(cx, type, ktype)
+    rb_frozen_bind_decl_m(cx, type, ktype)
+    rb_frozen_bind_impl_m(cx, type, ktype)
+#enddef
+
+#define rb_frozen_bind_cx_m(cx, type, ktype) rb_frozen_bind_m(cx, type, ktype)
+
+// rb_frozen_int_bind_impl_m
+// -------------------------
+//
+// Only defined if RB_FROZEN_SIMD is defined before rbtree.h is included, so
+// the intrinsics are not included everywhere. Same as rb_frozen_bind_impl_m
+// for int32_t or int64_t keys in their natural order, cx##_key_cmp_m isn't
+// used for the search. With AVX2 (-mavx2, -march=native) it compares the 15
+// keys of the next four levels (three for int64_t) at once and counts the
+// smaller ones, which is the index of the node four levels down. The loads of
+// the levels don't depend on each other. With SSE2 (int32_t) or SSE4.2
+// (int64_t) it does three or two levels, else the scalar loop.
+//
+// .. code-block:: cpp
+//
+#ifdef RB_FROZEN_SIMD
+#if defined(__GNUC__) || defined(__clang__)
+#   define rb_popcount_m(x) __builtin_popcount(x)
+#   if defined(__AVX2__) || defined(__SSE2__)
+#       include <immintrin.h>
+#   endif
+#endif
+
+static inline
+size_t
+rb_eytzinger_i32(const int32_t* keys, size_t n, int32_t key)
+{
+    size_t k = 1;
+#if defined(rb_popcount_m) && defined(__AVX2__)
+    __m256i vkey = _mm256_set1_epi32(key);
+    while(8 * k + 7 <= n) {
+        /* The keys of level four and three below k are contiguous. */
+        __m256i v8 = _mm256_loadu_si256((const __m256i*) (keys + 8 * k));
+        __m128i v4 = _mm_loadu_si128((const __m128i*) (keys + 4 * k));
+        int m8 = _mm256_movemask_ps(
+            _mm256_castsi256_ps(_mm256_cmpgt_epi32(vkey, v8))
+        );
+        int m4 = _mm_movemask_ps(
+            _mm_castsi128_ps(_mm_cmpgt_epi32(_mm256_castsi256_si128(vkey), v4))
+        );
+        k = 16 * k + rb_popcount_m(m8) + rb_popcount_m(m4) +
+            (keys[2 * k] < key) + (keys[2 * k + 1] < key) + (keys[k] < key);
+    }
+#elif defined(rb_popcount_m) && defined(__SSE2__)
+    __m128i vkey = _mm_set1_epi32(key);
+    while(4 * k + 3 <= n) {
+        __m128i v4 = _mm_loadu_si128((const __m128i*) (keys + 4 * k));
+        int m4 = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(vkey, v4)));
+        k = 8 * k + rb_popcount_m(m4) +
+            (keys[2 * k] < key) + (keys[2 * k + 1] < key) + (keys[k] < key);
+    }
+#endif
+    while(k <= n)
+        k = 2 * k + (keys[k] < key);
+    return rb_eytzinger_up(k);
+}
+
+static inline
+size_t
+rb_eytzinger_i64(const int64_t* keys, size_t n, int64_t key)
+{
+    size_t k = 1;
+#if defined(rb_popcount_m) && defined(__AVX2__)
+    __m256i vkey = _mm256_set1_epi64x(key);
+    while(4 * k + 3 <= n) {
+        __m256i v4 = _mm256_loadu_si256((const __m256i*) (keys + 4 * k));
+        int m4 = _mm256_movemask_pd(
+            _mm256_castsi256_pd(_mm256_cmpgt_epi64(vkey, v4))
+        );
+        k = 8 * k + rb_popcount_m(m4) +
+            (keys[2 * k] < key) + (keys[2 * k + 1] < key) + (keys[k] < key);
+    }
+#elif defined(rb_popcount_m) && defined(__SSE4_2__)
+    __m128i vkey = _mm_set1_epi64x(key);
+    while(2 * k + 1 <= n) {
+        __m128i v2 = _mm_loadu_si128((const __m128i*) (keys + 2 * k));
+        int m2 = _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(vkey, v2)));
+        k = 4 * k + rb_popcount_m(m2) + (keys[k] < key);
+    }
+#endif
+    while(k <= n)
+        k = 2 * k + (keys[k] < key);
+    return rb_eytzinger_up(k);
+}
+
+#begindef rb_eytzinger_int_lower_bound_m(type, ktype, key_cmp, keys, n, key, k)
+{
+    assert((sizeof(ktype) == 4 || sizeof(ktype) == 8) && "Not an int key");
+    if(sizeof(ktype) == 4)
+        k = rb_eytzinger_i32(
+            (const int32_t*) (const void*) (keys), n, (int32_t) (key)
+        );
+    else
+        k = rb_eytzinger_i64(
+            (const int64_t*) (const void*) (keys), n, (int64_t) (key)
+        );
+}
+#enddef
+
+#begindef rb_frozen_int_bind_impl_m(cx, type, ktype)
+    _rb_frozen_bind_impl_tr_m(cx, type, ktype, rb_eytzinger_int_lower_bound_m)
+#enddef
+
+#begindef rb_frozen_int_bind_m(cx, type, ktype)
+    rb_frozen_bind_decl_m(cx, type, ktype)
+    rb_frozen_int_bind_impl_m(cx, type, ktype)
+#enddef
+#endif // RB_FROZEN_SIMD
+
+// rb_child_bind_impl_m
+// --------------------
+//
+// Bind rbtree functions to a context, whose nodes keep the children in an
+// array. The descents in cx##_insert, cx##_find, cx##_lower_bound and
+// cx##_upper_bound index the array and don't branch on the comparison.
+//
+// rb_child_bind_impl_m uses the standard traits: rb_color_m, rb_parent_m,
+// rb_child_m, rb_child_left_m, rb_child_right_m, whereas
+// rb_child_bind_impl_cx_m expects you to create: cx##_color_m, cx##_parent_m,
+// cx##_child_m, cx##_left_m, cx##_right_m and the setters.
+//
+// cx
+//    Name of the new context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#begindef rb_child_bind_decl_cx_m(cx, type)
+    rb_new_context_m(cx, type)
+    void
+    cx##_tree_init(
+            type** tree
+    );
+    void
+    cx##_node_init(
+            type* node
+    );
+    void
+    cx##_iter_init(
+            type* tree,
+            cx##_iter_t** iter,
+            type** elem
+    );
+    void
+    cx##_iter_next(
+            cx##_iter_t* iter,
+            type** elem
+    );
+    void
+    cx##_iter_init_last(
+            type* tree,
+            cx##_iter_t** iter,
+            type** elem
+    );
+    void
+    cx##_iter_prev(
+            cx##_iter_t* iter,
+            type** elem
+    );
+    int
+    cx##_insert(
+            type** tree,
+            type* node
+    );
+    void
+    cx##_delete_node(
+            type** tree,
+            type* node
+    );
+    int
+    cx##_delete(
+            type** tree,
+            type* key
+    );
+    void
+    cx##_clear(
+            type** tree,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    );
+    int
+    cx##_find(
+            type* tree,
+            type* key,
+            type** node
+    );
+    int
+    cx##_lower_bound(
+            type* tree,
+            type* key,
+            type** node
+    );
+    int
+    cx##_upper_bound(
+            type* tree,
+            type* key,
+            type** node
+    );
+    RB_SIZE_T
+    cx##_size(
+            type* tree
+    );
+    void
+    cx##_check_tree(type* tree);
+    void
+    cx##_check_tree_rec(
+            type* node,
+            int depth,
+            int *pathdepth
+    );
+#enddef
+#define rb_child_bind_decl_m(cx, type) rb_child_bind_decl_cx_m(cx, type)
+
+#begindef _rb_child_bind_impl_tr_m(
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        child,
+        set,
+        cmp
+)
+    cx##_type_t cx##_nil_mem;
+    cx##_type_t* const cx##_nil_ptr = &cx##_nil_mem;
+    void
+    cx##_tree_init(
+            type** tree
+    )
+    {
+        cx##_node_init(cx##_nil_ptr);
+        *tree = cx##_nil_ptr;
+    }
+    void
+    cx##_node_init(
+            type* node
+    )
+    {
+        _rb_node_init_m(
+                cx##_nil_ptr,
+                color,
+                parent,
+                left,
+                right,
+                set,
+                node
+        );
+    }
+    void
+    cx##_iter_init(
+            type* tree,
+            cx##_iter_t** iter,
+            type** elem
+    )
+    {
+        (void)(iter);
+        rb_iter_init_m(
+            cx##_nil_ptr,
+            left,
+            tree,
+            *elem
+        );
+    }
+    void
+    cx##_iter_next(
+            cx##_iter_t* iter,
+            type** elem
+    )
+    {
+        (void)(iter);
+        rb_iter_next_m(
+            cx##_nil_ptr,
+            type,
+            parent,
+            left,
+            right,
+            *elem
+        )
+    }
+    void
+    cx##_iter_init_last(
+            type* tree,
+            cx##_iter_t** iter,
+            type** elem
+    )
+    {
+        (void)(iter);
+        rb_iter_init_m(
+            cx##_nil_ptr,
+            right, /* Switched */
+            tree,
+            *elem
+        );
+    }
+    void
+    cx##_iter_prev(
+            cx##_iter_t* iter,
+            type** elem
+    )
+    {
+        (void)(iter);
+        rb_iter_next_m(
+            cx##_nil_ptr,
+            type,
+            parent,
+            right, /* Switched */
+            left, /* Switched */
+            *elem
+        )
+    }
+    int
+    cx##_insert(
+            type** tree,
+            type* node
+    )
+    {
+        int ret;
+        rb_child_insert_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            child,
+            set,
+            cmp,
+            *tree,
+            node,
+            ret
+        );
+        return ret;
+    }
+    void
+    cx##_delete_node(
+            type** tree,
+            type* node
+    ) rb_delete_node_m(
+        type,
+        cx##_nil_ptr,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        rb_no_augment_m,
+        *tree,
+        node
+    )
+    int
+    cx##_delete(
+            type** tree,
+            type* key
+    )
+    {
+        type* node;
+        if(cx##_find(*tree, key, &node) == 0) {
+            cx##_delete_node(tree, node);
+            return 0;
+        }
+        return 1;
+    }
+    void
+    cx##_clear(
+            type** tree,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    ) rb_clear_m(
+        type,
+        cx##_nil_ptr,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        *tree,
+        callback,
+        ctx
+    )
+    int
+    cx##_find(
+            type* tree,
+            type* key,
+            type** node
+    )
+    {
+        rb_child_find_m(
+            type,
+            cx##_nil_ptr,
+            child,
+            cmp,
+            tree,
+            key,
+            *node
+        );
+        return *node == cx##_nil_ptr;
+    }
+    int
+    cx##_lower_bound(
+            type* tree,
+            type* key,
+            type** node
+    )
+    {
+        rb_child_bound_m(
+            type,
+            cx##_nil_ptr,
+            child,
+            cmp,
+            tree,
+            key,
+            *node,
+            >=
+        );
+        return *node == cx##_nil_ptr;
+    }
+    int
+    cx##_upper_bound(
+            type* tree,
+            type* key,
+            type** node
+    )
+    {
+        rb_child_bound_m(
+            type,
+            cx##_nil_ptr,
+            child,
+            cmp,
+            tree,
+            key,
+            *node,
+            >
+        );
+        return *node == cx##_nil_ptr;
+    }
+    RB_SIZE_T
+    cx##_size(
+            type* tree
+    )
+    {
+        if(tree == cx##_nil_ptr)
+            return 0;
+        else
+            return (
+                cx##_size(left(tree)) +
+                cx##_size(right(tree)) + 1
+            );
+    }
+    void
+    cx##_check_tree(type* tree)
+    {
+        int pathdepth = -1;
+        cx##_check_tree_rec(tree, 0, &pathdepth);
+    }
+    void
+    cx##_check_tree_rec(
+            type* node,
+            int depth,
+            int *pathdepth
+    ) rb_check_tree_m(
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        cmp,
+        node,
+        depth,
+        *pathdepth
+    )
+#enddef
+
+#begindef rb_child_bind_impl_cx_m(cx, type)
+    _rb_child_bind_impl_tr_m(
+        cx,
+        type,
+        cx##_color_m,
+        cx##_parent_m,
+        cx##_left_m,
+        cx##_right_m,
+        cx##_child_m,
+        rb_trait_set_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_child_bind_impl_m(cx, type)
+    _rb_child_bind_impl_tr_m(
+        cx,
+        type,
+        rb_color_m,
+        rb_parent_m,
+        rb_child_left_m,
+        rb_child_right_m,
+        rb_child_m,
+        rb_lvalue_set_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_child_bind_cx_m(cx, type)
+    rb_child_bind_decl_cx_m(cx, type)
+    rb_child_bind_impl_cx_m(cx, type)
+#enddef
+
+#begindef rb_child_bind_m(cx, type)
+    rb_child_bind_decl_m(cx, type)
+    rb_child_bind_impl_m(cx, type)
+#enddef
+
+// rb_aug_bind_impl_m
+// ------------------
+//
+// Bind rbtree functions to a context, which are augmented by cx##_augment_m.
+// This only generates implementations. cx##_augment is generated from
+// cx##_augment_m by rb_augment_path_m and passed as augment trait to the
+// rbtree functions.
+//
+// rb_aug_bind_impl_m uses the standard traits: rb_color_m, rb_parent_m,
+// rb_left_m, rb_right_m, whereas rb_aug_bind_impl_cx_m expects you to create:
+// cx##_color_m, cx##_parent_m, cx##_left_m, cx##_right_m. Both expect you to
+// create cx##_augment_m.
+//
+// cx
+//    Name of the new context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#begindef _rb_aug_bind_impl_tr_m(
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        update,
+        cmp
+)
+    static
+    void
+    cx##_augment(
+            type* node,
+            type* stop
+    ) rb_augment_path_m(
+        parent,
+        update,
+        node,
+        stop
+    )
+    _rb_bind_impl_tr_m(
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        cx##_augment,
+        cmp
+    )
+#enddef
+
+#define rb_aug_bind_decl_m(cx, type) rb_bind_decl_m(cx, type)
+#define rb_aug_bind_decl_cx_m(cx, type) rb_bind_decl_cx_m(cx, type)
+
+#begindef rb_aug_bind_impl_cx_m(cx, type)
+    _rb_aug_bind_impl_tr_m(
+        cx,
+        type,
+        cx##_color_m,
+        cx##_parent_m,
+        cx##_left_m,
+        cx##_right_m,
+        rb_lvalue_set_m,
+        cx##_augment_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_aug_bind_impl_m(cx, type)
+    _rb_aug_bind_impl_tr_m(
+        cx,
+        type,
+        rb_color_m,
+        rb_parent_m,
+        rb_left_m,
+        rb_right_m,
+        rb_lvalue_set_m,
+        cx##_augment_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_aug_bind_cx_m(cx, type)
+    rb_aug_bind_decl_cx_m(cx, type)
+    rb_aug_bind_impl_cx_m(cx, type)
+#enddef
+
+#begindef rb_aug_bind_m(cx, type)
+    rb_aug_bind_decl_m(cx, type)
+    rb_aug_bind_impl_m(cx, type)
+#enddef
+
+// rb_interval_bind_decl_m
+// -----------------------
+//
+// Bind rbtree and interval tree functions to a context. This only generates
+// declarations.
+//
+// rb_interval_bind_decl_cx_m is just an alias for consistency.
+//
+// cx
+//    Name of the new context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#begindef rb_interval_bind_decl_cx_m(cx, type)
+    rb_bind_decl_cx_m(cx, type)
+    void
+    cx##_overlap_first(
+            type* tree,
+            type* key,
+            type** elem
+    );
+    void
+    cx##_overlap_next(
+            type* key,
+            type** elem
+    );
+    void
+    cx##_stab_first(
+            type* tree,
+            type* key,
+            type** elem
+    );
+    void
+    cx##_stab_next(
+            type* key,
+            type** elem
+    );
+#enddef
+#define rb_interval_bind_decl_m(cx, type) rb_interval_bind_decl_cx_m(cx, type)
+
+// rb_interval_bind_impl_m
+// -----------------------
+//
+// Bind rbtree and interval tree functions to a context. This only generates
+// implementations. The maximal end of the sub-trees is kept up to date by
+// cx##_max_augment, which is passed as augment trait to the rbtree functions.
+//
+// rb_interval_bind_impl_m uses the standard traits: rb_color_m, rb_parent_m,
+// rb_left_m, rb_right_m, rb_start_m, rb_end_m, rb_max_m, whereas
+// rb_interval_bind_impl_cx_m expects you to create: cx##_color_m,
+// cx##_parent_m, cx##_left_m, cx##_right_m, cx##_start_m, cx##_end_m,
+// cx##_max_m.
+//
+// cx
+//    Name of the new context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#begindef _rb_interval_bind_impl_tr_m(
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        start,
+        end,
+        max,
+        cmp
+)
+    static
+    void
+    cx##_max_augment(
+            type* node,
+            type* stop
+    )
+    {
+        while(node != stop) {
+            max(node) = end(node);
+            if(left(node) != cx##_nil_ptr && max(left(node)) > max(node))
+                max(node) = max(left(node));
+            if(right(node) != cx##_nil_ptr && max(right(node)) > max(node))
+                max(node) = max(right(node));
+            node = parent(node);
+        }
+    }
+    _rb_bind_impl_tr_m(
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        cx##_max_augment,
+        cmp
+    )
+    void
+    cx##_overlap_first(
+            type* tree,
+            type* key,
+            type** elem
+    ) rb_overlap_first_m(
+        type,
+        cx##_nil_ptr,
+        color,
+        parent,
+        left,
+        right,
+        start,
+        end,
+        max,
+        tree,
+        start(key),
+        end(key),
+        *elem
+    )
+    void
+    cx##_overlap_next(
+            type* key,
+            type** elem
+    ) rb_overlap_next_m(
+        type,
+        cx##_nil_ptr,
+        color,
+        parent,
+        left,
+        right,
+        start,
+        end,
+        max,
+        start(key),
+        end(key),
+        *elem
+    )
+    void
+    cx##_stab_first(
+            type* tree,
+            type* key,
+            type** elem
+    ) rb_overlap_first_m(
+        type,
+        cx##_nil_ptr,
+        color,
+        parent,
+        left,
+        right,
+        start,
+        end,
+        max,
+        tree,
+        start(key),
+        start(key),
+        *elem
+    )
+    void
+    cx##_stab_next(
+            type* key,
+            type** elem
+    ) rb_overlap_next_m(
+        type,
+        cx##_nil_ptr,
+        color,
+        parent,
+        left,
+        right,
+        start,
+        end,
+        max,
+        start(key),
+        start(key),
+        *elem
+    )
+#enddef
+
+#begindef rb_interval_bind_impl_cx_m(cx, type)
+    _rb_interval_bind_impl_tr_m(
+        cx,
+        type,
+        cx##_color_m,
+        cx##_parent_m,
+        cx##_left_m,
+        cx##_right_m,
+        rb_lvalue_set_m,
+        cx##_start_m,
+        cx##_end_m,
+        cx##_max_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_interval_bind_impl_m(cx, type)
+    _rb_interval_bind_impl_tr_m(
+        cx,
+        type,
+        rb_color_m,
+        rb_parent_m,
+        rb_left_m,
+        rb_right_m,
+        rb_lvalue_set_m,
+        rb_start_m,
+        rb_end_m,
+        rb_max_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_interval_bind_cx_m(cx, type)
+    rb_interval_bind_decl_cx_m(cx, type)
+    rb_interval_bind_impl_cx_m(cx, type)
+#enddef
+
+#begindef rb_interval_bind_m(cx, type)
+    rb_interval_bind_decl_m(cx, type)
+    rb_interval_bind_impl_m(cx, type)
+#enddef
+
+// rb_os_bind_decl_m
+// -----------------
+//
+// Bind rbtree and order statistics functions to a context. This only
+// generates declarations.
+//
+// rb_os_bind_decl_cx_m is just an alias for consistency.
+//
+// cx
+//    Name of the new context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#begindef rb_os_bind_decl_cx_m(cx, type)
+    rb_bind_decl_cx_m(cx, type)
+    RB_SIZE_T
+    cx##_rank(
+            type* tree,
+            type* key
+    );
+    RB_SIZE_T
+    cx##_rank_node(
+            type* node
+    );
+    int
+    cx##_select(
+            type* tree,
+            RB_SIZE_T index,
+            type** node
+    );
+    void
+    cx##_iter_skip(
+            cx##_iter_t* iter,
+            type** elem,
+            RB_SIZE_T count
+    );
+#enddef
+#define rb_os_bind_decl_m(cx, type) rb_os_bind_decl_cx_m(cx, type)
+
+// rb_os_bind_impl_m
+// -----------------
+//
+// Bind rbtree and order statistics functions to a context. This only
+// generates implementations. The size of the sub-trees is kept up to date by
+// cx##_size_augment, which is passed as augment trait to the rbtree
+// functions.
+//
+// rb_os_bind_impl_m uses the standard traits: rb_color_m, rb_parent_m,
+// rb_left_m, rb_right_m, rb_size_m, whereas rb_os_bind_impl_cx_m expects you
+// to create: cx##_color_m, cx##_parent_m, cx##_left_m, cx##_right_m,
+// cx##_size_m.
+//
+// cx
+//    Name of the new context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#begindef _rb_os_bind_impl_tr_m(
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        size,
+        cmp
+)
+    static
+    void
+    cx##_size_augment(
+            type* node,
+            type* stop
+    )
+    {
+        while(node != stop) {
+            size(node) = size(left(node)) + size(right(node)) + 1;
+            node = parent(node);
+        }
+    }
+    cx##_type_t cx##_nil_mem;
+    cx##_type_t* const cx##_nil_ptr = &cx##_nil_mem;
+    _rb_bind_impl_fn_tr_m(
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        cx##_size_augment,
+        cmp
+    )
+    RB_SIZE_T
+    cx##_size(
+            type* tree
+    )
+    {
+        if(tree == cx##_nil_ptr)
+            return 0;
+        else
+            return size(tree);
+    }
+    RB_SIZE_T
+    cx##_rank(
+            type* tree,
+            type* key
+    )
+    {
+        RB_SIZE_T rank;
+        rb_rank_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            size,
+            cmp,
+            tree,
+            key,
+            rank
+        );
+        return rank;
+    }
+    RB_SIZE_T
+    cx##_rank_node(
+            type* node
+    )
+    {
+        RB_SIZE_T rank;
+        rb_rank_node_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            size,
+            node,
+            rank
+        );
+        return rank;
+    }
+    int
+    cx##_select(
+            type* tree,
+            RB_SIZE_T index,
+            type** node
+    )
+    {
+        rb_select_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            size,
+            tree,
+            index,
+            *node
+        );
+        return *node == cx##_nil_ptr;
+    }
+    void
+    cx##_iter_skip(
+            cx##_iter_t* iter,
+            type** elem,
+            RB_SIZE_T count
+    )
+    {
+        (void)(iter);
+        rb_iter_skip_m(
+            type,
+            cx##_nil_ptr,
+            color,
+            parent,
+            left,
+            right,
+            size,
+            *elem,
+            count
+        );
+    }
+#enddef
+
+#begindef rb_os_bind_impl_cx_m(cx, type)
+    _rb_os_bind_impl_tr_m(
+        cx,
+        type,
+        cx##_color_m,
+        cx##_parent_m,
+        cx##_left_m,
+        cx##_right_m,
+        rb_lvalue_set_m,
+        cx##_size_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_os_bind_impl_m(cx, type)
+    _rb_os_bind_impl_tr_m(
+        cx,
+        type,
+        rb_color_m,
+        rb_parent_m,
+        rb_left_m,
+        rb_right_m,
+        rb_lvalue_set_m,
+        rb_size_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_os_bind_cx_m(cx, type)
+    rb_os_bind_decl_cx_m(cx, type)
+    rb_os_bind_impl_cx_m(cx, type)
+#enddef
+
+#begindef rb_os_bind_m(cx, type)
+    rb_os_bind_decl_m(cx, type)
+    rb_os_bind_impl_m(cx, type)
+#enddef
+
+// rb_head_bind_decl_m
+// -------------------
+//
+// Bind tree head functions to the context *hcx*. The tree head functions
+// call the functions bound to *cx*, which has to be bound to the same *type*.
+// This only generates declarations.
+//
+// rb_head_bind_decl_cx_m is just an alias for consistency.
+//
+// hcx
+//    Name of the tree head context.
+//
+// cx
+//    Name of the bound context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#begindef rb_head_bind_decl_cx_m(hcx, cx, type)
+    typedef type hcx##_type_t;
+    typedef type hcx##_iter_t;
+    extern hcx##_type_t* const hcx##_nil_ptr;
+    typedef struct {
+        type*     root;
+        RB_SIZE_T size;
+        type*     first;
+        type*     last;
+    } hcx##_tree_t;
+    void
+    hcx##_tree_init(
+            hcx##_tree_t* tree
+    );
+    void
+    hcx##_iter_init(
+            hcx##_tree_t* tree,
+            hcx##_iter_t** iter,
+            type** elem
+    );
+    void
+    hcx##_iter_next(
+            hcx##_iter_t* iter,
+            type** elem
+    );
+    void
+    hcx##_iter_init_last(
+            hcx##_tree_t* tree,
+            hcx##_iter_t** iter,
+            type** elem
+    );
+    void
+    hcx##_iter_prev(
+            hcx##_iter_t* iter,
+            type** elem
+    );
+    void
+    hcx##_range_init(
+            hcx##_tree_t* tree,
+            type* start,
+            type* end,
+            hcx##_iter_t** iter,
+            type** elem
+    );
+    void
+    hcx##_range_next(
+            hcx##_iter_t* iter,
+            type** elem
+    );
+    void
+    hcx##_node_init(
+            type* node
+    );
+    int
+    hcx##_insert(
+            hcx##_tree_t* tree,
+            type* node
+    );
+    int
+    hcx##_insert_hint(
+            hcx##_tree_t* tree,
+            type* hint,
+            type* node
+    );
+    void
+    hcx##_delete_node(
+            hcx##_tree_t* tree,
+            type* node
+    );
+    int
+    hcx##_delete(
+            hcx##_tree_t* tree,
+            type* key
+    );
+    void
+    hcx##_clear(
+            hcx##_tree_t* tree,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    );
+    int
+    hcx##_replace_node(
+            hcx##_tree_t* tree,
+            type* old,
+            type* new
+    );
+    int
+    hcx##_replace(
+            hcx##_tree_t* tree,
+            type* key,
+            type* new
+    );
+    int
+    hcx##_find(
+            hcx##_tree_t* tree,
+            type* key,
+            type** node
+    );
+    int
+    hcx##_lower_bound(
+            hcx##_tree_t* tree,
+            type* key,
+            type** node
+    );
+    int
+    hcx##_upper_bound(
+            hcx##_tree_t* tree,
+            type* key,
+            type** node
+    );
+    int
+    hcx##_floor(
+            hcx##_tree_t* tree,
+            type* key,
+            type** node
+    );
+    int
+    hcx##_ceil(
+            hcx##_tree_t* tree,
+            type* key,
+            type** node
+    );
+    void
+    hcx##_build_sorted(
+            hcx##_tree_t* tree,
+            type** nodes,
+            size_t n
+    );
+    RB_SIZE_T
+    hcx##_size(
+            hcx##_tree_t* tree
+    );
+    type*
+    hcx##_first(
+            hcx##_tree_t* tree
+    );
+    type*
+    hcx##_last(
+            hcx##_tree_t* tree
+    );
+    void
+    hcx##_check_tree(hcx##_tree_t* tree);
+#enddef
+#define rb_head_bind_decl_m(hcx, cx, type) rb_head_bind_decl_cx_m(hcx, cx, type)
+
+// rb_head_bind_impl_m
+// -------------------
+//
+// Bind tree head functions to the context *hcx*. This only generates
+// implementations.
+//
+// The first and last node are updated by insert using the comparator of *cx*.
+// If the first or the last node is deleted, its neighbor becomes first or last.
+// The neighbor is found in constant time, since the first node has no left
+// child and therefore at most one child (red) on the right. The same is true
+// for the last node.
+//
+// rb_head_bind_impl_m uses the standard traits: rb_parent_m, rb_left_m,
+// rb_right_m, whereas rb_head_bind_impl_cx_m expects you to create:
+// cx##_parent_m, cx##_left_m, cx##_right_m.
+//
+// hcx
+//    Name of the tree head context.
+//
+// cx
+//    Name of the bound context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#begindef _rb_head_bind_impl_tr_m(
+        hcx,
+        cx,
+        type,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        cmp
+)
+    extern cx##_type_t cx##_nil_mem;
+    hcx##_type_t* const hcx##_nil_ptr = &cx##_nil_mem;
+    void
+    hcx##_tree_init(
+            hcx##_tree_t* tree
+    )
+    {
+        cx##_tree_init(&tree->root);
+        tree->size = 0;
+        tree->first = cx##_nil_ptr;
+        tree->last = cx##_nil_ptr;
+    }
+    void
+    hcx##_iter_init(
+            hcx##_tree_t* tree,
+            hcx##_iter_t** iter,
+            type** elem
+    )
+    {
+        (void)(iter);
+        if(tree->first == cx##_nil_ptr)
+            *elem = NULL;
+        else
+            *elem = tree->first;
+    }
+    void
+    hcx##_iter_next(
+            hcx##_iter_t* iter,
+            type** elem
+    )
+    {
+        cx##_iter_next(iter, elem);
+    }
+    void
+    hcx##_iter_init_last(
+            hcx##_tree_t* tree,
+            hcx##_iter_t** iter,
+            type** elem
+    )
+    {
+        (void)(iter);
+        if(tree->last == cx##_nil_ptr)
+            *elem = NULL;
+        else
+            *elem = tree->last;
+    }
+    void
+    hcx##_iter_prev(
+            hcx##_iter_t* iter,
+            type** elem
+    )
+    {
+        cx##_iter_prev(iter, elem);
+    }
+    void
+    hcx##_range_init(
+            hcx##_tree_t* tree,
+            type* start,
+            type* end,
+            hcx##_iter_t** iter,
+            type** elem
+    )
+    {
+        cx##_range_init(tree->root, start, end, iter, elem);
+    }
+    void
+    hcx##_range_next(
+            hcx##_iter_t* iter,
+            type** elem
+    )
+    {
+        cx##_range_next(iter, elem);
+    }
+    void
+    hcx##_node_init(
+            type* node
+    )
+    {
+        cx##_node_init(node);
+    }
+    int
+    hcx##_insert(
+            hcx##_tree_t* tree,
+            type* node
+    )
+    {
+        /* Check the greatest node first, appending needs no search. */
+        if(
+                tree->last != cx##_nil_ptr &&
+                cmp((node), (tree->last)) > 0
+        ) {
+            assert(
+                parent(node) == cx##_nil_ptr &&
+                left(node) == cx##_nil_ptr &&
+                right(node) == cx##_nil_ptr &&
+                "Node already used or not initialized"
+            );
+            _rb_insert_link_m(
+                type,
+                cx##_nil_ptr,
+                color,
+                parent,
+                left,
+                right,
+                set,
+                augment,
+                tree->root,
+                tree->last,
+                -1,
+                node
+            );
+            tree->size += 1;
+            tree->last = node;
+            return 0;
+        }
+        return hcx##_insert_hint(tree, cx##_nil_ptr, node);
+    }
+    int
+    hcx##_insert_hint(
+            hcx##_tree_t* tree,
+            type* hint,
+            type* node
+    )
+    {
+        if(cx##_insert_hint(&tree->root, hint, node) != 0)
+            return 1;
+        tree->size += 1;
+        /* A new first or last node is linked below the old one, the insert
+         * fix doesn't rotate it away. */
+        if(tree->first == cx##_nil_ptr) {
+            tree->first = node;
+            tree->last = node;
+        } else if(node == left(tree->first))
+            tree->first = node;
+        else if(node == right(tree->last))
+            tree->last = node;
+        return 0;
+    }
+    void
+    hcx##_delete_node(
+            hcx##_tree_t* tree,
+            type* node
+    )
+    {
+        type* __rb_hd_tmp_;
+        type* __rb_hd_elem_;
+        if(node == tree->first) {
+            __rb_hd_elem_ = node;
+            _rb_iter_next_m(
+                cx##_nil_ptr,
+                parent,
+                left,
+                right,
+                __rb_hd_elem_,
+                __rb_hd_tmp_
+            );
+            tree->first = __rb_hd_elem_ ? __rb_hd_elem_ : cx##_nil_ptr;
+        }
+        if(node == tree->last) {
+            __rb_hd_elem_ = node;
+            _rb_iter_next_m(
+                cx##_nil_ptr,
+                parent,
+                right, /* Switched */
+                left,  /* Switched */
+                __rb_hd_elem_,
+                __rb_hd_tmp_
+            );
+            tree->last = __rb_hd_elem_ ? __rb_hd_elem_ : cx##_nil_ptr;
+        }
+        cx##_delete_node(&tree->root, node);
+        tree->size -= 1;
+    }
+    int
+    hcx##_delete(
+            hcx##_tree_t* tree,
+            type* key
+    )
+    {
+        type* node;
+        if(cx##_find(tree->root, key, &node) == 0) {
+            hcx##_delete_node(tree, node);
+            return 0;
+        }
+        return 1;
+    }
+    void
+    hcx##_clear(
+            hcx##_tree_t* tree,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    )
+    {
+        cx##_clear(&tree->root, callback, ctx);
+        tree->size = 0;
+        tree->first = cx##_nil_ptr;
+        tree->last = cx##_nil_ptr;
+    }
+    int
+    hcx##_replace_node(
+            hcx##_tree_t* tree,
+            type* old,
+            type* new
+    )
+    {
+        if(cx##_replace_node(&tree->root, old, new) != 0)
+            return 1;
+        if(old == tree->first)
+            tree->first = new;
+        if(old == tree->last)
+            tree->last = new;
+        return 0;
+    }
+    int
+    hcx##_replace(
+            hcx##_tree_t* tree,
+            type* key,
+            type* new
+    )
+    {
+        type* old;
+        if(cx##_find(tree->root, key, &old) == 0) {
+            return hcx##_replace_node(tree, old, new);
+        }
+        return 1;
+    }
+    int
+    hcx##_find(
+            hcx##_tree_t* tree,
+            type* key,
+            type** node
+    )
+    {
+        return cx##_find(tree->root, key, node);
+    }
+    int
+    hcx##_lower_bound(
+            hcx##_tree_t* tree,
+            type* key,
+            type** node
+    )
+    {
+        return cx##_lower_bound(tree->root, key, node);
+    }
+    int
+    hcx##_upper_bound(
+            hcx##_tree_t* tree,
+            type* key,
+            type** node
+    )
+    {
+        return cx##_upper_bound(tree->root, key, node);
+    }
+    int
+    hcx##_floor(
+            hcx##_tree_t* tree,
+            type* key,
+            type** node
+    )
+    {
+        return cx##_floor(tree->root, key, node);
+    }
+    int
+    hcx##_ceil(
+            hcx##_tree_t* tree,
+            type* key,
+            type** node
+    )
+    {
+        return cx##_ceil(tree->root, key, node);
+    }
+    void
+    hcx##_build_sorted(
+            hcx##_tree_t* tree,
+            type** nodes,
+            size_t n
+    )
+    {
+        cx##_build_sorted(&tree->root, nodes, n);
+        if(n > 0) {
+            tree->size = n;
+            tree->first = nodes[0];
+            tree->last = nodes[n - 1];
+        }
+    }
+    RB_SIZE_T
+    hcx##_size(
+            hcx##_tree_t* tree
+    )
+    {
+        return tree->size;
+    }
+    type*
+    hcx##_first(
+            hcx##_tree_t* tree
+    )
+    {
+        return tree->first;
+    }
+    type*
+    hcx##_last(
+            hcx##_tree_t* tree
+    )
+    {
+        return tree->last;
+    }
+    void
+    hcx##_check_tree(hcx##_tree_t* tree)
+    {
+        type* __rb_hd_elem_ = tree->root;
+        cx##_check_tree(tree->root);
+        assert(cx##_size(tree->root) == tree->size);
+        while(
+                __rb_hd_elem_ != cx##_nil_ptr &&
+                left(__rb_hd_elem_) != cx##_nil_ptr
+        )
+            __rb_hd_elem_ = left(__rb_hd_elem_);
+        assert(__rb_hd_elem_ == tree->first);
+        __rb_hd_elem_ = tree->root;
+        while(
+                __rb_hd_elem_ != cx##_nil_ptr &&
+                right(__rb_hd_elem_) != cx##_nil_ptr
+        )
+            __rb_hd_elem_ = right(__rb_hd_elem_);
+        assert(__rb_hd_elem_ == tree->last);
+    }
+#enddef
+
+#begindef rb_head_bind_impl_cx_m(hcx, cx, type)
+    _rb_head_bind_impl_tr_m(
+        hcx,
+        cx,
+        type,
+        cx##_color_m,
+        cx##_parent_m,
+        cx##_left_m,
+        cx##_right_m,
+        rb_lvalue_set_m,
+        rb_no_augment_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_head_bind_impl_m(hcx, cx, type)
+    _rb_head_bind_impl_tr_m(
+        hcx,
+        cx,
+        type,
+        rb_color_m,
+        rb_parent_m,
+        rb_left_m,
+        rb_right_m,
+        rb_lvalue_set_m,
+        rb_no_augment_m,
+        cx##_cmp_m
+    )
+#enddef
+
+#begindef rb_head_bind_cx_m(hcx, cx, type)
+    rb_head_bind_decl_cx_m(hcx, cx, type)
+    rb_head_bind_impl_cx_m(hcx, cx, type)
+#enddef
+
+#begindef rb_head_bind_m(hcx, cx, type)
+    rb_head_bind_decl_m(hcx, cx, type)
+    rb_head_bind_impl_m(hcx, cx, type)
+#enddef
+
+// rb_ts_bind_decl_m
+// -----------------
+//
+// Alias: rb_ts_bind_decl_cx_m
+//
+// Bind thread-safe tree functions to the context *cx*, which has to be bound
+// to the same *type*. This only generates declarations.
+//
+// cx
+//    Name of the bound context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#begindef rb_ts_bind_decl_m(cx, type)
+    typedef struct {
+        type*            root;
+        pthread_rwlock_t lock;
+    } cx##_ts_t;
+    int
+    cx##_ts_init(
+            cx##_ts_t* ts
+    );
+    void
+    cx##_ts_destroy(
+            cx##_ts_t* ts
+    );
+    int
+    cx##_ts_rdlock(
+            cx##_ts_t* ts
+    );
+    int
+    cx##_ts_wrlock(
+            cx##_ts_t* ts
+    );
+    int
+    cx##_ts_unlock(
+            cx##_ts_t* ts
+    );
+    int
+    cx##_ts_insert(
+            cx##_ts_t* ts,
+            type* node
+    );
+    int
+    cx##_ts_insert_or_get(
+            cx##_ts_t* ts,
+            type* node,
+            type** existing
+    );
+    int
+    cx##_ts_delete(
+            cx##_ts_t* ts,
+            type* key
+    );
+    void
+    cx##_ts_delete_node(
+            cx##_ts_t* ts,
+            type* node
+    );
+    int
+    cx##_ts_replace(
+            cx##_ts_t* ts,
+            type* key,
+            type* new
+    );
+    void
+    cx##_ts_clear(
+            cx##_ts_t* ts,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    );
+    int
+    cx##_ts_find(
+            cx##_ts_t* ts,
+            type* key,
+            type** node
+    );
+    int
+    cx##_ts_lower_bound(
+            cx##_ts_t* ts,
+            type* key,
+            type** node
+    );
+    int
+    cx##_ts_upper_bound(
+            cx##_ts_t* ts,
+            type* key,
+            type** node
+    );
+    int
+    cx##_ts_floor(
+            cx##_ts_t* ts,
+            type* key,
+            type** node
+    );
+    int
+    cx##_ts_ceil(
+            cx##_ts_t* ts,
+            type* key,
+            type** node
+    );
+    RB_SIZE_T
+    cx##_ts_size(
+            cx##_ts_t* ts
+    );
+#enddef
+
+#define rb_ts_bind_decl_cx_m(cx, type) rb_ts_bind_decl_m(cx, type)
+
+// rb_ts_bind_impl_m
+// -----------------
+//
+// Alias: rb_ts_bind_impl_cx_m
+//
+// Bind thread-safe tree functions to the context *cx*. This only generates
+// implementations. Every function takes the lock, calls the function of *cx*
+// on the root and releases the lock.
+//
+// .. code-block:: cpp
+//
+#begindef rb_ts_bind_impl_m(cx, type)
+    int
+    cx##_ts_init(
+            cx##_ts_t* ts
+    )
+    {
+        cx##_tree_init(&ts->root);
+        return pthread_rwlock_init(&ts->lock, NULL);
+    }
+    void
+    cx##_ts_destroy(
+            cx##_ts_t* ts
+    )
+    {
+        pthread_rwlock_destroy(&ts->lock);
+    }
+    int
+    cx##_ts_rdlock(
+            cx##_ts_t* ts
+    )
+    {
+        return pthread_rwlock_rdlock(&ts->lock);
+    }
+    int
+    cx##_ts_wrlock(
+            cx##_ts_t* ts
+    )
+    {
+        return pthread_rwlock_wrlock(&ts->lock);
+    }
+    int
+    cx##_ts_unlock(
+            cx##_ts_t* ts
+    )
+    {
+        return pthread_rwlock_unlock(&ts->lock);
+    }
+    int
+    cx##_ts_insert(
+            cx##_ts_t* ts,
+            type* node
+    )
+    {
+        int ret;
+        pthread_rwlock_wrlock(&ts->lock);
+        ret = cx##_insert(&ts->root, node);
+        pthread_rwlock_unlock(&ts->lock);
+        return ret;
+    }
+    int
+    cx##_ts_insert_or_get(
+            cx##_ts_t* ts,
+            type* node,
+            type** existing
+    )
+    {
+        int ret;
+        pthread_rwlock_wrlock(&ts->lock);
+        ret = cx##_insert_or_get(&ts->root, node, existing);
+        pthread_rwlock_unlock(&ts->lock);
+        return ret;
+    }
+    int
+    cx##_ts_delete(
+            cx##_ts_t* ts,
+            type* key
+    )
+    {
+        int ret;
+        pthread_rwlock_wrlock(&ts->lock);
+        ret = cx##_delete(&ts->root, key);
+        pthread_rwlock_unlock(&ts->lock);
+        return ret;
+    }
+    void
+    cx##_ts_delete_node(
+            cx##_ts_t* ts,
+            type* node
+    )
+    {
+        pthread_rwlock_wrlock(&ts->lock);
+        cx##_delete_node(&ts->root, node);
+        pthread_rwlock_unlock(&ts->lock);
+    }
+    int
+    cx##_ts_replace(
+            cx##_ts_t* ts,
+            type* key,
+            type* new
+    )
+    {
+        int ret;
+        pthread_rwlock_wrlock(&ts->lock);
+        ret = cx##_replace(&ts->root, key, new);
+        pthread_rwlock_unlock(&ts->lock);
+        return ret;
+    }
+    void
+    cx##_ts_clear(
+            cx##_ts_t* ts,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    )
+    {
+        pthread_rwlock_wrlock(&ts->lock);
+        cx##_clear(&ts->root, callback, ctx);
+        pthread_rwlock_unlock(&ts->lock);
+    }
+    int
+    cx##_ts_find(
+            cx##_ts_t* ts,
+            type* key,
+            type** node
+    )
+    {
+        int ret;
+        pthread_rwlock_rdlock(&ts->lock);
+        ret = cx##_find(ts->root, key, node);
+        pthread_rwlock_unlock(&ts->lock);
+        return ret;
+    }
+    int
+    cx##_ts_lower_bound(
+            cx##_ts_t* ts,
+            type* key,
+            type** node
+    )
+    {
+        int ret;
+        pthread_rwlock_rdlock(&ts->lock);
+        ret = cx##_lower_bound(ts->root, key, node);
+        pthread_rwlock_unlock(&ts->lock);
+        return ret;
+    }
+    int
+    cx##_ts_upper_bound(
+            cx##_ts_t* ts,
+            type* key,
+            type** node
+    )
+    {
+        int ret;
+        pthread_rwlock_rdlock(&ts->lock);
+        ret = cx##_upper_bound(ts->root, key, node);
+        pthread_rwlock_unlock(&ts->lock);
+        return ret;
+    }
+    int
+    cx##_ts_floor(
+            cx##_ts_t* ts,
+            type* key,
+            type** node
+    )
+    {
+        int ret;
+        pthread_rwlock_rdlock(&ts->lock);
+        ret = cx##_floor(ts->root, key, node);
+        pthread_rwlock_unlock(&ts->lock);
+        return ret;
+    }
+    int
+    cx##_ts_ceil(
+            cx##_ts_t* ts,
+            type* key,
+            type** node
+    )
+    {
+        int ret;
+        pthread_rwlock_rdlock(&ts->lock);
+        ret = cx##_ceil(ts->root, key, node);
+        pthread_rwlock_unlock(&ts->lock);
+        return ret;
+    }
+    RB_SIZE_T
+    cx##_ts_size(
+            cx##_ts_t* ts
+    )
+    {
+        RB_SIZE_T ret;
+        pthread_rwlock_rdlock(&ts->lock);
+        ret = cx##_size(ts->root);
+        pthread_rwlock_unlock(&ts->lock);
+        return ret;
+    }
+#enddef
+
+#define rb_ts_bind_impl_cx_m(cx, type) rb_ts_bind_impl_m(cx, type)
+
+#begindef rb_ts_bind_m(cx, type)
+    rb_ts_bind_decl_m(cx, type)
+    rb_ts_bind_impl_m(cx, type)
+#enddef
+
+#define rb_ts_bind_cx_m(cx, type) rb_ts_bind_m(cx, type)
+
+// rb_ts_for_m
+// -----------
+//
+// Generates a for-loop-header, that locks the tree shared around rb_for_m.
+// The outer loop runs once, its increment releases the lock after the inner
+// loop ended or was left by break.
+//
+// ts
+//    Pointer to the thread-safe tree.
+//
+// .. code-block:: cpp
+//
+#begindef rb_ts_for_m(cx, ts, iter, elem)
+    for(
+            int __rb_ts_once_ = cx##_ts_rdlock(ts);
+            __rb_ts_once_ == 0;
+            __rb_ts_once_ = cx##_ts_unlock(ts) + 1
+    )
+        rb_for_m(cx, (ts)->root, iter, elem)
+#enddef
+
+#begindef rb_ts_for_reverse_m(cx, ts, iter, elem)
+    for(
+            int __rb_ts_once_ = cx##_ts_rdlock(ts);
+            __rb_ts_once_ == 0;
+            __rb_ts_once_ = cx##_ts_unlock(ts) + 1
+    )
+        rb_for_reverse_m(cx, (ts)->root, iter, elem)
+#enddef
+
+// rb_seq_bound_m
+// --------------
+//
+// Same as rb_bound_m, but safe to run while a writer changes the tree. The
+// search stops at NULL as well as at nil and after RB_MAX_HEIGHT steps, so it
+// ends even if it follows stale links. *steps* is the number of nodes
+// visited.
+//
+// .. code-block:: cpp
+//
+#begindef rb_seq_bound_m(
+        type,
+        nil,
+        left,
+        right,
+        cmp,
+        tree,
+        key,
+        node,
+        op,
+        steps
+)
+{
+    type* __rb_seq_node_ = tree;
+    node = nil;
+    steps = 0;
+    while(
+            __rb_seq_node_ != nil &&
+            __rb_seq_node_ != NULL &&
+            steps < RB_MAX_HEIGHT
+    ) {
+        if(cmp((__rb_seq_node_), (key)) op 0) {
+            node = __rb_seq_node_;
+            __rb_seq_node_ = left(__rb_seq_node_);
+        } else
+            __rb_seq_node_ = right(__rb_seq_node_);
+        steps += 1;
+    }
+}
+#enddef
+
+// rb_seq_read_m
+// -------------
+//
+// Run rb_seq_bound_m until no writer was active during the search. The
+// counter is odd while a writer changes the tree, then we yield instead of
+// spinning. The acquire fence orders the reads of the tree before the second
+// read of the counter. pthread.h makes sched_yield visible.
+//
+// seq
+//    Pointer to the sequence-locked tree.
+//
+// exact
+//    If 1 *node* is set to nil unless it is equal to *key*. The comparison
+//    runs inside the read section, before the counter is checked again.
+//
+// .. code-block:: cpp
+//
+#begindef rb_seq_read_m(
+        type,
+        nil,
+        left,
+        right,
+        cmp,
+        seq,
+        key,
+        node,
+        op,
+        exact
+)
+{
+    unsigned __rb_seq_start_;
+    int __rb_seq_steps_;
+    for(;;) {
+        __rb_seq_start_ = __atomic_load_n(&(seq)->count, __ATOMIC_ACQUIRE);
+        if(__rb_seq_start_ & 1) {
+            /* Let the writer finish, it may wait for our core. */
+            sched_yield();
+            continue;
+        }
+        rb_seq_bound_m(
+            type,
+            nil,
+            left,
+            right,
+            cmp,
+            __atomic_load_n(&(seq)->root, __ATOMIC_RELAXED),
+            key,
+            node,
+            op,
+            __rb_seq_steps_
+        );
+        if(exact && node != nil && cmp((node), (key)) != 0)
+            node = nil;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if(__atomic_load_n(&(seq)->count, __ATOMIC_RELAXED) == __rb_seq_start_)
+            break;
+    }
+    (void)(__rb_seq_steps_);
+}
+#enddef
+
+// rb_seq_bind_decl_m
+// ------------------
+//
+// Alias: rb_seq_bind_decl_cx_m
+//
+// Bind sequence-locked tree functions to the context *cx*, which has to be
+// bound to the same *type*. This only generates declarations.
+//
+// cx
+//    Name of the bound context.
+//
+// type
+//    The type of the nodes in the red-black tree.
+//
+// .. code-block:: cpp
+//
+#begindef rb_seq_bind_decl_m(cx, type)
+    typedef struct {
+        type*           root;
+        unsigned        count;
+        pthread_mutex_t lock;
+    } cx##_seq_t;
+    int
+    cx##_seq_init(
+            cx##_seq_t* seq
+    );
+    void
+    cx##_seq_destroy(
+            cx##_seq_t* seq
+    );
+    void
+    cx##_seq_lock(
+            cx##_seq_t* seq
+    );
+    void
+    cx##_seq_unlock(
+            cx##_seq_t* seq
+    );
+    int
+    cx##_seq_insert(
+            cx##_seq_t* seq,
+            type* node
+    );
+    int
+    cx##_seq_insert_or_get(
+            cx##_seq_t* seq,
+            type* node,
+            type** existing
+    );
+    int
+    cx##_seq_delete(
+            cx##_seq_t* seq,
+            type* key
+    );
+    void
+    cx##_seq_delete_node(
+            cx##_seq_t* seq,
+            type* node
+    );
+    int
+    cx##_seq_replace(
+            cx##_seq_t* seq,
+            type* key,
+            type* new
+    );
+    void
+    cx##_seq_clear(
+            cx##_seq_t* seq,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    );
+    int
+    cx##_seq_find(
+            cx##_seq_t* seq,
+            type* key,
+            type** node
+    );
+    int
+    cx##_seq_lower_bound(
+            cx##_seq_t* seq,
+            type* key,
+            type** node
+    );
+    int
+    cx##_seq_upper_bound(
+            cx##_seq_t* seq,
+            type* key,
+            type** node
+    );
+    int
+    cx##_seq_floor(
+            cx##_seq_t* seq,
+            type* key,
+            type** node
+    );
+    int
+    cx##_seq_ceil(
+            cx##_seq_t* seq,
+            type* key,
+            type** node
+    );
+#enddef
+
+#define rb_seq_bind_decl_cx_m(cx, type) rb_seq_bind_decl_m(cx, type)
+
+// rb_seq_bind_impl_m
+// ------------------
+//
+// Bind sequence-locked tree functions to the context *cx*. This only
+// generates implementations.
+//
+// rb_seq_bind_impl_m uses the standard traits: rb_left_m, rb_right_m, whereas
+// rb_seq_bind_impl_cx_m expects you to create: cx##_left_m, cx##_right_m.
+// The writers call the functions of *cx*.
+//
+// .. code-block:: cpp
+//
+#begindef _rb_seq_bind_impl_tr_m(cx, type, left, right)
+    int
+    cx##_seq_init(
+            cx##_seq_t* seq
+    )
+    {
+        cx##_tree_init(&seq->root);
+        seq->count = 0;
+        return pthread_mutex_init(&seq->lock, NULL);
+    }
+    void
+    cx##_seq_destroy(
+            cx##_seq_t* seq
+    )
+    {
+        pthread_mutex_destroy(&seq->lock);
+    }
+    void
+    cx##_seq_lock(
+            cx##_seq_t* seq
+    )
+    {
+        pthread_mutex_lock(&seq->lock);
+        __atomic_store_n(&seq->count, seq->count + 1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+    void
+    cx##_seq_unlock(
+            cx##_seq_t* seq
+    )
+    {
+        __atomic_store_n(&seq->count, seq->count + 1, __ATOMIC_RELEASE);
+        pthread_mutex_unlock(&seq->lock);
+    }
+    int
+    cx##_seq_insert(
+            cx##_seq_t* seq,
+            type* node
+    )
+    {
+        int ret;
+        type* root;
+        cx##_seq_lock(seq);
+        root = seq->root;
+        ret = cx##_insert(&root, node);
+        __atomic_store_n(&seq->root, root, __ATOMIC_RELAXED);
+        cx##_seq_unlock(seq);
+        return ret;
+    }
+    int
+    cx##_seq_insert_or_get(
+            cx##_seq_t* seq,
+            type* node,
+            type** existing
+    )
+    {
+        int ret;
+        type* root;
+        cx##_seq_lock(seq);
+        root = seq->root;
+        ret = cx##_insert_or_get(&root, node, existing);
+        __atomic_store_n(&seq->root, root, __ATOMIC_RELAXED);
+        cx##_seq_unlock(seq);
+        return ret;
+    }
+    int
+    cx##_seq_delete(
+            cx##_seq_t* seq,
+            type* key
+    )
+    {
+        int ret;
+        type* root;
+        cx##_seq_lock(seq);
+        root = seq->root;
+        ret = cx##_delete(&root, key);
+        __atomic_store_n(&seq->root, root, __ATOMIC_RELAXED);
+        cx##_seq_unlock(seq);
+        return ret;
+    }
+    void
+    cx##_seq_delete_node(
+            cx##_seq_t* seq,
+            type* node
+    )
+    {
+        type* root;
+        cx##_seq_lock(seq);
+        root = seq->root;
+        cx##_delete_node(&root, node);
+        __atomic_store_n(&seq->root, root, __ATOMIC_RELAXED);
+        cx##_seq_unlock(seq);
+    }
+    int
+    cx##_seq_replace(
+            cx##_seq_t* seq,
+            type* key,
+            type* new
+    )
+    {
+        int ret;
+        type* root;
+        cx##_seq_lock(seq);
+        root = seq->root;
+        ret = cx##_replace(&root, key, new);
+        __atomic_store_n(&seq->root, root, __ATOMIC_RELAXED);
+        cx##_seq_unlock(seq);
+        return ret;
+    }
+    void
+    cx##_seq_clear(
+            cx##_seq_t* seq,
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    )
+    {
+        type* root;
+        cx##_seq_lock(seq);
+        root = seq->root;
+        cx##_clear(&root, callback, ctx);
+        __atomic_store_n(&seq->root, root, __ATOMIC_RELAXED);
+        cx##_seq_unlock(seq);
+    }
+    int
+    cx##_seq_find(
+            cx##_seq_t* seq,
+            type* key,
+            type** node
+    )
+    {
+        rb_seq_read_m(
+            type,
+            cx##_nil_ptr,
+            left,
+            right,
+            cx##_cmp_m,
+            seq,
+            key,
+            *node,
+            >=,
+            1
+        );
+        return *node == cx##_nil_ptr;
+    }
+    int
+    cx##_seq_lower_bound(
+            cx##_seq_t* seq,
+            type* key,
+            type** node
+    )
+    {
+        rb_seq_read_m(
+            type,
+            cx##_nil_ptr,
+            left,
+            right,
+            cx##_cmp_m,
+            seq,
+            key,
+            *node,
+            >=,
+            0
+        );
+        return *node == cx##_nil_ptr;
+    }
+    int
+    cx##_seq_upper_bound(
+            cx##_seq_t* seq,
+            type* key,
+            type** node
+    )
+    {
+        rb_seq_read_m(
+            type,
+            cx##_nil_ptr,
+            left,
+            right,
+            cx##_cmp_m,
+            seq,
+            key,
+            *node,
+            >,
+            0
+        );
+        return *node == cx##_nil_ptr;
+    }
+    int
+    cx##_seq_floor(
+            cx##_seq_t* seq,
+            type* key,
+            type** node
+    )
+    {
+        rb_seq_read_m(
+            type,
+            cx##_nil_ptr,
+            right, /* Switched */
+            left, /* Switched */
+            cx##_cmp_m,
+            seq,
+            key,
+            *node,
+            <=,
+            0
+        );
+        return *node == cx##_nil_ptr;
+    }
+    int
+    cx##_seq_ceil(
+            cx##_seq_t* seq,
+            type* key,
+            type** node
+    )
+    {
+        return cx##_seq_lower_bound(seq, key, node);
+    }
+#enddef
+
+#begindef rb_seq_bind_impl_cx_m(cx, type)
+    _rb_seq_bind_impl_tr_m(
+        cx,
+        type,
+        cx##_left_m,
+        cx##_right_m
+    )
+#enddef
+
+#begindef rb_seq_bind_impl_m(cx, type)
+    _rb_seq_bind_impl_tr_m(
+        cx,
+        type,
+        rb_left_m,
+        rb_right_m
+    )
+#enddef
+
+#begindef rb_seq_bind_cx_m(cx, type)
+    rb_seq_bind_decl_cx_m(cx, type)
+    rb_seq_bind_impl_cx_m(cx, type)
+#enddef
+
+#begindef rb_seq_bind_m(cx, type)
+    rb_seq_bind_decl_m(cx, type)
+    rb_seq_bind_impl_m(cx, type)
+#enddef
+
+// Compact engine
+// ==============
+//
+// The compact engine does not use the parent trait. It remembers the path from
+// the root on a stack of at most RB_MAX_HEIGHT nodes and rebalances bottom-up
+// along that path. It never writes nil.
+//
+// _rb_compact_child_m
+// -------------------
+//
+// Internal: not bound
+//
+// Replace the child *old* of *p* by *new*, or the root if *p* is nil.
+//
+// .. code-block:: cpp
+//
+#begindef _rb_compact_child_m(nil, left, right, set, tree, p, old, new)
+{
+    if(p == nil)
+        tree = new;
+    else if(left(p) == old)
+        set(left, p, new);
+    else
+        set(right, p, new);
+}
+#enddef
+
+// _rb_compact_rotate_left_m
+// -------------------------
+//
+// Internal: not bound
+//
+// Rotate left at *x*, which is a child of *p*. *y* becomes the root of the
+// sub-tree. _rb_compact_rotate_right_m is _rb_compact_rotate_left_m where
+// left and right had been switched.
+//
+// .. code-block:: cpp
+//
+#begindef _rb_compact_rotate_left_m(nil, left, right, set, tree, p, x, y)
+{
+    y = right(x);
+    set(right, x, left(y));
+    set(left, y, x);
+    _rb_compact_child_m(nil, left, right, set, tree, p, x, y);
+}
+#enddef
+
+#begindef _rb_compact_rotate_right_m(nil, left, right, set, tree, p, x, y)
+    _rb_compact_rotate_left_m(
+        nil,
+        right, /* Switched */
+        left, /* Switched */
+        set,
+        tree,
+        p,
+        x,
+        y
+    )
+#enddef
+
+// rb_compact_insert_m
+// -------------------
+//
+// Bound: cx##_insert
+//
+// Insert the *node* into the tree. *ret* is set to 1 if a node with the same
+// key is already in the tree, to 0 on success.
+//
+// .. code-block:: cpp
+//
+#begindef __rb_compact_insert_fix_m(
+        type,
+        nil,
+        color,
+        left,
+        right,
+        set,
+        tree,
+        stack,
+        sp,
+        x,
+        p,
+        g
+)
+{
+    type* __rb_cins_u_ = right(g);
+    if(__rb_cins_u_ != nil && rb_is_red_m(color(__rb_cins_u_))) {
+        set(color, p, RB_BLACK);
+        set(color, __rb_cins_u_, RB_BLACK);
+        set(color, g, RB_RED);
+        x = g;
+        sp -= 2;
+    } else {
+        if(x == right(p)) {
+            _rb_compact_rotate_left_m(nil, left, right, set, tree, g, p, x);
+            p = x;
+        }
+        set(color, p, RB_BLACK);
+        set(color, g, RB_RED);
+        _rb_compact_rotate_right_m(
+            nil,
+            left,
+            right,
+            set,
+            tree,
+            (sp > 2 ? stack[sp - 3] : nil),
+            g,
+            p
+        );
+        sp = 0;
+    }
+}
+#enddef
+
+#begindef rb_compact_insert_m(
+        type,
+        nil,
+        color,
+        left,
+        right,
+        set,
+        cmp,
+        tree,
+        node,
+        ret
+)
+{
+    type* __rb_cins_stack_[RB_MAX_HEIGHT];
+    type* __rb_cins_x_ = tree;
+    type* __rb_cins_p_;
+    type* __rb_cins_g_;
+    int __rb_cins_sp_ = 0;
+    int __rb_cins_r_ = 0;
+    assert(node != nil && "Cannot insert nil node");
+    while(__rb_cins_x_ != nil) {
+        __rb_cins_r_ = cmp((__rb_cins_x_), (node));
+        if(__rb_cins_r_ == 0)
+            break;
+        assert(__rb_cins_sp_ < RB_MAX_HEIGHT && "Stack overflow");
+        __rb_cins_stack_[__rb_cins_sp_++] = __rb_cins_x_;
+        if(__rb_cins_r_ > 0)
+            __rb_cins_x_ = left(__rb_cins_x_);
+        else
+            __rb_cins_x_ = right(__rb_cins_x_);
+    }
+    ret = __rb_cins_x_ != nil;
+    if(!ret) {
+        set(color, node, RB_RED);
+        set(left, node, nil);
+        set(right, node, nil);
+        if(__rb_cins_sp_ == 0)
+            tree = node;
+        else if(__rb_cins_r_ > 0)
+            set(left, __rb_cins_stack_[__rb_cins_sp_ - 1], node);
+        else
+            set(right, __rb_cins_stack_[__rb_cins_sp_ - 1], node);
+        __rb_cins_x_ = node;
+        while(__rb_cins_sp_ > 0) {
+            __rb_cins_p_ = __rb_cins_stack_[__rb_cins_sp_ - 1];
+            if(rb_is_black_m(color(__rb_cins_p_)))
+                break;
+            /* A red parent is never the root. */
+            __rb_cins_g_ = __rb_cins_stack_[__rb_cins_sp_ - 2];
+            if(__rb_cins_p_ == left(__rb_cins_g_)) {
+                __rb_compact_insert_fix_m(
+                    type,
+                    nil,
+                    color,
+                    left,
+                    right,
+                    set,
+                    tree,
+                    __rb_cins_stack_,
+                    __rb_cins_sp_,
+                    __rb_cins_x_,
+                    __rb_cins_p_,
+                    __rb_cins_g_
+                );
+            } else {
+                __rb_compact_insert_fix_m(
+                    type,
+                    nil,
+                    color,
+                    right, /* Switched */
+                    left, /* Switched */
+                    set,
+                    tree,
+                    __rb_cins_stack_,
+                    __rb_cins_sp_,
+                    __rb_cins_x_,
+                    __rb_cins_p_,
+                    __rb_cins_g_
+                );
+            }
+        }
+        set(color, tree, RB_BLACK);
+    }
+}
+#enddef
+
+// rb_compact_delete_m
+// -------------------
+//
+// Bound: cx##_delete, cx##_delete_node
+//
+// Delete the node matching *key* from the tree. *node* is set to the deleted
+// node or nil if *key* is not in the tree.
+//
+// .. code-block:: cpp
+//
+#begindef __rb_compact_delete_fix_m(
+        type,
+        nil,
+        color,
+        left,
+        right,
+        set,
+        tree,
+        stack,
+        sp,
+        x,
+        p,
+        w
+)
+{
+    w = right(p);
+    if(rb_is_red_m(color(w))) {
+        set(color, w, RB_BLACK);
+        set(color, p, RB_RED);
+        _rb_compact_rotate_left_m(
+            nil,
+            left,
+            right,
+            set,
+            tree,
+            (sp > 1 ? stack[sp - 2] : nil),
+            p,
+            w
+        );
+        assert(sp < RB_MAX_HEIGHT && "Stack overflow");
+        stack[sp - 1] = w;
+        stack[sp++] = p;
+        w = right(p);
+    }
+    if(
+            rb_is_black_m(color(left(w))) &&
+            rb_is_black_m(color(right(w)))
+    ) {
+        set(color, w, RB_RED);
+        x = p;
+        sp -= 1;
+    } else {
+        if(rb_is_black_m(color(right(w)))) {
+            set(color, left(w), RB_BLACK);
+            set(color, w, RB_RED);
+            _rb_compact_rotate_right_m(nil, left, right, set, tree, p, w, x);
+            w = right(p);
+        }
+        set(color, w, color(p));
+        set(color, p, RB_BLACK);
+        set(color, right(w), RB_BLACK);
+        _rb_compact_rotate_left_m(
+            nil,
+            left,
+            right,
+            set,
+            tree,
+            (sp > 1 ? stack[sp - 2] : nil),
+            p,
+            w
+        );
+        x = tree;
+        sp = 0;
+    }
+}
+#enddef
+
+#begindef rb_compact_delete_m(
+        type,
+        nil,
+        color,
+        left,
+        right,
+        set,
+        cmp,
+        tree,
+        key,
+        node
+)
+{
+    type* __rb_cdel_stack_[RB_MAX_HEIGHT];
+    type* __rb_cdel_x_ = tree;
+    type* __rb_cdel_y_;
+    type* __rb_cdel_p_;
+    int __rb_cdel_sp_ = 0;
+    int __rb_cdel_zp_;
+    int __rb_cdel_r_;
+    char __rb_cdel_color_;
+    while(__rb_cdel_x_ != nil) {
+        __rb_cdel_r_ = cmp((__rb_cdel_x_), (key));
+        if(__rb_cdel_r_ == 0)
+            break;
+        assert(__rb_cdel_sp_ < RB_MAX_HEIGHT && "Stack overflow");
+        __rb_cdel_stack_[__rb_cdel_sp_++] = __rb_cdel_x_;
+        if(__rb_cdel_r_ > 0)
+            __rb_cdel_x_ = left(__rb_cdel_x_);
+        else
+            __rb_cdel_x_ = right(__rb_cdel_x_);
+    }
+    node = __rb_cdel_x_;
+    if(node != nil) {
+        __rb_cdel_zp_ = __rb_cdel_sp_;
+        __rb_cdel_p_ = __rb_cdel_sp_ > 0 ?
+            __rb_cdel_stack_[__rb_cdel_sp_ - 1] : nil;
+        if(left(node) == nil || right(node) == nil) {
+            /* Splice out the node. */
+            __rb_cdel_x_ = left(node) == nil ? right(node) : left(node);
+            __rb_cdel_color_ = color(node);
+            _rb_compact_child_m(
+                nil,
+                left,
+                right,
+                set,
+                tree,
+                __rb_cdel_p_,
+                node,
+                __rb_cdel_x_
+            );
+        } else {
+            /* Splice out the successor and put it in place of the node. */
+            assert(__rb_cdel_sp_ < RB_MAX_HEIGHT && "Stack overflow");
+            __rb_cdel_stack_[__rb_cdel_sp_++] = node;
+            __rb_cdel_y_ = right(node);
+            while(left(__rb_cdel_y_) != nil) {
+                assert(__rb_cdel_sp_ < RB_MAX_HEIGHT && "Stack overflow");
+                __rb_cdel_stack_[__rb_cdel_sp_++] = __rb_cdel_y_;
+                __rb_cdel_y_ = left(__rb_cdel_y_);
+            }
+            __rb_cdel_x_ = right(__rb_cdel_y_);
+            __rb_cdel_color_ = color(__rb_cdel_y_);
+            if(__rb_cdel_stack_[__rb_cdel_sp_ - 1] != node) {
+                set(left, __rb_cdel_stack_[__rb_cdel_sp_ - 1], __rb_cdel_x_);
+                set(right, __rb_cdel_y_, right(node));
+            }
+            set(left, __rb_cdel_y_, left(node));
+            set(color, __rb_cdel_y_, color(node));
+            _rb_compact_child_m(
+                nil,
+                left,
+                right,
+                set,
+                tree,
+                __rb_cdel_p_,
+                node,
+                __rb_cdel_y_
+            );
+            __rb_cdel_stack_[__rb_cdel_zp_] = __rb_cdel_y_;
+        }
+        if(rb_is_black_m(__rb_cdel_color_)) {
+            while(
+                    __rb_cdel_sp_ > 0 && (
+                        __rb_cdel_x_ == nil ||
+                        rb_is_black_m(color(__rb_cdel_x_))
+                    )
+            ) {
+                __rb_cdel_p_ = __rb_cdel_stack_[__rb_cdel_sp_ - 1];
+                /* A nil x is never the only nil child of p, the sibling
+                 * carries the black height. */
+                if(__rb_cdel_x_ == left(__rb_cdel_p_)) {
+                    __rb_compact_delete_fix_m(
+                        type,
+                        nil,
+                        color,
+                        left,
+                        right,
+                        set,
+                        tree,
+                        __rb_cdel_stack_,
+                        __rb_cdel_sp_,
+                        __rb_cdel_x_,
+                        __rb_cdel_p_,
+                        __rb_cdel_y_
+                    );
+                } else {
+                    __rb_compact_delete_fix_m(
+                        type,
+                        nil,
+                        color,
+                        right, /* Switched */
+                        left, /* Switched */
+                        set,
+                        tree,
+                        __rb_cdel_stack_,
+                        __rb_cdel_sp_,
+                        __rb_cdel_x_,
+                        __rb_cdel_p_,
+                        __rb_cdel_y_
+                    );
+                }
+            }
+            if(__rb_cdel_x_ != nil)
+                set(color, __rb_cdel_x_, RB_BLACK);
+        }
+        set(color, node, RB_BLACK);
+        set(left, node, nil);
+        set(right, node, nil);
+    }
+}
+#enddef
+
+// rb_compact_clear_m
+// ------------------
+//
+// Bound: cx##_clear
+//
+// Like rb_clear_m, but without parent pointers. While the root has a left
+// child we rotate it to the right, otherwise the root is removed and its right
+// child becomes the root. Every rotation moves one node off the left spine for
+// good, so this is O(N) without a stack.
+//
+// .. code-block:: cpp
+//
+#begindef rb_compact_clear_m(
+        type,
+        nil,
+        color,
+        left,
+        right,
+        set,
+        tree,
+        callback,
+        ctx
+)
+{
+    type* __rb_cclr_node_ = tree;
+    type* __rb_cclr_next_;
+    while(__rb_cclr_node_ != nil) {
+        __rb_cclr_next_ = left(__rb_cclr_node_);
+        if(__rb_cclr_next_ != nil) {
+            set(left, __rb_cclr_node_, right(__rb_cclr_next_));
+            set(right, __rb_cclr_next_, __rb_cclr_node_);
+        } else {
+            __rb_cclr_next_ = right(__rb_cclr_node_);
+            set(color, __rb_cclr_node_, RB_BLACK);
+            set(left, __rb_cclr_node_, nil);
+            set(right, __rb_cclr_node_, nil);
+            if(callback != NULL)
+                callback(__rb_cclr_node_, ctx);
+        }
+        __rb_cclr_node_ = __rb_cclr_next_;
+    }
+    tree = nil;
+}
+#enddef
+
+// rb_compact_iter_init_m
+// ----------------------
+//
+// Bound: cx##_iter_init
+//
+// The iterator of the compact engine is a stack of the nodes that have not
+// been visited yet. *elem* is the first node or NULL if the tree is empty.
+//
+// .. code-block:: cpp
+//
+#begindef _rb_compact_iter_push_m(nil, left, iter, node)
+{
+    while(node != nil) {
+        assert(iter->sp < RB_MAX_HEIGHT && "Stack overflow");
+        iter->stack[iter->sp++] = node;
+        node = left(node);
+    }
+}
+#enddef
+
+#begindef rb_compact_iter_init_m(type, nil, left, tree, iter, elem)
+{
+    type* __rb_citer_x_ = tree;
+    iter->sp = 0;
+    _rb_compact_iter_push_m(nil, left, iter, __rb_citer_x_);
+    elem = iter->sp > 0 ? iter->stack[--iter->sp] : NULL;
+}
+#enddef
+
+// rb_compact_iter_next_m
+// ----------------------
+//
+// Bound: cx##_iter_next
+//
+// Visit the right sub-tree of *elem* and pop the next node.
+//
+// .. code-block:: cpp
+//
+#begindef rb_compact_iter_next_m(type, nil, left, right, iter, elem)
+{
+    type* __rb_citer_x_ = right(elem);
+    _rb_compact_iter_push_m(nil, left, iter, __rb_citer_x_);
+    elem = iter->sp > 0 ? iter->stack[--iter->sp] : NULL;
+}
+#enddef
+
+// rb_compact_check_tree_m
+// -----------------------
+//
+// Recursive: only works bound cx##_check_tree
+//
+// Check consistency of a compact tree, like rb_check_tree_m without parents.
+//
+// .. code-block:: cpp
+//
+#begindef rb_compact_check_tree_m(
+        cx,
+        type,
+        color,
+        left,
+        right,
+        cmp,
+        node,
+        depth,
+        pathdepth
+)
+{
+    type* nil = cx##_nil_ptr;
+    if(node == nil) {
+        if(pathdepth < 0)
+            pathdepth = depth;
+        else
+            assert(pathdepth == depth);
+    } else {
+        if(left(node) != nil)
+            assert(cmp((left(node)), (node)) < 0);
+        if(right(node) != nil)
+            assert(cmp((right(node)), (node)) > 0);
+        if(rb_is_red_m(color(node))) {
+            assert(rb_is_black_m(color(left(node))));
+            assert(rb_is_black_m(color(right(node))));
+            cx##_check_tree_rec(left(node), depth, &pathdepth);
+            cx##_check_tree_rec(right(node), depth, &pathdepth);
+        } else {
+            cx##_check_tree_rec(left(node), depth + 1, &pathdepth);
+            cx##_check_tree_rec(right(node), depth + 1, &pathdepth);
+        }
+    }
+}
+#enddef
+
+#define _rb_compact_no_parent_m(x) nil
+
+// rb_compact_iter_decl_cx_m
+// -------------------------
+//
+// Declare an iterator of a compact context, its stack lives on the stack of
+// the caller. It can be used with rb_for_m.
+//
+// .. code-block:: cpp
+//
+#begindef rb_compact_iter_decl_cx_m(cx, iter, elem)
+    cx##_iter_t iter##_mem;
+    cx##_iter_t* iter = &iter##_mem;
+    cx##_type_t* elem = NULL;
+#enddef
+
+// rb_compact_bind_impl_m
+// ----------------------
+//
+// Bind the compact engine to a context. This only generates implementations.
+// It provides cx##_tree_init, cx##_node_init, cx##_insert, cx##_delete,
+// cx##_delete_node, cx##_find, cx##_iter_init, cx##_iter_next, cx##_size and
+// cx##_check_tree.
+//
+// rb_compact_bind_impl_m uses the standard traits: rb_color_m, rb_left_m,
+// rb_right_m, whereas rb_compact_bind_impl_cx_m expects you to create:
+// cx##_color_m, cx##_left_m, cx##_right_m and the setters
+// cx##_color_m_set, cx##_left_m_set, cx##_right_m_set.
 //
 // cx
 //    Name of the new context.
@@ -1232,24 +9027,18 @@ do {
 //
 // .. code-block:: cpp
 //
-#begindef rb_bind_decl_cx_m(cx, type)
-    rb_new_context_m(cx, type)
+#begindef rb_compact_bind_decl_cx_m(cx, type)
+    typedef type cx##_type_t;
+    typedef struct {
+        type* stack[RB_MAX_HEIGHT];
+        int sp;
+    } cx##_iter_t;
+    extern cx##_type_t* const cx##_nil_ptr;
     void
     cx##_tree_init(
             type** tree
     );
     void
-    cx##_iter_init(
-            type* tree,
-            cx##_iter_t** iter,
-            type** elem
-    );
-    void
-    cx##_iter_next(
-            cx##_iter_t* iter,
-            type** elem
-    );
-    void
     cx##_node_init(
             type* node
     );
@@ -1258,27 +9047,21 @@ do {
             type** tree,
             type* node
     );
-    void
-    cx##_delete_node(
-            type** tree,
-            type* node
-    );
     int
     cx##_delete(
             type** tree,
             type* key
     );
-    int
-    cx##_replace_node(
+    void
+    cx##_clear(
             type** tree,
-            type* old,
-            type* new
+            void (*callback)(type* node, void* ctx),
+            void* ctx
     );
-    int
-    cx##_replace(
+    void
+    cx##_delete_node(
             type** tree,
-            type* key,
-            type* new
+            type* node
     );
     int
     cx##_find(
@@ -1286,6 +9069,17 @@ do {
             type* key,
             type** node
     );
+    void
+    cx##_iter_init(
+            type* tree,
+            cx##_iter_t** iter,
+            type** elem
+    );
+    void
+    cx##_iter_next(
+            cx##_iter_t* iter,
+            type** elem
+    );
     RB_SIZE_T
     cx##_size(
             type* tree
@@ -1299,32 +9093,15 @@ do {
             int *pathdepth
     );
 #enddef
-#define rb_bind_decl_m(cx, type) rb_bind_decl_cx_m(cx, type)
+#define rb_compact_bind_decl_m(cx, type) rb_compact_bind_decl_cx_m(cx, type)
 
-// rb_bind_impl_m
-// --------------
-//
-// Bind rbtree functions to a context. This only generates implementations.
-//
-// rb_bind_impl_m uses the standard traits: rb_color_m, rb_parent_m,
-// rb_left_m, rb_right_m, whereas rb_bind_impl_cx_m expects you to create:
-// cx##_color_m, cx##_parent_m, cx##_left_m, cx##_right_m.
-//
-// cx
-//    Name of the new context.
-//
-// type
-//    The type of the nodes in the red-black tree.
-//
-// .. code-block:: cpp
-//
-#begindef _rb_bind_impl_tr_m(
+#begindef _rb_compact_bind_impl_tr_m(
         cx,
         type,
         color,
-        parent,
         left,
         right,
+        set,
         cmp
 )
     cx##_type_t cx##_nil_mem;
@@ -1334,150 +9111,97 @@ do {
             type** tree
     )
     {
-        rb_node_init_m(
-                cx##_nil_ptr,
-                color,
-                parent,
-                left,
-                right,
-                cx##_nil_ptr
-        );
+        cx##_node_init(cx##_nil_ptr);
         *tree = cx##_nil_ptr;
     }
     void
-    cx##_iter_init(
-            type* tree,
-            cx##_iter_t** iter,
-            type** elem
+    cx##_node_init(
+            type* node
     )
     {
-        (void)(iter);
-        rb_iter_init_m(
-            cx##_nil_ptr,
-            left,
-            tree,
-            *elem
-        );
+        set(color, node, RB_BLACK);
+        set(left, node, cx##_nil_ptr);
+        set(right, node, cx##_nil_ptr);
     }
-    void
-    cx##_iter_next(
-            cx##_iter_t* iter,
-            type** elem
+    int
+    cx##_insert(
+            type** tree,
+            type* node
     )
     {
-        (void)(iter);
-        rb_iter_next_m(
-            cx##_nil_ptr,
+        int ret;
+        rb_compact_insert_m(
             type,
-            parent,
+            cx##_nil_ptr,
+            color,
             left,
             right,
-            *elem
-        )
-    }
-    void
-    cx##_node_init(
-            type* node
-    )
-    {
-        rb_node_init_m(
-                cx##_nil_ptr,
-                color,
-                parent,
-                left,
-                right,
-                node
+            set,
+            cmp,
+            *tree,
+            node,
+            ret
         );
+        return ret;
     }
     int
-    cx##_insert(
+    cx##_delete(
             type** tree,
-            type* node
+            type* key
     )
     {
-        rb_insert_m(
+        type* node;
+        rb_compact_delete_m(
             type,
             cx##_nil_ptr,
             color,
-            parent,
             left,
             right,
+            set,
             cmp,
             *tree,
+            key,
             node
         );
-        return !(
-            parent(node) != cx##_nil_ptr ||
-            left(node) != cx##_nil_ptr ||
-            right(node) != cx##_nil_ptr ||
-            *tree == node
-        );
+        return node == cx##_nil_ptr;
     }
     void
-    cx##_delete_node(
+    cx##_clear(
             type** tree,
-            type* node
-    ) rb_delete_node_m(
+            void (*callback)(type* node, void* ctx),
+            void* ctx
+    ) rb_compact_clear_m(
         type,
         cx##_nil_ptr,
         color,
-        parent,
         left,
         right,
+        set,
         *tree,
-        node
-    )
-    int
-    cx##_delete(
-            type** tree,
-            type* key
+        callback,
+        ctx
     )
-    {
-        type* node;
-        if(cx##_find(*tree, key, &node) == 0) {
-            cx##_delete_node(tree, node);
-            return 0;
-        }
-        return 1;
-    }
-    int
-    cx##_replace_node(
+    void
+    cx##_delete_node(
             type** tree,
-            type* old,
-            type* new
+            type* node
     )
     {
-        rb_replace_node_m(
+        type* found;
+        rb_compact_delete_m(
             type,
             cx##_nil_ptr,
             color,
-            parent,
             left,
             right,
+            set,
             cmp,
             *tree,
-            old,
-            new
-        );
-        return !(
-            parent(old) == cx##_nil_ptr &&
-            left(old) == cx##_nil_ptr &&
-            right(old) == cx##_nil_ptr &&
-            old != *tree
+            node,
+            found
         );
-    }
-    int
-    cx##_replace(
-            type** tree,
-            type* key,
-            type* new
-    )
-    {
-        type* old;
-        if(cx##_find(*tree, key, &old) == 0) {
-            return cx##_replace_node(tree, old, new);
-        }
-        return 1;
+        assert(found == node && "Node is not in the tree");
+        (void)(found);
     }
     int
     cx##_find(
@@ -1490,7 +9214,7 @@ do {
             type,
             cx##_nil_ptr,
             color,
-            parent,
+            _rb_compact_no_parent_m, /* Not used */
             left,
             right,
             cmp,
@@ -1500,6 +9224,37 @@ do {
         );
         return *node == cx##_nil_ptr;
     }
+    void
+    cx##_iter_init(
+            type* tree,
+            cx##_iter_t** iter,
+            type** elem
+    )
+    {
+        rb_compact_iter_init_m(
+            type,
+            cx##_nil_ptr,
+            left,
+            tree,
+            (*iter),
+            *elem
+        );
+    }
+    void
+    cx##_iter_next(
+            cx##_iter_t* iter,
+            type** elem
+    )
+    {
+        rb_compact_iter_next_m(
+            type,
+            cx##_nil_ptr,
+            left,
+            right,
+            iter,
+            *elem
+        );
+    }
     RB_SIZE_T
     cx##_size(
             type* tree
@@ -1524,11 +9279,10 @@ do {
             type* node,
             int depth,
             int *pathdepth
-    ) rb_check_tree_m(
+    ) rb_compact_check_tree_m(
         cx,
         type,
         color,
-        parent,
         left,
         right,
         cmp,
@@ -1538,38 +9292,38 @@ do {
     )
 #enddef
 
-#begindef rb_bind_impl_cx_m(cx, type)
-    _rb_bind_impl_tr_m(
+#begindef rb_compact_bind_impl_cx_m(cx, type)
+    _rb_compact_bind_impl_tr_m(
         cx,
         type,
         cx##_color_m,
-        cx##_parent_m,
         cx##_left_m,
         cx##_right_m,
+        rb_trait_set_m,
         cx##_cmp_m
     )
 #enddef
 
-#begindef rb_bind_impl_m(cx, type)
-    _rb_bind_impl_tr_m(
+#begindef rb_compact_bind_impl_m(cx, type)
+    _rb_compact_bind_impl_tr_m(
         cx,
         type,
         rb_color_m,
-        rb_parent_m,
         rb_left_m,
         rb_right_m,
+        rb_lvalue_set_m,
         cx##_cmp_m
     )
 #enddef
 
-#begindef rb_bind_cx_m(cx, type)
-    rb_bind_decl_cx_m(cx, type)
-    rb_bind_impl_cx_m(cx, type)
+#begindef rb_compact_bind_cx_m(cx, type)
+    rb_compact_bind_decl_cx_m(cx, type)
+    rb_compact_bind_impl_cx_m(cx, type)
 #enddef
 
-#begindef rb_bind_m(cx, type)
-    rb_bind_decl_m(cx, type)
-    rb_bind_impl_m(cx, type)
+#begindef rb_compact_bind_m(cx, type)
+    rb_compact_bind_decl_m(cx, type)
+    rb_compact_bind_impl_m(cx, type)
 #enddef
 
 // rb_check_tree_m
@@ -1709,6 +9463,8 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         tree,
         node,
         x,
@@ -1719,11 +9475,11 @@ do {
     y = right(x);
 
     /* Turn y's left sub-tree into x's right sub-tree. */
-    right(x) = left(y);
+    set(right, x, left(y));
     if(left(y) != nil)
-        parent(left(y)) = x;
+        set(parent, left(y), x);
     /* y's new parent was x's parent. */
-    parent(y) = parent(x);
+    set(parent, y, parent(x));
     if(parent(x) == nil)
         /* If x is root y becomes the new root. */
         tree = y;
@@ -1731,14 +9487,16 @@ do {
         /* Set the parent to point to y instead of x. */
         if(x == left(parent(x)))
             /* x was on the left of its parent. */
-            left(parent(x)) = y;
+            set(left, parent(x), y);
         else
             /* x must have been on the right. */
-            right(parent(x)) = y;
+            set(right, parent(x), y);
     }
     /* Finally, put x on y's left. */
-    left(y) = x;
-    parent(x) = y;
+    set(left, y, x);
+    set(parent, x, y);
+    /* Only x and y have new sub-trees, x is below y. */
+    augment(x, parent(y));
 }
 #enddef
 
@@ -1749,6 +9507,8 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         tree,
         node
 )
@@ -1761,6 +9521,8 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         tree,
         node,
         __rb_rot_x_,
@@ -1777,6 +9539,8 @@ do {
         rb_parent_m,
         rb_left_m,
         rb_right_m,
+        rb_lvalue_set_m,
+        rb_no_augment_m,
         tree,
         node
     )
@@ -1789,6 +9553,8 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         tree,
         node
 )
@@ -1799,6 +9565,8 @@ do {
         parent,
         right, /* Switched */
         left,  /* Switched */
+        set,
+        augment,
         tree,
         node
     )
@@ -1812,6 +9580,8 @@ do {
         rb_parent_m,
         rb_left_m,
         rb_right_m,
+        rb_lvalue_set_m,
+        rb_no_augment_m,
         tree,
         node
     )
@@ -1841,6 +9611,8 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         tree,
         node,
         x,
@@ -1861,6 +9633,8 @@ do {
                 parent,
                 left,
                 right,
+                set,
+                augment,
                 _rb_rotate_left_m,
                 _rb_rotate_right_m,
                 tree,
@@ -1875,6 +9649,8 @@ do {
                 parent,
                 right, /* Switched */
                 left, /* Switched */
+                set,
+                augment,
                 _rb_rotate_left_m,
                 _rb_rotate_right_m,
                 tree,
@@ -1883,7 +9659,7 @@ do {
             );
         }
     }
-    rb_make_black_m(color(tree));
+    set(color, tree, RB_BLACK);
 }
 #enddef
 
@@ -1894,6 +9670,8 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         tree,
         node
 )
@@ -1907,6 +9685,8 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         tree,
         node,
         __rb_insf_x_,
@@ -1922,6 +9702,8 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         rot_left,
         rot_right,
         tree,
@@ -1932,9 +9714,9 @@ do {
     y = right(parent(parent(x)));
     /* Case 1: z’s uncle y is red. */
     if(rb_is_red_m(color(y))) {
-        rb_make_black_m(color(parent(x)));
-        rb_make_black_m(color(y));
-        rb_make_red_m(color(parent(parent(x))));
+        set(color, parent(x), RB_BLACK);
+        set(color, y, RB_BLACK);
+        set(color, parent(parent(x)), RB_RED);
         /* Locally property 3 is fixed, but changing the color of the
          * grandparent might have created a new violation. We continue with the
          * grandparent. */
@@ -1950,13 +9732,15 @@ do {
                 parent,
                 left,
                 right,
+                set,
+                augment,
                 tree,
                 x
             );
         }
         /* Case 3: z’s uncle y is black and z is a left child. */
-        rb_make_black_m(color(parent(x)));
-        rb_make_red_m(color(parent(parent(x))));
+        set(color, parent(x), RB_BLACK);
+        set(color, parent(parent(x)), RB_RED);
         rot_right(
             type,
             nil,
@@ -1964,6 +9748,8 @@ do {
             parent,
             left,
             right,
+            set,
+            augment,
             tree,
             parent(parent(x))
         );
@@ -1983,7 +9769,11 @@ do {
 //    The root node of the tree. A pointer to nil represents an empty tree.
 //
 // node
-//    The start-node to fix.
+//    The start-node to fix, it can be nil.
+//
+// xp
+//    The parent of *node*. We track it while moving up, since nil is never
+//    written.
 //
 // .. code-block:: cpp
 //
@@ -1994,8 +9784,11 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         tree,
         node,
+        xp,
         x,
         y
 )
@@ -2006,7 +9799,9 @@ do {
             (x != tree) &&
             rb_is_black_m(color(x))
     ) {
-        if(x == left(parent(x))) {
+        /* If x is nil, its sibling isn't, because it carries the black
+         * height. */
+        if(x == left(xp)) {
             _rb_delete_fix_node_m(
                 type,
                 nil,
@@ -2014,10 +9809,13 @@ do {
                 parent,
                 left,
                 right,
+                set,
+                augment,
                 _rb_rotate_left_m,
                 _rb_rotate_right_m,
                 tree,
                 x,
+                xp,
                 y
             );
         } else {
@@ -2028,16 +9826,20 @@ do {
                 parent,
                 right, /* Switched */
                 left, /* Switched */
+                set,
+                augment,
                 _rb_rotate_left_m,
                 _rb_rotate_right_m,
                 tree,
                 x,
+                xp,
                 y
             );
         }
     }
     /* If x is red we can introduce a real black node. */
-    rb_make_black_m(color(x));
+    if(x != nil)
+        set(color, x, RB_BLACK);
 }
 #enddef
 
@@ -2048,8 +9850,11 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         tree,
-        node
+        node,
+        xp
 )
 {
     type* __rb_delf_x_;
@@ -2061,8 +9866,11 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         tree,
         node,
+        xp,
         __rb_delf_x_,
         __rb_delf_y_
     );
@@ -2076,19 +9884,22 @@ do {
         parent,
         left,
         right,
+        set,
+        augment,
         rot_left,
         rot_right,
         tree,
         x,
+        xp,
         w
 )
 {
     /* X is double (extra) black. Goal: introduce a real black node. */
-    w = right(parent(x));
+    w = right(xp);
     /* Case 1: x’s sibling w is red. */
     if(rb_is_red_m(color(w))) {
-        rb_make_black_m(color(w));
-        rb_make_red_m(color(parent(x)));
+        set(color, w, RB_BLACK);
+        set(color, xp, RB_RED);
         rot_left(
             type,
             nil,
@@ -2096,26 +9907,29 @@ do {
             parent,
             left,
             right,
+            set,
+            augment,
             tree,
-            parent(x)
+            xp
         );
         /* Transforms into case 2, 3 or 4 */
-        w = right(parent(x));
+        w = right(xp);
     }
     if(
             rb_is_black_m(color(left(w))) &&
             rb_is_black_m(color(right(w)))
     ) {
         /* Case 2: x’s sibling w is black, and both of w’s children are black. */
-        rb_make_red_m(color(w));
+        set(color, w, RB_RED);
         /* Double blackness move up. Reenter loop. */
-        x = parent(x);
+        x = xp;
+        xp = parent(xp);
     } else {
         /* Case 3: x’s sibling w is black, w’s left child is red, and w’s right
          * child is black. */
         if(rb_is_black_m(color(right(w)))) {
-            rb_make_black_m(color(left(w)));
-            rb_make_red_m(color(w));
+            set(color, left(w), RB_BLACK);
+            set(color, w, RB_RED);
             rot_right(
                 type,
                 nil,
@@ -2123,16 +9937,18 @@ do {
                 parent,
                 left,
                 right,
+                set,
+                augment,
                 tree,
                 w
             );
-            w = right(parent(x));
+            w = right(xp);
         }
         /* Case 3: x’s sibling w is black, w’s left child is red, and w’s right
          * child is black. */
-        color(w) = color(parent(x));
-        rb_make_black_m(color(parent(x)));
-        rb_make_black_m(color(right(w)));
+        set(color, w, color(xp));
+        set(color, xp, RB_BLACK);
+        set(color, right(w), RB_BLACK);
         rot_left(
             type,
             nil,
@@ -2140,8 +9956,10 @@ do {
             parent,
             left,
             right,
+            set,
+            augment,
             tree,
-            parent(x)
+            xp
         );
         /* Terminate the loop. */
         x = tree;
@@ -2150,4 +9968,182 @@ do {
 }
 #enddef
 
+// _rb_join_m
+// ----------
+//
+// Internal: not bound
+//
+// Join *ltree*, *node* and *rtree*, all nodes of *ltree* have to be less than
+// *node* and all nodes of *rtree* greater. The roots are made black first. If
+// both trees have the same black height, *node* becomes the black root. Else
+// we go down the spine of the higher tree, facing the lower tree, to the first
+// black node with the black height of the lower tree. *node* takes its place
+// and becomes red, as if it was inserted. The insert fix restores the
+// red-black properties in O(log(N)) and leaves the root black.
+//
+// lbh, rbh
+//    The black height of *ltree* and *rtree*. They are changed.
+//
+// tree
+//    The joined tree.
+//
+// bh
+//    The black height of the joined tree.
+//
+// .. code-block:: cpp
+//
+#begindef _rb_join_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        ltree,
+        lbh,
+        node,
+        rtree,
+        rbh,
+        tree,
+        bh
+)
+{
+    type* __rb_join_x_;
+    type* __rb_join_y_;
+    type* __rb_join_c_;
+    type* __rb_join_p_;
+    if(ltree != nil && rb_is_red_m(color(ltree))) {
+        set(color, ltree, RB_BLACK);
+        lbh += 1;
+    }
+    if(rtree != nil && rb_is_red_m(color(rtree))) {
+        set(color, rtree, RB_BLACK);
+        rbh += 1;
+    }
+    if(lbh == rbh) {
+        set(left, node, ltree);
+        set(right, node, rtree);
+        if(ltree != nil)
+            set(parent, ltree, node);
+        if(rtree != nil)
+            set(parent, rtree, node);
+        set(parent, node, nil);
+        set(color, node, RB_BLACK);
+        augment(node, nil);
+        tree = node;
+        bh = lbh + 1;
+    } else if(lbh > rbh) {
+        __rb_join_spine_m(
+            type,
+            nil,
+            color,
+            parent,
+            left,
+            right,
+            set,
+            augment,
+            ltree,
+            lbh,
+            node,
+            rtree,
+            rbh,
+            bh,
+            __rb_join_c_,
+            __rb_join_p_,
+            __rb_join_x_,
+            __rb_join_y_
+        );
+        tree = ltree;
+    } else {
+        __rb_join_spine_m(
+            type,
+            nil,
+            color,
+            parent,
+            right, /* Switched */
+            left, /* Switched */
+            set,
+            augment,
+            rtree, /* Switched */
+            rbh, /* Switched */
+            node,
+            ltree, /* Switched */
+            lbh, /* Switched */
+            bh,
+            __rb_join_c_,
+            __rb_join_p_,
+            __rb_join_x_,
+            __rb_join_y_
+        );
+        tree = rtree;
+    }
+    assert(rb_is_black_m(color(tree)) && "The joined root has to be black");
+}
+#enddef
+
+#begindef __rb_join_spine_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        ltree,
+        lbh,
+        node,
+        rtree,
+        rbh,
+        bh,
+        c,
+        p,
+        x,
+        y
+)
+{
+    /* bh is the black height of c. */
+    c = ltree;
+    p = nil;
+    bh = lbh;
+    while(bh != rbh || rb_is_red_m(color(c))) {
+        if(rb_is_black_m(color(c)))
+            bh -= 1;
+        p = c;
+        c = right(c);
+    }
+    set(left, node, c);
+    set(right, node, rtree);
+    if(c != nil)
+        set(parent, c, node);
+    if(rtree != nil)
+        set(parent, rtree, node);
+    set(parent, node, p);
+    set(right, p, node);
+    set(color, node, RB_RED);
+    augment(node, nil);
+    __rb_insert_fix_m(
+        type,
+        nil,
+        color,
+        parent,
+        left,
+        right,
+        set,
+        augment,
+        ltree,
+        node,
+        x,
+        y
+    );
+    /* Only if case 1 reached the root, it was colored red and then black
+     * again. */
+    bh = lbh;
+    if(x == ltree)
+        bh += 1;
+}
+#enddef
+
 #endif // rb_tree_h
@@ -0,0 +1,97 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <limits.h>
+
+static
+int
+check_max(augnode_t* node)
+{
+    if(node == ma_nil_ptr)
+        return INT_MIN;
+    int max = node->weight;
+    int lmax = check_max(rb_left_m(node));
+    int rmax = check_max(rb_right_m(node));
+    if(lmax > max)
+        max = lmax;
+    if(rmax > max)
+        max = rmax;
+    assert(node->max == max && "Wrong sub-tree aggregate");
+    return max;
+}
+
+int
+test_aug(int len, int* nodes, int* weights)
+{
+    int ret = 0;
+    augnode_t* mnodes = malloc(len * sizeof(augnode_t));
+    augnode_t* nnodes = malloc(len * sizeof(augnode_t));
+    augnode_t** pnodes = malloc(len * sizeof(augnode_t*));
+    char* inserted = malloc(len);
+    do {
+        augnode_t* tree;
+        augnode_t* node;
+        augnode_t* other;
+        int i;
+        ma_tree_init(&tree);
+        for(i = 0; i < len; i++) {
+            node = &mnodes[i];
+            ma_node_init(node);
+            rb_value_m(node) = nodes[i];
+            node->weight = weights[i];
+            inserted[i] = ma_insert(&tree, node) == 0;
+            /* A rejected node must be a duplicate of a node in the tree. */
+            BA(
+                inserted[i] || (
+                    ma_find(tree, node, &other) == 0 &&
+                    other != node &&
+                    rb_value_m(other) == nodes[i]
+                ),
+                "Insert failed"
+            );
+            ma_check_tree(tree);
+            check_max(tree);
+        }
+        BA(i == len, "Insert failed");
+        /* Replace every inserted node with one of a different weight. */
+        for(i = 0; i < len; i++) {
+            if(!inserted[i])
+                continue;
+            node = &nnodes[i];
+            rb_value_m(node) = nodes[i];
+            node->weight = weights[len - i - 1];
+            BA(ma_replace_node(&tree, &mnodes[i], node) == 0, "Replace failed");
+            ma_check_tree(tree);
+            check_max(tree);
+        }
+        BA(i == len, "Replace failed");
+        BA(
+            rb_left_m(ma_nil_ptr) == ma_nil_ptr &&
+            rb_right_m(ma_nil_ptr) == ma_nil_ptr,
+            "Nil was written"
+        );
+        /* Delete the root len / 2 times. */
+        i = 0;
+        while(tree != ma_nil_ptr && i < len / 2) {
+            ma_delete_node(&tree, tree);
+            ma_check_tree(tree);
+            check_max(tree);
+            i += 1;
+        }
+        /* Rebuild from the sorted nodes. */
+        i = 0;
+        rb_iter_decl_cx_m(ma, iter, elem);
+        rb_for_m(ma, tree, iter, elem) {
+            pnodes[i++] = elem;
+        }
+        ma_tree_init(&tree);
+        ma_build_sorted(&tree, pnodes, i);
+        ma_check_tree(tree);
+        check_max(tree);
+    } while(0);
+    free(inserted);
+    free(pnodes);
+    free(nnodes);
+    free(mnodes);
+    return ret;
+}
@@ -0,0 +1,2 @@
+int
+test_aug(int len, int* nodes, int* weights);
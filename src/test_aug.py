@@ -0,0 +1,24 @@
+"""Test if the sub-tree aggregates are consistent."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+@given(st.lists(
+    st.tuples(
+        st.integers(
+            min_value=-(2 ** 30),
+            max_value=2 ** 30
+        ),
+        st.integers(
+            min_value=-(2 ** 30),
+            max_value=2 ** 30
+        )
+    )
+))
+def test_aug(pairs):
+    """Test the aggregate after generated inserts, replaces and deletes."""
+    nodes = [p[0] for p in pairs]
+    weights = [p[1] for p in pairs]
+    call_ffi(lib.test_aug, len(pairs), nodes, weights)
@@ -0,0 +1,54 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+int
+test_batch(int len, int* nodes, int klen, int* keys)
+{
+    int ret = 0;
+    node_t* mnodes = malloc(len * sizeof(node_t));
+    node_t* knodes = malloc(klen * sizeof(node_t));
+    node_t** pkeys = malloc(klen * sizeof(node_t*));
+    node_t** out = malloc(klen * sizeof(node_t*));
+    do {
+        node_t* tree;
+        node_t* node;
+        size_t found = 0;
+        int i;
+        my_tree_init(&tree);
+        for(i = 0; i < klen; i++) {
+            rb_value_m(&knodes[i]) = keys[i];
+            pkeys[i] = &knodes[i];
+        }
+        BA(
+            my_find_batch(tree, pkeys, klen, out) == 0,
+            "Found key in empty tree"
+        );
+        for(i = 0; i < klen; i++)
+            BA(out[i] == my_nil_ptr, "Empty tree returned a node");
+        BA(i == klen, "Empty tree returned a node");
+        for(i = 0; i < len; i++) {
+            node = &mnodes[i];
+            my_node_init(node);
+            rb_value_m(node) = nodes[i];
+            my_insert(&tree, node);
+        }
+        /* The batch agrees with the scalar lookups. */
+        for(i = 0; i < klen; i++)
+            found += my_find(tree, pkeys[i], &node) == 0;
+        BA(
+            my_find_batch(tree, pkeys, klen, out) == found,
+            "Wrong number of keys found"
+        );
+        for(i = 0; i < klen; i++) {
+            my_find(tree, pkeys[i], &node);
+            BA(out[i] == node, "Batch lookup differs");
+        }
+        BA(i == klen, "Batch lookup differs");
+    } while(0);
+    free(out);
+    free(pkeys);
+    free(knodes);
+    free(mnodes);
+    return ret;
+}
@@ -0,0 +1,2 @@
+int
+test_batch(int len, int* nodes, int klen, int* keys);
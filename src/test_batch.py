@@ -0,0 +1,24 @@
+"""Test interleaved batch lookups."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+_int = st.integers(
+    min_value=-1000,
+    max_value=1000
+)
+
+
+@given(st.lists(_int), st.lists(_int))
+def test_batch(ints, keys):
+    """Test that find_batch finds the same nodes as find."""
+    call_ffi(lib.test_batch, len(ints), ints, len(keys), keys)
+
+
+def test_batch_large():
+    """Test batches larger than RB_BATCH."""
+    ints = [(x * 7919) % 3001 for x in range(3001)]
+    keys = [(x * 13) % 4001 for x in range(1000)]
+    call_ffi(lib.test_batch, len(ints), ints, len(keys), keys)
@@ -0,0 +1,70 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+static
+int
+check_bound(int ret, node_t* node, int* sorted, int index)
+{
+    if(index < 0) {
+        TA(ret == 1, "Bound should fail");
+        TA(node == my_nil_ptr, "Bound should be nil");
+    } else {
+        TA(ret == 0, "Bound failed");
+        TA(rb_value_m(node) == sorted[index], "Wrong bound");
+    }
+    return 0;
+}
+
+int
+test_bound(int len, int* nodes, int* sorted, int count, int key)
+{
+    int ret = 0;
+    node_t* mnodes = malloc(len * sizeof(node_t));
+    do {
+        mh_tree_t tree;
+        node_t* node;
+        node_t knode;
+        int lower = -1;
+        int upper = -1;
+        int floor = -1;
+        mh_tree_init(&tree);
+        for(int i = 0; i < len; i++) {
+            node = &mnodes[i];
+            mh_node_init(node);
+            rb_value_m(node) = nodes[i];
+            mh_insert(&tree, node);
+        }
+        /* Scan the sorted values for the expected bounds. */
+        for(int i = count - 1; i >= 0; i--) {
+            if(sorted[i] >= key)
+                lower = i;
+            if(sorted[i] > key)
+                upper = i;
+        }
+        for(int i = 0; i < count; i++) {
+            if(sorted[i] <= key)
+                floor = i;
+        }
+        rb_value_m(&knode) = key;
+        int r;
+        r = my_lower_bound(tree.root, &knode, &node);
+        BA(check_bound(r, node, sorted, lower) == 0, "Lower bound failed");
+        r = my_upper_bound(tree.root, &knode, &node);
+        BA(check_bound(r, node, sorted, upper) == 0, "Upper bound failed");
+        r = my_floor(tree.root, &knode, &node);
+        BA(check_bound(r, node, sorted, floor) == 0, "Floor failed");
+        r = my_ceil(tree.root, &knode, &node);
+        BA(check_bound(r, node, sorted, lower) == 0, "Ceil failed");
+        r = mh_lower_bound(&tree, &knode, &node);
+        BA(check_bound(r, node, sorted, lower) == 0, "Lower bound failed");
+        r = mh_upper_bound(&tree, &knode, &node);
+        BA(check_bound(r, node, sorted, upper) == 0, "Upper bound failed");
+        r = mh_floor(&tree, &knode, &node);
+        BA(check_bound(r, node, sorted, floor) == 0, "Floor failed");
+        r = mh_ceil(&tree, &knode, &node);
+        BA(check_bound(r, node, sorted, lower) == 0, "Ceil failed");
+    } while(0);
+    free(mnodes);
+    return ret;
+}
@@ -0,0 +1,81 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+int
+test_btree(int len, int* nodes, int* sorted, int count, int key)
+{
+    int ret = 0;
+    node_t* mnodes = malloc(len * sizeof(node_t));
+    mt_btree_t* tree;
+    mt_tree_init(&tree);
+    do {
+        node_t* node;
+        node_t knode;
+        int i;
+        for(i = 0; i < len; i++) {
+            node = &mnodes[i];
+            rb_value_m(node) = nodes[i];
+            mt_insert(&tree, node);
+        }
+        mt_check_tree(tree);
+        BA(mt_size(tree) == (size_t) count, "Wrong size");
+        i = 0;
+        bt_iter_decl_m(mt, iter, elem);
+        rb_for_m(mt, tree, iter, elem) {
+            BA(i < count && rb_value_m(elem) == sorted[i], "Wrong order");
+            i += 1;
+        }
+        BA(i == count, "Iteration failed");
+        for(i = 0; i < count; i++) {
+            BA(mt_find_key(tree, sorted[i], &node) == 0, "Not found");
+            BA(rb_value_m(node) == sorted[i], "Wrong node");
+        }
+        BA(i == count, "Find failed");
+        /* Compare lower_bound with the sorted array. */
+        rb_value_m(&knode) = key;
+        i = 0;
+        while(i < count && sorted[i] < key)
+            i += 1;
+        BA(
+            mt_lower_bound(tree, &knode, &node) == (i == count),
+            "Wrong lower bound"
+        );
+        BA(
+            (i == count && node == NULL) ||
+            (i < count && rb_value_m(node) == sorted[i]),
+            "Wrong lower bound"
+        );
+        BA(
+            mt_find(tree, &knode, &node) ==
+            (i == count || sorted[i] != key),
+            "Wrong find"
+        );
+        for(i = 0; i < count; i += 2) {
+            rb_value_m(&knode) = sorted[i];
+            BA(mt_delete(&tree, &knode) == 0, "Delete failed");
+        }
+        BA(i >= count, "Delete failed");
+        mt_check_tree(tree);
+        BA(mt_size(tree) == (size_t) count / 2, "Wrong size");
+        for(i = 0; i < count; i++)
+            BA(
+                mt_find_key(tree, sorted[i], &node) == (i % 2 == 0),
+                "Wrong node deleted"
+            );
+        BA(i == count, "Wrong node deleted");
+        rb_value_m(&knode) = 1001;
+        BA(mt_delete(&tree, &knode) == 1, "Deleted missing key");
+        for(i = 1; i < count; i += 2) {
+            BA(mt_find_key(tree, sorted[i], &node) == 0, "Not found");
+            mt_delete_node(&tree, node);
+            if(i % 64 == 1)
+                mt_check_tree(tree);
+        }
+        BA(i >= count, "Delete node failed");
+        BA(tree == NULL, "Tree not empty");
+    } while(0);
+    mt_clear(&tree, NULL, NULL);
+    free(mnodes);
+    return ret;
+}
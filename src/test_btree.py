@@ -0,0 +1,36 @@
+"""Test the B-tree engine."""
+import random
+
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+def deduplicate(seq):
+    """Deduplicate a list."""
+    seen = set()
+    seen_add = seen.add
+    return [x for x in seq if not (x in seen or seen_add(x))]
+
+
+_int = st.integers(
+    min_value=-1000,
+    max_value=1000
+)
+
+
+@given(st.lists(_int), _int)
+def test_btree(ints, key):
+    """Test insert, find, lower_bound, iteration and delete."""
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_btree, len(ints), ints, ss, len(ss), key)
+
+
+@given(st.integers(min_value=0), st.integers(0, 3000), _int)
+def test_btree_random(seed, size, key):
+    """Test trees with a few levels, splits and merges."""
+    rand = random.Random(seed)
+    ints = [rand.randint(-1000, 1000) for _ in range(size)]
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_btree, len(ints), ints, ss, len(ss), key)
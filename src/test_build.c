@@ -0,0 +1,55 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+int
+test_build(int len, int* sorted, int sum, int do_sum)
+{
+    int ret = 0;
+    node_t* mnodes = malloc(len * sizeof(node_t));
+    node_t** pnodes = malloc(len * sizeof(node_t*));
+    do {
+        node_t* tree;
+        my_tree_init(&tree);
+        for(int i = 0; i < len; i++) {
+            pnodes[i] = &mnodes[i];
+            rb_value_m(pnodes[i]) = sorted[i];
+        }
+        my_build_sorted(&tree, pnodes, len);
+        my_check_tree(tree);
+        if(len == 0) {
+            BA(tree == my_nil_ptr, "Empty build should be nil");
+        } else {
+            BA(rb_parent_m(tree) == my_nil_ptr, "Tree is not root");
+        }
+        BA(my_size(tree) == len, "Size failed");
+        int tsum = 0;
+        int elems = 0;
+        int fail = 0;
+        rb_iter_decl_cx_m(my, iter, elem);
+        rb_for_m(my, tree, iter, elem) {
+            if(sorted[elems] != rb_value_m(elem))
+                fail = 1;
+            tsum += rb_value_m(elem);
+            elems += 1;
+        }
+        BA(fail == 0, "Not correctly sorted");
+        BA(elems == len, "Iterator count failed");
+        if(do_sum)
+            BA(tsum == sum, "Iterator sum failed");
+        /* The built tree has to stay consistent on further updates. */
+        for(int i = 0; i < len; i += 2) {
+            my_delete_node(&tree, pnodes[i]);
+            my_check_tree(tree);
+        }
+        BA(my_size(tree) == len / 2, "Size after delete failed");
+        for(int i = 0; i < len; i += 2) {
+            BA(my_insert(&tree, pnodes[i]) == 0, "Insert failed");
+            my_check_tree(tree);
+        }
+        BA(my_size(tree) == len, "Size after insert failed");
+    } while(0);
+    free(pnodes);
+    free(mnodes);
+    return ret;
+}
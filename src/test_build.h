@@ -0,0 +1,2 @@
+int
+test_build(int len, int* sorted, int sum, int do_sum);
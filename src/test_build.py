@@ -0,0 +1,29 @@
+"""Test if we can build a tree from sorted nodes."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+@given(st.sets(
+    st.integers(
+        min_value=-(2 ** 30),
+        max_value=2 ** 30
+    )
+))
+def test_build(ints):
+    """Test if rbtree is consistent after building from sorted nodes."""
+    ss = sorted(ints)
+    s = sum(ss)
+    do_sum = True
+    if abs(s) > (2**32 / 2) - 1:
+        do_sum = False
+        s = 0
+    call_ffi(lib.test_build, len(ss), ss, s, do_sum)
+
+
+def test_build_sizes():
+    """Test if rbtree is consistent for all small sizes."""
+    for c in range(130):
+        ss = list(range(c))
+        call_ffi(lib.test_build, c, ss, sum(ss), True)
@@ -0,0 +1,74 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+static
+int
+check_values(chnode_t* tree, int* sorted, int count)
+{
+    int i = 0;
+    rb_iter_decl_cx_m(mb, iter, elem);
+    mb_check_tree(tree);
+    rb_for_m(mb, tree, iter, elem) {
+        TA(i < count, "Too many nodes");
+        TA(elem->value == sorted[i], "Wrong node");
+        i += 1;
+    }
+    TA(i == count, "Too few nodes");
+    return 0;
+}
+
+int
+test_child(int len, int* nodes, int* sorted, int count, int key)
+{
+    int ret = 0;
+    chnode_t* mnodes = malloc(len * sizeof(chnode_t));
+    do {
+        chnode_t* tree;
+        chnode_t* node;
+        chnode_t knode;
+        int at = 0;
+        int i;
+        mb_tree_init(&tree);
+        for(i = 0; i < len; i++) {
+            node = &mnodes[i];
+            mb_node_init(node);
+            node->value = nodes[i];
+            if(mb_insert(&tree, node) != 0)
+                BA(rb_parent_m(node) == mb_nil_ptr, "Duplicate linked");
+        }
+        BA(i == len, "Duplicate linked");
+        BA(check_values(tree, sorted, count) == 0, "Insert failed");
+        while(at < count && sorted[at] < key)
+            at += 1;
+        knode.value = key;
+        mb_lower_bound(tree, &knode, &node);
+        BA(
+            at < count ? node->value == sorted[at] : node == mb_nil_ptr,
+            "Wrong lower bound"
+        );
+        if(at < count && sorted[at] == key)
+            at += 1;
+        mb_upper_bound(tree, &knode, &node);
+        BA(
+            at < count ? node->value == sorted[at] : node == mb_nil_ptr,
+            "Wrong upper bound"
+        );
+        for(i = 0; i < count; i++) {
+            knode.value = sorted[i];
+            BA(mb_find(tree, &knode, &node) == 0, "Node not found");
+            BA(node->value == sorted[i], "Found wrong node");
+            mb_delete_node(&tree, node);
+            if(i % 16 == 0) {
+                BA(
+                    check_values(tree, sorted + i + 1, count - i - 1) == 0,
+                    "Delete failed"
+                );
+            }
+        }
+        BA(i == count, "Delete failed");
+        BA(tree == mb_nil_ptr, "Tree not empty");
+    } while(0);
+    free(mnodes);
+    return ret;
+}
@@ -0,0 +1,2 @@
+int
+test_child(int len, int* nodes, int* sorted, int count, int key);
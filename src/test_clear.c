@@ -0,0 +1,93 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static
+void
+count_node(node_t* node, void* ctx)
+{
+    int* count = ctx;
+    if(
+            rb_is_black_m(rb_color_m(node)) &&
+            rb_parent_m(node) == my_nil_ptr &&
+            rb_left_m(node) == my_nil_ptr &&
+            rb_right_m(node) == my_nil_ptr
+    )
+        *count += 1;
+}
+
+static
+void
+count_cpnode(cpnode_t* node, void* ctx)
+{
+    int* count = ctx;
+    if(
+            rb_is_black_m(rb_color_m(node)) &&
+            rb_left_m(node) == mc_nil_ptr &&
+            rb_right_m(node) == mc_nil_ptr
+    )
+        *count += 1;
+}
+
+int
+test_clear(int len, int* nodes, int count)
+{
+    int ret = 0;
+    node_t* mnodes = malloc(len * sizeof(node_t));
+    cpnode_t* cnodes = malloc(len * sizeof(cpnode_t));
+    do {
+        node_t* tree;
+        node_t* node;
+        node_t nil;
+        mh_tree_t head;
+        cpnode_t* ctree;
+        int visited;
+        my_tree_init(&tree);
+        memcpy(&nil, my_nil_ptr, sizeof(node_t));
+        for(int i = 0; i < len; i++) {
+            node = &mnodes[i];
+            my_node_init(node);
+            rb_value_m(node) = nodes[i];
+            my_insert(&tree, node);
+        }
+        visited = 0;
+        my_clear(&tree, count_node, &visited);
+        BA(tree == my_nil_ptr, "Tree not empty");
+        BA(visited == count, "Not all nodes visited once and reset");
+        BA(memcmp(&nil, my_nil_ptr, sizeof(node_t)) == 0, "Clear wrote nil");
+        /* Cleared nodes can be inserted again. */
+        for(int i = 0; i < len; i++)
+            my_insert(&tree, &mnodes[i]);
+        BA(my_size(tree) == count, "Reinsert failed");
+        my_check_tree(tree);
+        my_clear(&tree, NULL, NULL);
+        BA(tree == my_nil_ptr, "Tree not empty");
+        mh_tree_init(&head);
+        for(int i = 0; i < len; i++)
+            mh_insert(&head, &mnodes[i]);
+        visited = 0;
+        mh_clear(&head, count_node, &visited);
+        BA(visited == count, "Not all head nodes visited");
+        BA(mh_size(&head) == 0, "Head size not reset");
+        BA(mh_first(&head) == mh_nil_ptr, "Head first not reset");
+        BA(mh_last(&head) == mh_nil_ptr, "Head last not reset");
+        mc_tree_init(&ctree);
+        for(int i = 0; i < len; i++) {
+            mc_node_init(&cnodes[i]);
+            rb_value_m(&cnodes[i]) = nodes[i];
+            mc_insert(&ctree, &cnodes[i]);
+        }
+        visited = 0;
+        mc_clear(&ctree, count_cpnode, &visited);
+        BA(ctree == mc_nil_ptr, "Compact tree not empty");
+        BA(visited == count, "Not all compact nodes visited once and reset");
+        for(int i = 0; i < len; i++)
+            mc_insert(&ctree, &cnodes[i]);
+        BA(mc_size(ctree) == count, "Compact reinsert failed");
+        mc_check_tree(ctree);
+    } while(0);
+    free(cnodes);
+    free(mnodes);
+    return ret;
+}
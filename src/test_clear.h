@@ -0,0 +1,2 @@
+int
+test_clear(int len, int* nodes, int count);
@@ -0,0 +1,60 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+static
+int
+check_values(cpnode_t* tree, int* sorted, int count)
+{
+    int i = 0;
+    rb_compact_iter_decl_cx_m(mc, iter, elem);
+    mc_check_tree(tree);
+    TA(mc_size(tree) == count, "Wrong tree size");
+    rb_for_m(mc, tree, iter, elem) {
+        TA(i < count, "Too many nodes");
+        TA(rb_value_m(elem) == sorted[i], "Wrong node");
+        i += 1;
+    }
+    TA(i == count, "Too few nodes");
+    return 0;
+}
+
+int
+test_compact(int len, int* nodes, int* sorted, int count)
+{
+    int ret = 0;
+    int inserted = 0;
+    cpnode_t* mnodes = malloc(len * sizeof(cpnode_t));
+    do {
+        cpnode_t* tree;
+        cpnode_t* node;
+        cpnode_t key;
+        BA(sizeof(cpnode_t) < sizeof(node_t), "Compact node is not smaller");
+        mc_tree_init(&tree);
+        for(int i = 0; i < len; i++) {
+            node = &mnodes[i];
+            mc_node_init(node);
+            rb_value_m(node) = nodes[i];
+            inserted += mc_insert(&tree, node) == 0;
+        }
+        BA(inserted == count, "Duplicates were inserted");
+        BA(check_values(tree, sorted, count) == 0, "Insert failed");
+        /* Delete every second node by key, the others by node. */
+        for(int i = 0; i < count; i += 2) {
+            rb_value_m(&key) = sorted[i];
+            BA(mc_delete(&tree, &key) == 0, "Node not deleted");
+            BA(mc_find(tree, &key, &node) != 0, "Node still found");
+            BA(mc_delete(&tree, &key) != 0, "Node deleted twice");
+        }
+        mc_check_tree(tree);
+        for(int i = 1; i < count; i += 2) {
+            rb_value_m(&key) = sorted[i];
+            BA(mc_find(tree, &key, &node) == 0, "Node not found");
+            mc_delete_node(&tree, node);
+            mc_check_tree(tree);
+        }
+        BA(tree == mc_nil_ptr, "Tree not empty");
+    } while(0);
+    free(mnodes);
+    return ret;
+}
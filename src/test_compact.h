@@ -0,0 +1,2 @@
+int
+test_compact(int len, int* nodes, int* sorted, int count);
@@ -0,0 +1,32 @@
+"""Test if the compact engine keeps the tree consistent."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+def deduplicate(seq):
+    """Deduplicate a list."""
+    seen = set()
+    seen_add = seen.add
+    return [x for x in seq if not (x in seen or seen_add(x))]
+
+
+_int = st.integers(
+    min_value=-1000,
+    max_value=1000
+)
+
+
+@given(st.lists(_int))
+def test_compact(ints):
+    """Test insert, find, iteration and delete without parent pointers."""
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_compact, len(ints), ints, ss, len(ss))
+
+
+def test_compact_large():
+    """Test the compact engine with a larger tree."""
+    ints = [(x * 7919) % 3001 for x in range(3001)]
+    ss = sorted(ints)
+    call_ffi(lib.test_compact, len(ints), ints, ss, len(ss))
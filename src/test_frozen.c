@@ -0,0 +1,117 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+int
+test_frozen(int len, int* nodes, int* sorted, int count, int key)
+{
+    int ret = 0;
+    node_t* mnodes = malloc(len * sizeof(node_t));
+    my_frozen_t frozen;
+    frozen.keys = NULL;
+    frozen.nodes = NULL;
+    do {
+        node_t* tree;
+        node_t* node;
+        node_t* bound;
+        node_t knode;
+        int i;
+        my_tree_init(&tree);
+        for(i = 0; i < len; i++) {
+            node = &mnodes[i];
+            my_node_init(node);
+            rb_value_m(node) = nodes[i];
+            my_insert(&tree, node);
+        }
+        BA(my_freeze(tree, &frozen) == 0, "Freeze failed");
+        BA(frozen.n == (size_t) count, "Wrong size");
+        for(i = 0; i < count; i++) {
+            BA(my_frozen_find(&frozen, sorted[i], &node) == 0, "Not found");
+            BA(my_find(tree, node, &bound) == 0, "Not the original node");
+            BA(node == bound, "Not the original node");
+        }
+        BA(i == count, "Frozen find failed");
+        /* The snapshot agrees with the tree. */
+        rb_value_m(&knode) = key;
+        BA(
+            my_frozen_find(&frozen, key, &node) ==
+            my_find(tree, &knode, &bound),
+            "Frozen find differs"
+        );
+        BA(node == bound, "Frozen find differs");
+        BA(
+            my_frozen_lower_bound(&frozen, key, &node) ==
+            my_lower_bound(tree, &knode, &bound),
+            "Frozen lower bound differs"
+        );
+        BA(node == bound, "Frozen lower bound differs");
+        /* The snapshot doesn't follow the tree. */
+        if(count > 0) {
+            BA(my_delete_key(&tree, sorted[0]) == 0, "Delete key failed");
+            BA(my_frozen_find(&frozen, sorted[0], &node) == 0, "Not found");
+            BA(rb_value_m(node) == sorted[0], "Wrong node");
+        }
+    } while(0);
+    my_frozen_free(&frozen);
+    TA(frozen.keys == NULL && frozen.n == 0, "Free failed");
+    free(mnodes);
+    return ret;
+}
+
+static
+void
+test_frozen_layout(int* sorted, int32_t* k32, int64_t* k64, int count)
+{
+    int i;
+    size_t k = 1;
+    size_t n = count;
+    while(2 * k <= n)
+        k *= 2;
+    for(i = 0; i < count; i++) {
+        k32[k] = sorted[i];
+        k64[k] = (int64_t) sorted[i] * 4294967296LL;
+        if(2 * k + 1 <= n) {
+            k = 2 * k + 1;
+            while(2 * k <= n)
+                k *= 2;
+        } else
+            k = rb_eytzinger_up(k);
+    }
+}
+
+int
+test_frozen_int(int* sorted, int count, int key)
+{
+    int ret = 0;
+    int32_t* k32 = malloc((count + 1) * sizeof(int32_t));
+    int64_t* k64 = malloc((count + 1) * sizeof(int64_t));
+    test_frozen_layout(sorted, k32, k64, count);
+    do {
+        int i;
+        for(i = 0; i <= 2 * count; i++) {
+            size_t k;
+            size_t g;
+            int q = key;
+            int lb = 0;
+            if(i < 2 * count)
+                q = sorted[i / 2] - (i & 1);
+            while(lb < count && sorted[lb] < q)
+                lb += 1;
+            rb_eytzinger_lower_bound_m(
+                int32_t, int32_t, rb_safe_cmp_m, k32, (size_t) count, q, g
+            );
+            BA(
+                (g == 0) == (lb == count) && (g == 0 || k32[g] == sorted[lb]),
+                "Scalar search failed"
+            );
+            k = rb_eytzinger_i32(k32, count, q);
+            BA(k == g, "Int32 search differs");
+            k = rb_eytzinger_i64(k64, count, (int64_t) q * 4294967296LL);
+            BA(k == g, "Int64 search differs");
+        }
+        BA(i == 2 * count + 1, "Int search failed");
+    } while(0);
+    free(k32);
+    free(k64);
+    return ret;
+}
@@ -0,0 +1,4 @@
+int
+test_frozen(int len, int* nodes, int* sorted, int count, int key);
+int
+test_frozen_int(int* sorted, int count, int key);
@@ -0,0 +1,45 @@
+"""Test frozen snapshots."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+def deduplicate(seq):
+    """Deduplicate a list."""
+    seen = set()
+    seen_add = seen.add
+    return [x for x in seq if not (x in seen or seen_add(x))]
+
+
+_int = st.integers(
+    min_value=-1000,
+    max_value=1000
+)
+
+
+@given(st.lists(_int), _int)
+def test_frozen(ints, key):
+    """Test frozen_find and frozen_lower_bound against the tree."""
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_frozen, len(ints), ints, ss, len(ss), key)
+
+
+def test_frozen_large():
+    """Test a snapshot with a partial last level."""
+    ints = [(x * 7919) % 3001 for x in range(3001)]
+    ss = sorted(ints)
+    call_ffi(lib.test_frozen, len(ints), ints, ss, len(ss), 1500)
+
+
+@given(st.lists(_int), _int)
+def test_frozen_int(ints, key):
+    """Test the int32 and int64 searches against the scalar search."""
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_frozen_int, ss, len(ss), key)
+
+
+def test_frozen_int_large():
+    """Test the int searches on full SIMD steps."""
+    ss = list(range(-1500, 1501, 3))
+    call_ffi(lib.test_frozen_int, ss, len(ss), 1)
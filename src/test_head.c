@@ -0,0 +1,82 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+static
+int
+assert_head(mh_tree_t* tree, int* sorted, int lo, int hi)
+{
+    mh_check_tree(tree);
+    TA(mh_size(tree) == hi - lo, "Size failed");
+    if(lo == hi) {
+        TA(mh_first(tree) == mh_nil_ptr, "First should be nil");
+        TA(mh_last(tree) == mh_nil_ptr, "Last should be nil");
+    } else {
+        TA(rb_value_m(mh_first(tree)) == sorted[lo], "Wrong first node");
+        TA(rb_value_m(mh_last(tree)) == sorted[hi - 1], "Wrong last node");
+    }
+    return 0;
+}
+
+int
+test_head(int len, int* nodes, int* sorted, int count)
+{
+    int ret = 0;
+    node_t* mnodes = malloc(len * sizeof(node_t));
+    node_t* new = malloc(sizeof(node_t));
+    do {
+        mh_tree_t tree;
+        mh_tree_init(&tree);
+        BA(assert_head(&tree, sorted, 0, 0) == 0, "Init failed");
+        node_t* node;
+        for(int i = 0; i < len; i++) {
+            node = &mnodes[i];
+            mh_node_init(node);
+            rb_value_m(node) = nodes[i];
+            mh_insert(&tree, node);
+            mh_check_tree(&tree);
+        }
+        BA(assert_head(&tree, sorted, 0, count) == 0, "Insert failed");
+        int elems = 0;
+        int fail = 0;
+        rb_iter_decl_cx_m(mh, iter, elem);
+        rb_for_m(mh, &tree, iter, elem) {
+            if(sorted[elems] != rb_value_m(elem))
+                fail = 1;
+            elems += 1;
+        }
+        BA(fail == 0, "Not correctly sorted");
+        BA(elems == count, "Iterator count failed");
+        if(count == 0)
+            break;
+        /* Replace the first and the last node. */
+        node = mh_first(&tree);
+        rb_value_m(new) = rb_value_m(node);
+        BA(mh_replace_node(&tree, node, new) == 0, "Replace failed");
+        BA(mh_first(&tree) == new, "Replaced node should be first");
+        BA(mh_replace_node(&tree, new, node) == 0, "Replace failed");
+        node = mh_last(&tree);
+        rb_value_m(new) = rb_value_m(node);
+        BA(mh_replace(&tree, node, new) == 0, "Replace failed");
+        BA(mh_last(&tree) == new, "Replaced node should be last");
+        BA(mh_replace(&tree, new, node) == 0, "Replace failed");
+        /* Delete alternately from both ends. */
+        int lo = 0;
+        int hi = count;
+        while(lo < hi) {
+            if((lo + hi) % 2) {
+                mh_delete_node(&tree, mh_first(&tree));
+                lo += 1;
+            } else {
+                BA(mh_delete(&tree, mh_last(&tree)) == 0, "Delete failed");
+                hi -= 1;
+            }
+            BA(assert_head(&tree, sorted, lo, hi) == 0, "Delete failed");
+        }
+        BA(ret == 0, "Delete failed");
+        BA(tree.root == mh_nil_ptr, "Tree should be empty");
+    } while(0);
+    free(new);
+    free(mnodes);
+    return ret;
+}
@@ -0,0 +1,2 @@
+int
+test_head(int len, int* nodes, int* sorted, int count);
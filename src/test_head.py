@@ -0,0 +1,24 @@
+"""Test if the tree head stays consistent."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+def deduplicate(seq):
+    """Deduplicate a list."""
+    seen = set()
+    seen_add = seen.add
+    return [x for x in seq if not (x in seen or seen_add(x))]
+
+
+@given(st.lists(
+    st.integers(
+        min_value=-(2 ** 30),
+        max_value=2 ** 30
+    )
+))
+def test_head(ints):
+    """Test if size, first and last are kept up to date."""
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_head, len(ints), ints, ss, len(ss))
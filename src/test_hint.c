@@ -0,0 +1,86 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+static
+int
+check_sorted(node_t* tree, int* sorted, int count)
+{
+    int i = 0;
+    rb_iter_decl_cx_m(my, iter, elem);
+    my_check_tree(tree);
+    rb_for_m(my, tree, iter, elem) {
+        TA(i < count, "Too many nodes");
+        TA(rb_value_m(elem) == sorted[i], "Wrong node");
+        i += 1;
+    }
+    TA(i == count, "Too few nodes");
+    return 0;
+}
+
+int
+test_hint(int len, int* nodes, int* hints, int* sorted, int count)
+{
+    int ret = 0;
+    /* One more node for the append of an equal node. */
+    node_t* mnodes = malloc((len + 1) * sizeof(node_t));
+    char* in_tree = malloc(len + 1);
+    do {
+        node_t* tree;
+        node_t* node;
+        node_t* hint;
+        node_t* last;
+        mh_tree_t htree;
+        int inserted = 0;
+        /* Insert with a hint to an earlier node. */
+        my_tree_init(&tree);
+        for(int i = 0; i < len; i++) {
+            node = &mnodes[i];
+            my_node_init(node);
+            rb_value_m(node) = nodes[i];
+            hint = my_nil_ptr;
+            if(hints[i] >= 0 && hints[i] < i && in_tree[hints[i]])
+                hint = &mnodes[hints[i]];
+            in_tree[i] = my_insert_hint(&tree, hint, node) == 0;
+            inserted += in_tree[i];
+            my_check_tree(tree);
+        }
+        BA(inserted == count, "Wrong insert count");
+        BA(check_sorted(tree, sorted, count) == 0, "Insert hint failed");
+        /* Append the sorted values. */
+        my_tree_init(&tree);
+        last = my_nil_ptr;
+        for(int i = 0; i < count; i++) {
+            node = &mnodes[i];
+            my_node_init(node);
+            rb_value_m(node) = sorted[i];
+            BA(my_append(&tree, last, node) == 0, "Append failed");
+            last = node;
+        }
+        BA(check_sorted(tree, sorted, count) == 0, "Append failed");
+        /* Append falls back to a hinted insert. */
+        if(count > 0) {
+            node = &mnodes[count];
+            my_node_init(node);
+            rb_value_m(node) = sorted[0];
+            BA(my_append(&tree, last, node) == 1, "Append of equal node");
+        }
+        /* The tree head appends. */
+        mh_tree_init(&htree);
+        for(int i = 0; i < len; i++) {
+            node = &mnodes[i];
+            mh_node_init(node);
+            rb_value_m(node) = nodes[i];
+            mh_insert(&htree, node);
+        }
+        BA(mh_size(&htree) == count, "Wrong head size");
+        BA(check_sorted(htree.root, sorted, count) == 0, "Head insert failed");
+        if(count > 0) {
+            BA(rb_value_m(mh_first(&htree)) == sorted[0], "Wrong first");
+            BA(rb_value_m(mh_last(&htree)) == sorted[count - 1], "Wrong last");
+        }
+    } while(0);
+    free(in_tree);
+    free(mnodes);
+    return ret;
+}
@@ -0,0 +1,2 @@
+int
+test_hint(int len, int* nodes, int* hints, int* sorted, int count);
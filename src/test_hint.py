@@ -0,0 +1,50 @@
+"""Test hinted insert and append."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+def deduplicate(seq):
+    """Deduplicate a list."""
+    seen = set()
+    seen_add = seen.add
+    return [x for x in seq if not (x in seen or seen_add(x))]
+
+
+_pair = st.tuples(
+    st.integers(
+        min_value=-1000,
+        max_value=1000
+    ),
+    st.integers(
+        min_value=-1,
+        max_value=100
+    )
+)
+
+
+def check_hint(ints, hints):
+    """Insert the ints with the hints."""
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_hint, len(ints), ints, hints, ss, len(ss))
+
+
+@given(st.lists(_pair))
+def test_hint(pairs):
+    """Test insert with random hints against the sorted values."""
+    check_hint([p[0] for p in pairs], [p[1] for p in pairs])
+
+
+@given(st.lists(st.integers(
+    min_value=0,
+    max_value=5
+)))
+def test_hint_sorted(steps):
+    """Test near-sorted inserts with the previous node as hint."""
+    ints = []
+    value = 0
+    for step in steps:
+        value += step
+        ints.append(value - 3)
+    check_hint(ints, [i - 1 for i in range(len(ints))])
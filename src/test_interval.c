@@ -0,0 +1,91 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+static
+int
+check_intervals(ivnode_t* tree, ivnode_t* key, int stab)
+{
+    int a = rb_start_m(key);
+    int b = stab ? a : rb_end_m(key);
+    int count = 0;
+    ivnode_t* prev = NULL;
+    ivnode_t* elem;
+    rb_iter_decl_cx_m(mi, iter, node);
+    /* Every overlap is found in tree order. */
+    if(stab)
+        mi_stab_first(tree, key, &elem);
+    else
+        mi_overlap_first(tree, key, &elem);
+    rb_for_m(mi, tree, iter, node) {
+        if(rb_start_m(node) <= b && rb_end_m(node) >= a) {
+            TA(elem == node, "Overlap not found");
+            count += 1;
+            prev = elem;
+            if(stab)
+                mi_stab_next(key, &elem);
+            else
+                mi_overlap_next(key, &elem);
+        }
+    }
+    TA(elem == NULL, "Found too many overlaps");
+    /* The for-loop-headers find the same. */
+    int fcount = 0;
+    if(stab) {
+        rb_for_stab_m(mi, tree, key, elem) {
+            fcount += 1;
+            node = elem;
+        }
+    } else {
+        rb_for_overlap_m(mi, tree, key, elem) {
+            fcount += 1;
+            node = elem;
+        }
+    }
+    TA(fcount == count, "Wrong number of overlaps");
+    TA(count == 0 || node == prev, "Wrong last overlap");
+    return 0;
+}
+
+int
+test_interval(
+        int len,
+        int* starts,
+        int* ends,
+        int qlen,
+        int* qstarts,
+        int* qends
+)
+{
+    int ret = 0;
+    ivnode_t* mnodes = malloc(len * sizeof(ivnode_t));
+    do {
+        ivnode_t* tree;
+        ivnode_t* node;
+        ivnode_t key;
+        mi_tree_init(&tree);
+        for(int i = 0; i < len; i++) {
+            node = &mnodes[i];
+            mi_node_init(node);
+            rb_start_m(node) = starts[i];
+            rb_end_m(node) = ends[i];
+            mi_insert(&tree, node);
+            mi_check_tree(tree);
+        }
+        for(int d = 0; d < 2; d++) {
+            for(int i = 0; i < qlen; i++) {
+                rb_start_m(&key) = qstarts[i];
+                rb_end_m(&key) = qends[i];
+                BA(check_intervals(tree, &key, 0) == 0, "Overlap failed");
+                BA(check_intervals(tree, &key, 1) == 0, "Stab failed");
+            }
+            /* Delete half of the nodes and query again. */
+            for(int i = 0; i < len; i += 2) {
+                mi_delete(&tree, &mnodes[i]);
+                mi_check_tree(tree);
+            }
+        }
+    } while(0);
+    free(mnodes);
+    return ret;
+}
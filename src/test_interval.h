@@ -0,0 +1,9 @@
+int
+test_interval(
+        int len,
+        int* starts,
+        int* ends,
+        int qlen,
+        int* qstarts,
+        int* qends
+);
@@ -0,0 +1,34 @@
+"""Test if the interval tree finds all overlaps."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+_interval = st.tuples(
+    st.integers(
+        min_value=-1000,
+        max_value=1000
+    ),
+    st.integers(
+        min_value=0,
+        max_value=100
+    )
+)
+
+
+@given(st.lists(_interval), st.lists(_interval, min_size=1))
+def test_interval(intervals, queries):
+    """Test overlap and stab queries against a scan."""
+    starts = [i[0] for i in intervals]
+    ends = [i[0] + i[1] for i in intervals]
+    qstarts = [q[0] for q in queries]
+    qends = [q[0] + q[1] for q in queries]
+    call_ffi(
+        lib.test_interval,
+        len(intervals),
+        starts,
+        ends,
+        len(queries),
+        qstarts,
+        qends
+    )
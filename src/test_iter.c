@@ -0,0 +1,84 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+static
+int
+check_iter(mh_tree_t* tree, int* sorted, int count, int start, int end)
+{
+    int i;
+    node_t skey;
+    node_t ekey;
+    node_t* prev;
+    rb_iter_decl_cx_m(mh, iter, elem);
+    /* Forward and backward from every element. */
+    i = 0;
+    rb_for_m(mh, tree, iter, elem) {
+        TA(rb_value_m(elem) == sorted[i], "Wrong forward element");
+        prev = elem;
+        mh_iter_prev(iter, &prev);
+        if(i == 0) {
+            TA(prev == NULL, "Prev should be at the beginning");
+        } else {
+            TA(prev != NULL, "Prev ended early");
+            TA(rb_value_m(prev) == sorted[i - 1], "Wrong prev element");
+        }
+        i += 1;
+    }
+    TA(i == count, "Wrong forward count");
+    i = count;
+    rb_for_reverse_m(mh, tree, iter, elem) {
+        i -= 1;
+        TA(rb_value_m(elem) == sorted[i], "Wrong reverse element");
+    }
+    TA(i == 0, "Wrong reverse count");
+    i = count;
+    rb_for_reverse_m(my, tree->root, iter, elem) {
+        i -= 1;
+        TA(rb_value_m(elem) == sorted[i], "Wrong reverse element");
+    }
+    TA(i == 0, "Wrong reverse count");
+    /* The range only visits the elements in [start, end]. */
+    rb_value_m(&skey) = start;
+    rb_value_m(&ekey) = end;
+    i = 0;
+    while(i < count && sorted[i] < start)
+        i += 1;
+    rb_for_range_m(my, tree->root, &skey, &ekey, iter, elem) {
+        TA(i < count, "Range too long");
+        TA(rb_value_m(elem) == sorted[i], "Wrong range element");
+        TA(sorted[i] <= end, "Range too long");
+        i += 1;
+    }
+    TA(i == count || sorted[i] > end || sorted[i] < start, "Range too short");
+    i = 0;
+    while(i < count && sorted[i] < start)
+        i += 1;
+    rb_for_range_m(mh, tree, &skey, &ekey, iter, elem) {
+        TA(rb_value_m(elem) == sorted[i], "Wrong range element");
+        i += 1;
+    }
+    TA(i == count || sorted[i] > end || sorted[i] < start, "Range too short");
+    return 0;
+}
+
+int
+test_iter(int len, int* nodes, int* sorted, int count, int start, int end)
+{
+    int ret = 0;
+    node_t* mnodes = malloc(len * sizeof(node_t));
+    do {
+        mh_tree_t tree;
+        node_t* node;
+        mh_tree_init(&tree);
+        for(int i = 0; i < len; i++) {
+            node = &mnodes[i];
+            mh_node_init(node);
+            rb_value_m(node) = nodes[i];
+            mh_insert(&tree, node);
+        }
+        BA(check_iter(&tree, sorted, count, start, end) == 0, "Iter failed");
+    } while(0);
+    free(mnodes);
+    return ret;
+}
@@ -0,0 +1,2 @@
+int
+test_iter(int len, int* nodes, int* sorted, int count, int start, int end);
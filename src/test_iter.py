@@ -0,0 +1,25 @@
+"""Test reverse, prev and range iteration."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+def deduplicate(seq):
+    """Deduplicate a list."""
+    seen = set()
+    seen_add = seen.add
+    return [x for x in seq if not (x in seen or seen_add(x))]
+
+
+_int = st.integers(
+    min_value=-1000,
+    max_value=1000
+)
+
+
+@given(st.lists(_int), _int, _int)
+def test_iter(ints, start, end):
+    """Test the iterators against the sorted values."""
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_iter, len(ints), ints, ss, len(ss), start, end)
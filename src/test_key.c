@@ -0,0 +1,55 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+int
+test_key(int len, int* nodes, int* sorted, int count, int key)
+{
+    int ret = 0;
+    node_t* mnodes = malloc(len * sizeof(node_t));
+    do {
+        node_t* tree;
+        node_t* node;
+        node_t* bound;
+        node_t knode;
+        int i;
+        my_tree_init(&tree);
+        for(i = 0; i < len; i++) {
+            node = &mnodes[i];
+            my_node_init(node);
+            rb_value_m(node) = nodes[i];
+            my_insert(&tree, node);
+        }
+        for(i = 0; i < count; i++) {
+            BA(my_find_key(tree, sorted[i], &node) == 0, "Key not found");
+            BA(rb_value_m(node) == sorted[i], "Wrong node");
+        }
+        BA(i == count, "Find key failed");
+        /* Key lookups agree with the node lookups. */
+        rb_value_m(&knode) = key;
+        BA(
+            my_find_key(tree, key, &node) == my_find(tree, &knode, &bound),
+            "Find key differs"
+        );
+        BA(node == bound, "Find key differs");
+        BA(
+            my_lower_bound_key(tree, key, &node) ==
+            my_lower_bound(tree, &knode, &bound),
+            "Lower bound key differs"
+        );
+        BA(node == bound, "Lower bound key differs");
+        for(i = 0; i < count; i += 2)
+            BA(my_delete_key(&tree, sorted[i]) == 0, "Delete key failed");
+        BA(i >= count, "Delete key failed");
+        my_check_tree(tree);
+        for(i = 0; i < count; i++)
+            BA(
+                my_find_key(tree, sorted[i], &node) == (i % 2 == 0),
+                "Wrong key deleted"
+            );
+        BA(i == count, "Wrong key deleted");
+        BA(my_delete_key(&tree, 1001) == 1, "Deleted missing key");
+    } while(0);
+    free(mnodes);
+    return ret;
+}
@@ -0,0 +1,25 @@
+"""Test lookups by bare keys."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+def deduplicate(seq):
+    """Deduplicate a list."""
+    seen = set()
+    seen_add = seen.add
+    return [x for x in seq if not (x in seen or seen_add(x))]
+
+
+_int = st.integers(
+    min_value=-1000,
+    max_value=1000
+)
+
+
+@given(st.lists(_int), _int)
+def test_key(ints, key):
+    """Test find_key, lower_bound_key and delete_key."""
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_key, len(ints), ints, ss, len(ss), key)
@@ -0,0 +1,91 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+static
+void
+count_node(node_t* node, void* ctx)
+{
+    int* count = ctx;
+    if(
+            rb_parent_m(node) == mm_nil_ptr &&
+            rb_left_m(node) == mm_nil_ptr &&
+            rb_right_m(node) == mm_nil_ptr
+    )
+        *count += 1;
+}
+
+int
+test_multi(int len, int* nodes, int* sorted, int key, int count)
+{
+    int ret = 0;
+    node_t* mnodes = malloc(len * sizeof(node_t));
+    do {
+        node_t* tree;
+        node_t* node;
+        node_t* first;
+        node_t* last;
+        node_t* prev;
+        node_t knode;
+        int i;
+        int deleted;
+        rb_iter_decl_cx_m(mm, iter, elem);
+        mm_tree_init(&tree);
+        for(i = 0; i < len; i++) {
+            node = &mnodes[i];
+            mm_node_init(node);
+            rb_value_m(node) = nodes[i];
+            mm_insert(&tree, node);
+        }
+        mm_check_tree(tree);
+        BA(mm_size(tree) == len, "Equal nodes not inserted");
+        /* Equal nodes are in insertion order. */
+        i = 0;
+        prev = NULL;
+        rb_for_m(mm, tree, iter, elem) {
+            if(i >= len || rb_value_m(elem) != sorted[i])
+                break;
+            if(prev != NULL && rb_value_m(prev) == rb_value_m(elem))
+                if(prev > elem)
+                    break;
+            prev = elem;
+            i += 1;
+        }
+        BA(i == len && elem == NULL, "Wrong order");
+        rb_value_m(&knode) = key;
+        BA(mm_count_equal(tree, &knode) == count, "Wrong count");
+        if(count > 0) {
+            BA(mm_equal_range(tree, &knode, &first, &last) == 0, "No range");
+            BA(rb_value_m(first) == key, "Wrong first");
+            BA(rb_value_m(last) == key, "Wrong last");
+            mm_iter_prev(NULL, &first);
+            BA(first == NULL || rb_value_m(first) < key, "First not first");
+            mm_iter_next(NULL, &last);
+            BA(last == NULL || rb_value_m(last) > key, "Last not last");
+            BA(mm_find(tree, &knode, &node) == 0, "Not found");
+            BA(rb_value_m(node) == key, "Wrong node found");
+        } else {
+            BA(mm_equal_range(tree, &knode, &first, &last) == 1, "Range");
+            BA(first == mm_nil_ptr && last == mm_nil_ptr, "Range not nil");
+        }
+        deleted = 0;
+        BA(
+            mm_delete_all_equal(&tree, &knode, count_node, &deleted) ==
+            count,
+            "Wrong delete count"
+        );
+        BA(deleted == count, "Callback not called for every node");
+        mm_check_tree(tree);
+        BA(mm_count_equal(tree, &knode) == 0, "Not all deleted");
+        BA(mm_size(tree) == len - count, "Wrong size");
+        /* Delete one of each value, the rest is still ordered. */
+        for(i = 0; i < len; i += 2) {
+            rb_value_m(&knode) = nodes[i];
+            mm_delete(&tree, &knode);
+        }
+        mm_check_tree(tree);
+        mm_clear(&tree, NULL, NULL);
+    } while(0);
+    free(mnodes);
+    return ret;
+}
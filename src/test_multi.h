@@ -0,0 +1,2 @@
+int
+test_multi(int len, int* nodes, int* sorted, int key, int count);
@@ -0,0 +1,18 @@
+"""Test the multiset binding with equal keys."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+_int = st.integers(
+    min_value=-20,
+    max_value=20
+)
+
+
+@given(st.lists(_int), _int)
+def test_multi(ints, key):
+    """Test insert, equal_range, count_equal and delete_all_equal."""
+    ss = sorted(ints)
+    call_ffi(lib.test_multi, len(ints), ints, ss, key, ints.count(key))
@@ -0,0 +1,66 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static
+int
+nil_unchanged(osnode_t* nil)
+{
+    return memcmp(nil, mo_nil_ptr, sizeof(osnode_t)) == 0;
+}
+
+int
+test_nil(int len, int* nodes, int key)
+{
+    int ret = 0;
+    osnode_t* mnodes = malloc((2 * len + 1) * sizeof(osnode_t));
+    do {
+        osnode_t* tree;
+        osnode_t* other;
+        osnode_t* rest;
+        osnode_t* node;
+        osnode_t knode;
+        osnode_t nil;
+        mo_tree_init(&tree);
+        mo_tree_init(&other);
+        mo_tree_init(&rest);
+        memcpy(&nil, mo_nil_ptr, sizeof(osnode_t));
+        for(int i = 0; i < 2 * len; i++) {
+            node = &mnodes[i];
+            mo_node_init(node);
+            rb_value_m(node) = nodes[i % len] + (i < len ? 0 : key);
+            mo_insert(i < len ? &tree : &other, node);
+        }
+        BA(nil_unchanged(&nil), "Insert wrote nil");
+        for(int i = 0; i < len; i += 3) {
+            rb_value_m(&knode) = nodes[i];
+            if(mo_find(tree, &knode, &node) == 0)
+                mo_delete_node(&tree, node);
+        }
+        BA(nil_unchanged(&nil), "Delete wrote nil");
+        rb_value_m(&knode) = key;
+        if(mo_find(tree, &knode, &node) == 0) {
+            node = &mnodes[2 * len];
+            mo_node_init(node);
+            rb_value_m(node) = key;
+            mo_replace(&tree, &knode, node);
+            BA(nil_unchanged(&nil), "Replace wrote nil");
+        }
+        mo_split(&tree, &knode, &rest);
+        BA(nil_unchanged(&nil), "Split wrote nil");
+        mo_join(&tree, &rest);
+        BA(nil_unchanged(&nil), "Join wrote nil");
+        mo_union(&tree, &other, &rest);
+        BA(nil_unchanged(&nil), "Union wrote nil");
+        mo_difference(&tree, &rest, &other);
+        BA(nil_unchanged(&nil), "Difference wrote nil");
+        while(tree != mo_nil_ptr && nil_unchanged(&nil))
+            mo_delete_node(&tree, tree);
+        BA(nil_unchanged(&nil), "Delete wrote nil");
+        mo_check_tree(other);
+        mo_check_tree(rest);
+    } while(0);
+    free(mnodes);
+    return ret;
+}
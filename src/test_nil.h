@@ -0,0 +1,2 @@
+int
+test_nil(int len, int* nodes, int key);
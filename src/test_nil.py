@@ -0,0 +1,24 @@
+"""Test that modifying a tree never writes nil."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+_int = st.integers(
+    min_value=-1000,
+    max_value=1000
+)
+
+
+@given(st.lists(_int), _int)
+def test_nil(ints, key):
+    """Test insert, delete, replace, split, join and set operations."""
+    call_ffi(lib.test_nil, len(ints), ints, key)
+
+
+def test_nil_large():
+    """Test that nil isn't written with a larger tree."""
+    ints = [(x * 7919) % 3001 for x in range(3001)]
+    for key in (0, 1500, 3001):
+        call_ffi(lib.test_nil, len(ints), ints, key)
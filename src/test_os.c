@@ -0,0 +1,106 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+static
+RB_SIZE_T
+check_size(osnode_t* node)
+{
+    if(node == mo_nil_ptr)
+        return 0;
+    RB_SIZE_T size = check_size(rb_left_m(node)) + check_size(rb_right_m(node));
+    size += 1;
+    assert(rb_size_m(node) == size && "Wrong sub-tree size");
+    return size;
+}
+
+static
+int
+check_os(osnode_t* tree, int* sorted, int count)
+{
+    osnode_t* node;
+    osnode_t key;
+    mo_check_tree(tree);
+    check_size(tree);
+    TA(rb_size_m(tree) == count, "Wrong tree size");
+    TA(mo_size(tree) == count, "Wrong size of the tree");
+    for(int i = 0; i < count; i++) {
+        TA(mo_select(tree, i, &node) == 0, "Select failed");
+        TA(rb_value_m(node) == sorted[i], "Selected wrong node");
+        TA(mo_rank_node(node) == i, "Wrong rank of node");
+        rb_value_m(&key) = sorted[i];
+        TA(mo_rank(tree, &key) == i, "Wrong rank of key");
+    }
+    TA(mo_select(tree, count, &node) != 0, "Select out of range");
+    TA(mo_select(tree, -1, &node) != 0, "Select out of range");
+    return 0;
+}
+
+int
+test_os(int len, int* nodes, int* sorted, int count)
+{
+    int ret = 0;
+    osnode_t* mnodes = malloc(len * sizeof(osnode_t));
+    osnode_t** pnodes = malloc(len * sizeof(osnode_t*));
+    do {
+        osnode_t* tree;
+        osnode_t* node;
+        mo_tree_init(&tree);
+        for(int i = 0; i < len; i++) {
+            node = &mnodes[i];
+            mo_node_init(node);
+            rb_value_m(node) = nodes[i];
+            mo_insert(&tree, node);
+            check_size(tree);
+        }
+        BA(check_os(tree, sorted, count) == 0, "Insert failed");
+        /* Skip from every element by every distance. */
+        rb_iter_decl_cx_m(mo, iter, elem);
+        int i = 0;
+        rb_for_m(mo, tree, iter, elem) {
+            for(int k = 0; k <= count - i; k++) {
+                node = elem;
+                mo_iter_skip(iter, &node, k);
+                if(i + k == count) {
+                    BA(node == NULL, "Skip past the end");
+                } else {
+                    BA(node != NULL, "Skip ended early");
+                    BA(rb_value_m(node) == sorted[i + k], "Skip failed");
+                }
+            }
+            i += 1;
+        }
+        BA(ret == 0, "Skip failed");
+        /* Replace changes no size. */
+        if(count > 0) {
+            osnode_t new;
+            rb_value_m(&new) = sorted[0];
+            mo_select(tree, 0, &node);
+            BA(mo_replace_node(&tree, node, &new) == 0, "Replace failed");
+            BA(check_os(tree, sorted, count) == 0, "Replace failed");
+            BA(mo_replace_node(&tree, &new, node) == 0, "Replace failed");
+        }
+        /* Delete every other node by rank. */
+        int lcount = 0;
+        for(i = 0; i < count; i++) {
+            if(i % 2) {
+                mo_select(tree, lcount, &node);
+                mo_delete_node(&tree, node);
+                check_size(tree);
+            } else
+                sorted[lcount++] = sorted[i];
+        }
+        BA(check_os(tree, sorted, lcount) == 0, "Delete failed");
+        /* Rebuild from the sorted nodes. */
+        i = 0;
+        rb_for_m(mo, tree, iter, elem) {
+            pnodes[i++] = elem;
+        }
+        mo_tree_init(&tree);
+        mo_build_sorted(&tree, pnodes, lcount);
+        BA(check_os(tree, sorted, lcount) == 0, "Build failed");
+    } while(0);
+    free(pnodes);
+    free(mnodes);
+    return ret;
+}
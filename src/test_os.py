@@ -0,0 +1,24 @@
+"""Test if the order statistics are consistent."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+def deduplicate(seq):
+    """Deduplicate a list."""
+    seen = set()
+    seen_add = seen.add
+    return [x for x in seq if not (x in seen or seen_add(x))]
+
+
+@given(st.lists(
+    st.integers(
+        min_value=-(2 ** 30),
+        max_value=2 ** 30
+    )
+))
+def test_os(ints):
+    """Test rank, select and skip after generated inserts and deletes."""
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_os, len(ints), ints, ss, len(ss))
@@ -0,0 +1,74 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static
+int
+check_values(ixnode_t* tree, int* sorted, int count)
+{
+    int i = 0;
+    rb_iter_decl_cx_m(mq, iter, elem);
+    mq_check_tree(tree);
+    rb_for_m(mq, tree, iter, elem) {
+        TA(i < count, "Too many nodes");
+        TA(elem->value == sorted[i], "Wrong node");
+        i += 1;
+    }
+    TA(i == count, "Too few nodes");
+    return 0;
+}
+
+int
+test_pool(int len, int* nodes, int* sorted, int count)
+{
+    int ret = 0;
+    int half = count / 2;
+    ixnode_t* pool = malloc((len + 1) * sizeof(ixnode_t));
+    ixnode_t* moved = malloc((len + 1) * sizeof(ixnode_t));
+    do {
+        ixnode_t* tree;
+        ixnode_t* node;
+        ixnode_t knode;
+        uint32_t root;
+        BA(sizeof(ixnode_t) < sizeof(node_t), "Pool node is not smaller");
+        mq_pool_init(pool);
+        BA(mq_nil_ptr == pool, "Nil is not the base of the pool");
+        mq_tree_init(&tree);
+        for(int i = 0; i < len; i++) {
+            node = &pool[i + 1];
+            mq_node_init(node);
+            node->value = nodes[i];
+            mq_insert(&tree, node);
+        }
+        BA(check_values(tree, sorted, count) == 0, "Insert failed");
+        for(int i = 0; i < half; i++) {
+            knode.value = sorted[i];
+            BA(mq_find(tree, &knode, &node) == 0, "Node not found");
+            mq_delete_node(&tree, node);
+        }
+        BA(
+            check_values(tree, sorted + half, count - half) == 0,
+            "Delete failed"
+        );
+        /* Relocate the pool. */
+        root = rb_pool_idx_m(mq, tree);
+        memcpy(moved, pool, (len + 1) * sizeof(ixnode_t));
+        memset(pool, 0xff, (len + 1) * sizeof(ixnode_t));
+        mq_pool_move(moved);
+        tree = rb_pool_ptr_m(mq, root);
+        BA(
+            check_values(tree, sorted + half, count - half) == 0,
+            "Move failed"
+        );
+        for(int i = half; i < count; i++) {
+            knode.value = sorted[i];
+            BA(mq_find(tree, &knode, &node) == 0, "Node not found");
+            mq_delete_node(&tree, node);
+        }
+        BA(tree == mq_nil_ptr, "Tree not empty");
+    } while(0);
+    free(moved);
+    free(pool);
+    return ret;
+}
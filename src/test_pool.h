@@ -0,0 +1,2 @@
+int
+test_pool(int len, int* nodes, int* sorted, int count);
@@ -0,0 +1,158 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
+int
+test_seq(int len, int* nodes, int* sorted, int count, int key)
+{
+    int ret = 0;
+    node_t* mnodes;
+    my_seq_t seq;
+    TA(my_seq_init(&seq) == 0, "Init failed");
+    mnodes = malloc(len * sizeof(node_t));
+    do {
+        node_t* node;
+        node_t* bound;
+        node_t* existing;
+        node_t knode;
+        int i;
+        for(i = 0; i < len; i++) {
+            node = &mnodes[i];
+            my_node_init(node);
+            rb_value_m(node) = nodes[i];
+            my_seq_insert_or_get(&seq, node, &existing);
+        }
+        my_check_tree(seq.root);
+        BA(my_size(seq.root) == count, "Wrong size");
+        for(i = 0; i < count; i++) {
+            rb_value_m(&knode) = sorted[i];
+            BA(my_seq_find(&seq, &knode, &node) == 0, "Not found");
+            BA(rb_value_m(node) == sorted[i], "Wrong node");
+        }
+        BA(i == count, "Find failed");
+        /* The lock-free searches agree with the plain ones. */
+        rb_value_m(&knode) = key;
+        node = NULL;
+        bound = NULL;
+        BA(
+            my_seq_find(&seq, &knode, &node) ==
+            my_find(seq.root, &knode, &bound),
+            "Find differs"
+        );
+        BA(node == bound, "Find differs");
+        BA(
+            my_seq_lower_bound(&seq, &knode, &node) ==
+            my_lower_bound(seq.root, &knode, &bound),
+            "Lower bound differs"
+        );
+        BA(node == bound, "Lower bound differs");
+        BA(
+            my_seq_upper_bound(&seq, &knode, &node) ==
+            my_upper_bound(seq.root, &knode, &bound),
+            "Upper bound differs"
+        );
+        BA(node == bound, "Upper bound differs");
+        BA(
+            my_seq_floor(&seq, &knode, &node) ==
+            my_floor(seq.root, &knode, &bound),
+            "Floor differs"
+        );
+        BA(node == bound, "Floor differs");
+        BA(
+            my_seq_ceil(&seq, &knode, &node) ==
+            my_ceil(seq.root, &knode, &bound),
+            "Ceil differs"
+        );
+        BA(node == bound, "Ceil differs");
+        for(i = 0; i < count; i += 2) {
+            rb_value_m(&knode) = sorted[i];
+            BA(my_seq_delete(&seq, &knode) == 0, "Delete failed");
+        }
+        BA(i >= count, "Delete failed");
+        my_check_tree(seq.root);
+        for(i = 1; i < count; i += 2) {
+            rb_value_m(&knode) = sorted[i];
+            BA(my_seq_find(&seq, &knode, &node) == 0, "Not found");
+            my_seq_delete_node(&seq, node);
+        }
+        BA(i >= count, "Delete node failed");
+        BA(seq.root == my_nil_ptr, "Tree not empty");
+        BA(seq.count % 2 == 0, "Writer still active");
+    } while(0);
+    my_seq_clear(&seq, NULL, NULL);
+    my_seq_destroy(&seq);
+    free(mnodes);
+    return ret;
+}
+
+#define SEQ_READERS 4
+#define SEQ_SIZE 4000
+#define SEQ_ROUNDS 20
+
+static my_seq_t seq_tree;
+static node_t seq_nodes[SEQ_SIZE];
+static int seq_errors;
+
+/* Odd keys come and go, even keys stay and must always be found. */
+static
+void*
+seq_writer(void* arg)
+{
+    (void)(arg);
+    for(int r = 0; r < SEQ_ROUNDS; r++) {
+        for(int i = 1; i < SEQ_SIZE; i += 2)
+            my_seq_delete_node(&seq_tree, &seq_nodes[i]);
+        for(int i = 1; i < SEQ_SIZE; i += 2) {
+            my_node_init(&seq_nodes[i]);
+            my_seq_insert(&seq_tree, &seq_nodes[i]);
+        }
+    }
+    return NULL;
+}
+
+static
+void*
+seq_reader(void* arg)
+{
+    node_t key;
+    node_t* node;
+    (void)(arg);
+    for(int r = 0; r < SEQ_ROUNDS; r++) {
+        for(int i = 0; i < SEQ_SIZE; i += 2) {
+            rb_value_m(&key) = i;
+            if(
+                    my_seq_find(&seq_tree, &key, &node) != 0 ||
+                    node != &seq_nodes[i]
+            )
+                __sync_fetch_and_add(&seq_errors, 1);
+        }
+    }
+    return NULL;
+}
+
+int
+test_seq_threads(void)
+{
+    pthread_t writer;
+    pthread_t readers[SEQ_READERS];
+    TA(my_seq_init(&seq_tree) == 0, "Init failed");
+    for(int i = 0; i < SEQ_SIZE; i++) {
+        my_node_init(&seq_nodes[i]);
+        rb_value_m(&seq_nodes[i]) = i;
+        my_seq_insert(&seq_tree, &seq_nodes[i]);
+    }
+    pthread_create(&writer, NULL, seq_writer, NULL);
+    for(int t = 0; t < SEQ_READERS; t++)
+        pthread_create(&readers[t], NULL, seq_reader, NULL);
+    pthread_join(writer, NULL);
+    for(int t = 0; t < SEQ_READERS; t++)
+        pthread_join(readers[t], NULL);
+    TA(seq_errors == 0, "Reader missed a key");
+    my_check_tree(seq_tree.root);
+    TA(my_size(seq_tree.root) == SEQ_SIZE, "Wrong size");
+    my_seq_clear(&seq_tree, NULL, NULL);
+    my_seq_destroy(&seq_tree);
+    return 0;
+}
@@ -0,0 +1,4 @@
+int
+test_seq(int len, int* nodes, int* sorted, int count, int key);
+int
+test_seq_threads(void);
@@ -0,0 +1,30 @@
+"""Test the sequence-locked binding."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+def deduplicate(seq):
+    """Deduplicate a list."""
+    seen = set()
+    seen_add = seen.add
+    return [x for x in seq if not (x in seen or seen_add(x))]
+
+
+_int = st.integers(
+    min_value=-1000,
+    max_value=1000
+)
+
+
+@given(st.lists(_int), _int)
+def test_seq(ints, key):
+    """Test the seq functions against the plain ones."""
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_seq, len(ints), ints, ss, len(ss), key)
+
+
+def test_seq_threads():
+    """Test lock-free readers while a writer rotates the tree."""
+    call_ffi(lib.test_seq_threads)
@@ -0,0 +1,104 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+static
+RB_SIZE_T
+check_size(osnode_t* node)
+{
+    if(node == mo_nil_ptr)
+        return 0;
+    RB_SIZE_T size = check_size(rb_left_m(node)) + check_size(rb_right_m(node));
+    size += 1;
+    assert(rb_size_m(node) == size && "Wrong sub-tree size");
+    return size;
+}
+
+static
+int
+check_values(osnode_t* tree, int* sorted, int count)
+{
+    int i = 0;
+    rb_iter_decl_cx_m(mo, iter, elem);
+    mo_check_tree(tree);
+    TA(check_size(tree) == count, "Wrong tree size");
+    rb_for_m(mo, tree, iter, elem) {
+        TA(i < count, "Too many nodes");
+        TA(rb_value_m(elem) == sorted[i], "Wrong node");
+        i += 1;
+    }
+    TA(i == count, "Too few nodes");
+    return 0;
+}
+
+static
+int
+check_origin(osnode_t* tree, osnode_t* mnodes, int len)
+{
+    rb_iter_decl_cx_m(mo, iter, elem);
+    rb_for_m(mo, tree, iter, elem) {
+        TA(elem >= mnodes && elem < mnodes + len, "Node of the wrong tree");
+    }
+    return 0;
+}
+
+static
+void
+insert_all(osnode_t** tree, osnode_t* mnodes, int len, int* nodes)
+{
+    osnode_t* node;
+    mo_tree_init(tree);
+    for(int i = 0; i < len; i++) {
+        node = &mnodes[i];
+        mo_node_init(node);
+        rb_value_m(node) = nodes[i];
+        mo_insert(tree, node);
+    }
+}
+
+int
+test_set(
+        int len1,
+        int* nodes1,
+        int len2,
+        int* nodes2,
+        int* expect,
+        int count,
+        int* rest,
+        int rcount,
+        int op
+)
+{
+    int ret = 0;
+    osnode_t* mnodes1 = malloc(len1 * sizeof(osnode_t));
+    osnode_t* mnodes2 = malloc(len2 * sizeof(osnode_t));
+    do {
+        osnode_t* tree;
+        osnode_t* other;
+        osnode_t* rtree;
+        insert_all(&tree, mnodes1, len1, nodes1);
+        insert_all(&other, mnodes2, len2, nodes2);
+        mo_tree_init(&rtree);
+        RB_SIZE_T osize = rb_size_m(other);
+        if(op == 0) {
+            mo_union(&tree, &other, &rtree);
+            BA(other == mo_nil_ptr, "Other not empty");
+            BA(check_origin(rtree, mnodes2, len2) == 0, "Wrong rest");
+        } else {
+            if(op == 1)
+                mo_intersect(&tree, &other, &rtree);
+            else
+                mo_difference(&tree, &other, &rtree);
+            BA(check_size(other) == osize, "Other changed");
+            mo_check_tree(other);
+            BA(check_origin(other, mnodes2, len2) == 0, "Wrong other");
+            BA(check_origin(tree, mnodes1, len1) == 0, "Wrong tree");
+            BA(check_origin(rtree, mnodes1, len1) == 0, "Wrong rest");
+        }
+        BA(check_values(tree, expect, count) == 0, "Wrong result");
+        BA(check_values(rtree, rest, rcount) == 0, "Wrong rest");
+    } while(0);
+    free(mnodes2);
+    free(mnodes1);
+    return ret;
+}
@@ -0,0 +1,12 @@
+int
+test_set(
+        int len1,
+        int* nodes1,
+        int len2,
+        int* nodes2,
+        int* expect,
+        int count,
+        int* rest,
+        int rcount,
+        int op
+);
@@ -0,0 +1,60 @@
+"""Test union, intersection and difference."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+def deduplicate(seq):
+    """Deduplicate a list."""
+    seen = set()
+    seen_add = seen.add
+    return [x for x in seq if not (x in seen or seen_add(x))]
+
+
+_ints = st.lists(st.integers(
+    min_value=-200,
+    max_value=200
+))
+
+
+def check_set(ints1, ints2):
+    """Compare the set operations to python sets."""
+    ints1 = deduplicate(ints1)
+    ints2 = deduplicate(ints2)
+    s1 = set(ints1)
+    s2 = set(ints2)
+    for op, expect, rest in (
+            (0, s1 | s2, s1 & s2),
+            (1, s1 & s2, s1 - s2),
+            (2, s1 - s2, s1 & s2),
+    ):
+        expect = sorted(expect)
+        rest = sorted(rest)
+        call_ffi(
+            lib.test_set,
+            len(ints1),
+            ints1,
+            len(ints2),
+            ints2,
+            expect,
+            len(expect),
+            rest,
+            len(rest),
+            op
+        )
+
+
+@given(_ints, _ints)
+def test_set(ints1, ints2):
+    """Test the set operations against python sets."""
+    check_set(ints1, ints2)
+
+
+def test_set_large():
+    """Test the set operations on trees of different sizes."""
+    ints1 = [(x * 7919) % 4001 for x in range(0, 4001, 2)]
+    ints2 = [(x * 104729) % 4001 for x in range(0, 4001, 3)]
+    check_set(ints1, ints2)
+    check_set(ints1, ints2[:50])
+    check_set(ints1[:50], ints2)
@@ -0,0 +1,83 @@
+#include "testing.h"
+
+#include <stdint.h>
+
+static
+int
+check_values(node_t* tree, int* sorted, int count)
+{
+    int i = 0;
+    rb_iter_decl_cx_m(my, iter, elem);
+    my_check_tree(tree);
+    rb_for_m(my, tree, iter, elem) {
+        TA(i < count, "Too many nodes");
+        TA(rb_value_m(elem) == sorted[i], "Wrong node");
+        i += 1;
+    }
+    TA(i == count, "Too few nodes");
+    return 0;
+}
+
+static
+int
+fill(my_slab_t* slab, node_t** tree, int len, int* nodes)
+{
+    node_t* node;
+    my_tree_init(tree);
+    for(int i = 0; i < len; i++) {
+        node = my_alloc(slab);
+        TA(node != NULL, "Out of memory");
+        TA(((uintptr_t) node) % sizeof(void*) == 0, "Node not aligned");
+        my_node_init(node);
+        rb_value_m(node) = nodes[i];
+        if(my_insert(tree, node) != 0)
+            my_free(slab, node);
+    }
+    return 0;
+}
+
+int
+test_slab(int len, int* nodes, int* sorted, int count, int huge)
+{
+    int ret = 0;
+    my_slab_t slab;
+    my_slab_init(&slab, huge ? RB_SLAB_HUGEPAGE : 0);
+    do {
+        node_t* tree;
+        node_t* node;
+        node_t* first;
+        node_t key;
+        BA(fill(&slab, &tree, len, nodes) == 0, "Fill failed");
+        BA(check_values(tree, sorted, count) == 0, "Insert failed");
+        if(slab.slabs != NULL) {
+            BA(
+                ((uintptr_t) slab.slabs) % RB_SLAB_ALIGN == 0,
+                "Slab not aligned"
+            );
+        }
+        /* Freed nodes are reused. */
+        if(count > 0) {
+            rb_value_m(&key) = sorted[0];
+            BA(my_find(tree, &key, &node) == 0, "Node not found");
+            my_delete_node(&tree, node);
+            my_free(&slab, node);
+            BA(my_alloc(&slab) == node, "Freed node not reused");
+            my_node_init(node);
+            rb_value_m(node) = sorted[0];
+            my_insert(&tree, node);
+        }
+        BA(check_values(tree, sorted, count) == 0, "Reuse failed");
+        /* Reset drops the tree and starts again with the first slab. */
+        first = slab.slabs == NULL ? NULL :
+            (node_t*) (((char*) slab.slabs) + RB_SLAB_HEAD);
+        my_reset(&slab);
+        if(first != NULL)
+            BA(my_alloc(&slab) == first, "Slab not reused");
+        my_reset(&slab);
+        BA(fill(&slab, &tree, len, nodes) == 0, "Fill failed");
+        BA(check_values(tree, sorted, count) == 0, "Reset failed");
+    } while(0);
+    my_slab_destroy(&slab);
+    TA(slab.slabs == NULL, "Slabs not destroyed");
+    return ret;
+}
@@ -0,0 +1,2 @@
+int
+test_slab(int len, int* nodes, int* sorted, int count, int huge);
@@ -0,0 +1,31 @@
+"""Test if trees allocated from a slab allocator stay consistent."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+def deduplicate(seq):
+    """Deduplicate a list."""
+    seen = set()
+    seen_add = seen.add
+    return [x for x in seq if not (x in seen or seen_add(x))]
+
+
+_int = st.integers(
+    min_value=-1000,
+    max_value=1000
+)
+
+
+@given(st.lists(_int), st.booleans())
+def test_slab(ints, huge):
+    """Test alloc, free, reset and destroy of the slab allocator."""
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_slab, len(ints), ints, ss, len(ss), huge)
+
+
+def test_slab_large():
+    """Test a tree spanning multiple slabs."""
+    ints = list(range(200000))
+    call_ffi(lib.test_slab, len(ints), ints, ints, len(ints), 0)
@@ -0,0 +1,93 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+static
+RB_SIZE_T
+check_size(osnode_t* node)
+{
+    if(node == mo_nil_ptr)
+        return 0;
+    RB_SIZE_T size = check_size(rb_left_m(node)) + check_size(rb_right_m(node));
+    size += 1;
+    assert(rb_size_m(node) == size && "Wrong sub-tree size");
+    return size;
+}
+
+static
+int
+check_values(osnode_t* tree, int* sorted, int count)
+{
+    int i = 0;
+    rb_iter_decl_cx_m(mo, iter, elem);
+    mo_check_tree(tree);
+    TA(check_size(tree) == count, "Wrong tree size");
+    rb_for_m(mo, tree, iter, elem) {
+        TA(i < count, "Too many nodes");
+        TA(rb_value_m(elem) == sorted[i], "Wrong node");
+        i += 1;
+    }
+    TA(i == count, "Too few nodes");
+    return 0;
+}
+
+int
+test_split(int len, int* nodes, int* sorted, int count, int key)
+{
+    int ret = 0;
+    osnode_t* mnodes = malloc(len * sizeof(osnode_t));
+    do {
+        osnode_t* tree;
+        osnode_t* right;
+        osnode_t* node;
+        osnode_t knode;
+        int at = 0;
+        mo_tree_init(&tree);
+        mo_tree_init(&right);
+        for(int i = 0; i < len; i++) {
+            node = &mnodes[i];
+            mo_node_init(node);
+            rb_value_m(node) = nodes[i];
+            mo_insert(&tree, node);
+        }
+        while(at < count && sorted[at] < key)
+            at += 1;
+        rb_value_m(&knode) = key;
+        mo_split(&tree, &knode, &right);
+        BA(check_values(tree, sorted, at) == 0, "Split left failed");
+        BA(
+            check_values(right, sorted + at, count - at) == 0,
+            "Split right failed"
+        );
+        mo_join(&tree, &right);
+        BA(right == mo_nil_ptr, "Right tree not empty");
+        BA(check_values(tree, sorted, count) == 0, "Join failed");
+        /* Split at every node and join again. */
+        for(int i = 0; i < count; i++) {
+            rb_value_m(&knode) = sorted[i];
+            mo_split(&tree, &knode, &right);
+            BA(check_values(tree, sorted, i) == 0, "Split left failed");
+            BA(
+                check_values(right, sorted + i, count - i) == 0,
+                "Split right failed"
+            );
+            mo_join(&tree, &right);
+            BA(check_values(tree, sorted, count) == 0, "Join failed");
+        }
+        /* Join the single node trees of a full split. */
+        osnode_t* parts;
+        mo_tree_init(&parts);
+        for(int i = count - 1; i >= 0; i--) {
+            rb_value_m(&knode) = sorted[i];
+            mo_split(&tree, &knode, &right);
+            mo_join(&right, &parts);
+            parts = right;
+            mo_tree_init(&right);
+        }
+        BA(tree == mo_nil_ptr, "Tree not empty");
+        tree = parts;
+        BA(check_values(tree, sorted, count) == 0, "Join failed");
+    } while(0);
+    free(mnodes);
+    return ret;
+}
@@ -0,0 +1,33 @@
+"""Test if split and join keep the tree consistent."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+def deduplicate(seq):
+    """Deduplicate a list."""
+    seen = set()
+    seen_add = seen.add
+    return [x for x in seq if not (x in seen or seen_add(x))]
+
+
+_int = st.integers(
+    min_value=-1000,
+    max_value=1000
+)
+
+
+@given(st.lists(_int), _int)
+def test_split(ints, key):
+    """Test split at a key and at every node, and join the parts."""
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_split, len(ints), ints, ss, len(ss), key)
+
+
+def test_split_large():
+    """Test split and join of larger trees."""
+    ints = [(x * 7919) % 3001 for x in range(3001)]
+    ss = sorted(ints)
+    for key in (-1, 0, 1, 1500, 2999, 3000, 3001):
+        call_ffi(lib.test_split, len(ints), ints, ss, len(ss), key)
@@ -0,0 +1,81 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+static
+int
+check_values(pknode_t* tree, int* sorted, int count)
+{
+    int i = 0;
+    rb_iter_decl_cx_m(mp, iter, elem);
+    mp_check_tree(tree);
+    rb_for_m(mp, tree, iter, elem) {
+        TA(i < count, "Too many nodes");
+        TA(elem->value == sorted[i], "Wrong node");
+        TA(mp_color_m(elem) <= RB_RED, "Color bit leaked");
+        i += 1;
+    }
+    TA(i == count, "Too few nodes");
+    return 0;
+}
+
+int
+test_tagged(int len, int* nodes, int* sorted, int count, int key)
+{
+    int ret = 0;
+    pknode_t* mnodes = malloc(len * sizeof(pknode_t));
+    do {
+        pknode_t* tree;
+        pknode_t* right;
+        pknode_t* node;
+        pknode_t knode;
+        int at = 0;
+        mp_tree_init(&tree);
+        mp_tree_init(&right);
+        for(int i = 0; i < len; i++) {
+            node = &mnodes[i];
+            mp_node_init(node);
+            node->value = nodes[i];
+            mp_insert(&tree, node);
+        }
+        BA(check_values(tree, sorted, count) == 0, "Insert failed");
+        /* The tag helpers change the color bit, not the parent. */
+        node = mp_left_m(tree);
+        if(tree != mp_nil_ptr && node != mp_nil_ptr) {
+            char color = mp_color_m(node);
+            rb_tag_make_red_m(node->parent);
+            BA(mp_color_m(node) == RB_RED, "Make red failed");
+            BA(mp_parent_m(node) == tree, "Make red changed the parent");
+            rb_tag_make_black_m(node->parent);
+            BA(mp_color_m(node) == RB_BLACK, "Make black failed");
+            BA(mp_parent_m(node) == tree, "Make black changed the parent");
+            mp_color_m_set(node, color);
+        }
+        while(at < count && sorted[at] < key)
+            at += 1;
+        knode.value = key;
+        mp_split(&tree, &knode, &right);
+        BA(check_values(tree, sorted, at) == 0, "Split left failed");
+        BA(
+            check_values(right, sorted + at, count - at) == 0,
+            "Split right failed"
+        );
+        mp_join(&tree, &right);
+        BA(check_values(tree, sorted, count) == 0, "Join failed");
+        for(int i = 0; i < count; i++) {
+            knode.value = sorted[i];
+            BA(mp_find(tree, &knode, &node) == 0, "Node not found");
+            BA(node->value == sorted[i], "Found wrong node");
+            mp_delete_node(&tree, node);
+            if(i % 16 == 0) {
+                BA(
+                    check_values(tree, sorted + i + 1, count - i - 1) == 0,
+                    "Delete failed"
+                );
+            }
+        }
+        BA(tree == mp_nil_ptr, "Tree not empty");
+    } while(0);
+    free(mnodes);
+    return ret;
+}
@@ -0,0 +1,2 @@
+int
+test_tagged(int len, int* nodes, int* sorted, int count, int key);
@@ -0,0 +1,161 @@
+#include "testing.h"
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+
+int
+test_ts(int len, int* nodes, int* sorted, int count, int key)
+{
+    int ret = 0;
+    node_t* mnodes;
+    my_ts_t ts;
+    TA(my_ts_init(&ts) == 0, "Init failed");
+    mnodes = malloc(len * sizeof(node_t));
+    do {
+        node_t* node;
+        node_t* bound;
+        node_t* existing;
+        node_t knode;
+        int i;
+        for(i = 0; i < len; i++) {
+            node = &mnodes[i];
+            my_node_init(node);
+            rb_value_m(node) = nodes[i];
+            my_ts_insert_or_get(&ts, node, &existing);
+        }
+        my_check_tree(ts.root);
+        BA(my_ts_size(&ts) == count, "Wrong size");
+        i = 0;
+        rb_iter_decl_cx_m(my, iter, elem);
+        rb_ts_for_m(my, &ts, iter, elem) {
+            BA(i < count && rb_value_m(elem) == sorted[i], "Wrong order");
+            i += 1;
+        }
+        BA(i == count, "Iteration failed");
+        rb_ts_for_reverse_m(my, &ts, iter, elem) {
+            i -= 1;
+            BA(rb_value_m(elem) == sorted[i], "Wrong reverse order");
+        }
+        BA(i == 0, "Reverse iteration failed");
+        /* Break releases the lock, so the write lock can be taken. */
+        rb_ts_for_m(my, &ts, iter, elem) {
+            break;
+        }
+        BA(my_ts_wrlock(&ts) == 0, "Lock not released");
+        my_ts_unlock(&ts);
+        rb_value_m(&knode) = key;
+        BA(
+            my_ts_find(&ts, &knode, &node) == my_find(ts.root, &knode, &node),
+            "Find differs"
+        );
+        BA(
+            my_ts_lower_bound(&ts, &knode, &node) ==
+            my_lower_bound(ts.root, &knode, &node),
+            "Lower bound differs"
+        );
+        BA(
+            my_ts_upper_bound(&ts, &knode, &node) ==
+            my_upper_bound(ts.root, &knode, &bound),
+            "Upper bound differs"
+        );
+        BA(node == bound, "Upper bound differs");
+        BA(
+            my_ts_floor(&ts, &knode, &node) ==
+            my_floor(ts.root, &knode, &bound),
+            "Floor differs"
+        );
+        BA(node == bound, "Floor differs");
+        BA(
+            my_ts_ceil(&ts, &knode, &node) ==
+            my_ceil(ts.root, &knode, &bound),
+            "Ceil differs"
+        );
+        BA(node == bound, "Ceil differs");
+        for(i = 0; i < count; i += 2) {
+            rb_value_m(&knode) = sorted[i];
+            BA(my_ts_delete(&ts, &knode) == 0, "Delete failed");
+        }
+        BA(i >= count, "Delete failed");
+        my_check_tree(ts.root);
+        for(i = 1; i < count; i += 2) {
+            rb_value_m(&knode) = sorted[i];
+            BA(my_ts_find(&ts, &knode, &node) == 0, "Not found");
+            my_ts_delete_node(&ts, node);
+        }
+        BA(i >= count, "Delete node failed");
+        BA(my_ts_size(&ts) == 0, "Tree not empty");
+    } while(0);
+    my_ts_clear(&ts, NULL, NULL);
+    my_ts_destroy(&ts);
+    free(mnodes);
+    return ret;
+}
+
+#define TS_THREADS 4
+#define TS_SIZE 2000
+
+static my_ts_t ts_tree;
+static node_t ts_nodes[TS_THREADS][TS_SIZE];
+static int ts_errors;
+
+static
+void*
+ts_writer(void* arg)
+{
+    int t = (int) (intptr_t) arg;
+    for(int i = 0; i < TS_SIZE; i++) {
+        my_node_init(&ts_nodes[t][i]);
+        rb_value_m(&ts_nodes[t][i]) = i * TS_THREADS + t;
+        my_ts_insert(&ts_tree, &ts_nodes[t][i]);
+    }
+    for(int i = 0; i < TS_SIZE; i += 2)
+        my_ts_delete_node(&ts_tree, &ts_nodes[t][i]);
+    return NULL;
+}
+
+static
+void*
+ts_reader(void* arg)
+{
+    (void)(arg);
+    for(int r = 0; r < 20; r++) {
+        int last = -1;
+        rb_iter_decl_cx_m(my, iter, elem);
+        rb_ts_for_m(my, &ts_tree, iter, elem) {
+            if(rb_value_m(elem) <= last)
+                __sync_fetch_and_add(&ts_errors, 1);
+            last = rb_value_m(elem);
+        }
+    }
+    return NULL;
+}
+
+int
+test_ts_threads(void)
+{
+    pthread_t writers[TS_THREADS];
+    pthread_t readers[TS_THREADS];
+    node_t* node;
+    TA(my_ts_init(&ts_tree) == 0, "Init failed");
+    for(int t = 0; t < TS_THREADS; t++) {
+        pthread_create(&writers[t], NULL, ts_writer, (void*) (intptr_t) t);
+        pthread_create(&readers[t], NULL, ts_reader, NULL);
+    }
+    for(int t = 0; t < TS_THREADS; t++) {
+        pthread_join(writers[t], NULL);
+        pthread_join(readers[t], NULL);
+    }
+    TA(ts_errors == 0, "Reader saw an inconsistent tree");
+    TA(my_ts_size(&ts_tree) == TS_THREADS * TS_SIZE / 2, "Wrong size");
+    my_check_tree(ts_tree.root);
+    for(int t = 0; t < TS_THREADS; t++)
+        for(int i = 0; i < TS_SIZE; i++)
+            TA(
+                my_ts_find(&ts_tree, &ts_nodes[t][i], &node) == (i % 2 == 0),
+                "Wrong node deleted"
+            );
+    my_ts_clear(&ts_tree, NULL, NULL);
+    my_ts_destroy(&ts_tree);
+    return 0;
+}
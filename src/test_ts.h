@@ -0,0 +1,4 @@
+int
+test_ts(int len, int* nodes, int* sorted, int count, int key);
+int
+test_ts_threads(void);
@@ -0,0 +1,30 @@
+"""Test the thread-safe binding."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+def deduplicate(seq):
+    """Deduplicate a list."""
+    seen = set()
+    seen_add = seen.add
+    return [x for x in seq if not (x in seen or seen_add(x))]
+
+
+_int = st.integers(
+    min_value=-1000,
+    max_value=1000
+)
+
+
+@given(st.lists(_int), _int)
+def test_ts(ints, key):
+    """Test the ts functions and the locked iteration."""
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_ts, len(ints), ints, ss, len(ss), key)
+
+
+def test_ts_threads():
+    """Test writers and readers sharing one tree."""
+    call_ffi(lib.test_ts_threads)
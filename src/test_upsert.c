@@ -0,0 +1,67 @@
+#include "testing.h"
+
+#include <stdlib.h>
+
+static
+int
+check_values(node_t* tree, int* sorted, int count)
+{
+    int i = 0;
+    rb_iter_decl_cx_m(my, iter, elem);
+    my_check_tree(tree);
+    rb_for_m(my, tree, iter, elem) {
+        TA(i < count, "Too many nodes");
+        TA(rb_value_m(elem) == sorted[i], "Wrong node");
+        i += 1;
+    }
+    TA(i == count, "Too few nodes");
+    return 0;
+}
+
+int
+test_upsert(int len, int* nodes, int* sorted, int count)
+{
+    int ret = 0;
+    node_t* mnodes = malloc(2 * len * sizeof(node_t));
+    do {
+        node_t* tree;
+        node_t* node;
+        node_t* existing;
+        node_t key;
+        my_slot_t slot;
+        int i;
+        my_tree_init(&tree);
+        for(i = 0; i < len; i++) {
+            node = &mnodes[i];
+            my_node_init(node);
+            rb_value_m(node) = nodes[i];
+            if(my_insert_or_get(&tree, node, &existing) == 0) {
+                BA(existing == node, "Inserted node not returned");
+            } else {
+                BA(existing != node, "Existing node not returned");
+                BA(rb_value_m(existing) == nodes[i], "Wrong existing node");
+                BA(rb_parent_m(node) == my_nil_ptr, "Node was linked");
+            }
+        }
+        BA(i == len, "Insert or get failed");
+        BA(check_values(tree, sorted, count) == 0, "Insert or get failed");
+        my_tree_init(&tree);
+        for(i = 0; i < len; i++) {
+            rb_value_m(&key) = nodes[i];
+            if(my_find_slot(tree, &key, &existing, &slot) == 0) {
+                BA(rb_value_m(existing) == nodes[i], "Wrong node found");
+                continue;
+            }
+            BA(existing == my_nil_ptr, "Miss didn't return nil");
+            /* The node is only built after a miss. */
+            node = &mnodes[len + i];
+            my_node_init(node);
+            rb_value_m(node) = nodes[i];
+            my_insert_at_slot(&tree, &slot, node);
+        }
+        BA(i == len, "Find slot failed");
+        BA(check_values(tree, sorted, count) == 0, "Insert at slot failed");
+    } while(0);
+    free(mnodes);
+    return ret;
+}
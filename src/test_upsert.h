@@ -0,0 +1,2 @@
+int
+test_upsert(int len, int* nodes, int* sorted, int count);
@@ -0,0 +1,25 @@
+"""Test insert_or_get and the find_slot/insert_at_slot pair."""
+from build._rbtree_tests import lib
+from hypothesis import given
+import hypothesis.strategies as st
+from test_all import call_ffi
+
+
+def deduplicate(seq):
+    """Deduplicate a list."""
+    seen = set()
+    seen_add = seen.add
+    return [x for x in seq if not (x in seen or seen_add(x))]
+
+
+_int = st.integers(
+    min_value=-100,
+    max_value=100
+)
+
+
+@given(st.lists(_int))
+def test_upsert(ints):
+    """Test that upserts return the existing node and keep the tree valid."""
+    ss = sorted(deduplicate(ints))
+    call_ffi(lib.test_upsert, len(ints), ints, ss, len(ss))
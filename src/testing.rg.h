@@ -1,8 +1,15 @@
 #ifndef rb_testing_h
 #define rb_testing_h
 
+/* Run the set operations in threads, even for small trees. */
+#define RB_PTHREAD
+#define RB_PAR_BH 2
+/* Test the integer search of frozen snapshots. */
+#define RB_FROZEN_SIMD
 #include "rbtree.h"
 #include "qs.h"
+#include "slab.h"
+#include "btree.h"
 
 #include <stdio.h>
 #include <string.h>
@@ -62,6 +69,144 @@ struct node_s {
 
 #define my_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
 rb_bind_decl_m(my, node_t)
+rb_head_bind_decl_m(mh, my, node_t)
+rb_slab_bind_decl_m(my, node_t)
+#define my_key_m(x) rb_value_m(x)
+#define my_key_cmp_m(x, y) rb_safe_cmp_m(x, y)
+rb_key_bind_decl_m(my, node_t, int)
+rb_frozen_bind_decl_m(my, node_t, int)
+rb_ts_bind_decl_m(my, node_t)
+rb_seq_bind_decl_m(my, node_t)
+
+#define mm_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
+rb_multi_bind_decl_m(mm, node_t)
+
+#define mt_key_m(x) rb_value_m(x)
+#define mt_key_cmp_m(x, y) rb_safe_cmp_m(x, y)
+bt_bind_decl_m(mt, node_t, int)
+
+struct cpnode_s;
+typedef struct cpnode_s cpnode_t;
+struct cpnode_s {
+    int       value;
+    char      color;
+    cpnode_t* left;
+    cpnode_t* right;
+};
+
+#define mc_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
+rb_compact_bind_decl_m(mc, cpnode_t)
+
+struct chnode_s;
+typedef struct chnode_s chnode_t;
+struct chnode_s {
+    int       value;
+    char      color;
+    chnode_t* parent;
+    chnode_t* child[2];
+};
+
+#define mb_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
+rb_child_bind_decl_m(mb, chnode_t)
+
+struct osnode_s;
+typedef struct osnode_s osnode_t;
+struct osnode_s {
+    int       value;
+    char      color;
+    osnode_t* parent;
+    osnode_t* left;
+    osnode_t* right;
+    RB_SIZE_T size;
+};
+
+#define mo_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
+rb_os_bind_decl_m(mo, osnode_t)
+
+struct augnode_s;
+typedef struct augnode_s augnode_t;
+struct augnode_s {
+    int        value;
+    char       color;
+    augnode_t* parent;
+    augnode_t* left;
+    augnode_t* right;
+    int        weight;
+    int        max;
+};
+
+#define ma_cmp_m(x, y) rb_safe_value_cmp_m(x, y)
+#begindef ma_augment_m(x)
+{
+    (x)->max = (x)->weight;
+    if(rb_left_m(x) != ma_nil_ptr && rb_left_m(x)->max > (x)->max)
+        (x)->max = rb_left_m(x)->max;
+    if(rb_right_m(x) != ma_nil_ptr && rb_right_m(x)->max > (x)->max)
+        (x)->max = rb_right_m(x)->max;
+}
+#enddef
+rb_aug_bind_decl_m(ma, augnode_t)
+
+struct ivnode_s;
+typedef struct ivnode_s ivnode_t;
+struct ivnode_s {
+    int       start;
+    int       end;
+    char      color;
+    ivnode_t* parent;
+    ivnode_t* left;
+    ivnode_t* right;
+    int       max;
+};
+
+#begindef mi_cmp_m(x, y)
+    (
+        rb_start_m(x) != rb_start_m(y) ?
+        rb_safe_cmp_m(rb_start_m(x), rb_start_m(y)) :
+        rb_safe_cmp_m(rb_end_m(x), rb_end_m(y))
+    )
+#enddef
+rb_interval_bind_decl_m(mi, ivnode_t)
+
+struct pknode_s;
+typedef struct pknode_s pknode_t;
+struct pknode_s {
+    int       value;
+    uintptr_t parent;
+    pknode_t* left;
+    pknode_t* right;
+};
+
+#define mp_color_m(x) rb_tag_color_m((x)->parent)
+#define mp_color_m_set(x, c) rb_tag_set_color_m((x)->parent, c)
+#define mp_parent_m(x) rb_tag_ptr_m(pknode_t, (x)->parent)
+#define mp_parent_m_set(x, p) rb_tag_set_ptr_m((x)->parent, p)
+#define mp_left_m(x) (x)->left
+#define mp_left_m_set(x, l) rb_lvalue_set_m(mp_left_m, x, l)
+#define mp_right_m(x) (x)->right
+#define mp_right_m_set(x, r) rb_lvalue_set_m(mp_right_m, x, r)
+#define mp_cmp_m(x, y) rb_safe_cmp_m((x)->value, (y)->value)
+rb_tagged_bind_decl_cx_m(mp, pknode_t)
+
+struct ixnode_s;
+typedef struct ixnode_s ixnode_t;
+struct ixnode_s {
+    int      value;
+    uint32_t parent;
+    uint32_t left;
+    uint32_t right;
+};
+
+#define mq_color_m(x) rb_pool_tag_color_m((x)->parent)
+#define mq_color_m_set(x, c) rb_pool_tag_set_color_m((x)->parent, c)
+#define mq_parent_m(x) rb_pool_tag_ptr_m(mq, (x)->parent)
+#define mq_parent_m_set(x, p) rb_pool_tag_set_ptr_m(mq, (x)->parent, p)
+#define mq_left_m(x) rb_pool_ptr_m(mq, (x)->left)
+#define mq_left_m_set(x, l) (x)->left = rb_pool_idx_m(mq, l)
+#define mq_right_m(x) rb_pool_ptr_m(mq, (x)->right)
+#define mq_right_m_set(x, r) (x)->right = rb_pool_idx_m(mq, r)
+#define mq_cmp_m(x, y) rb_safe_cmp_m((x)->value, (y)->value)
+rb_pool_bind_decl_cx_m(mq, ixnode_t)
 
 struct item_s;
 typedef struct item_s item_t;